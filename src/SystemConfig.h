@@ -13,6 +13,7 @@
 #define CONFIG_MIDI_IRQ_PRIORITY        (3<<4)
 #define CONFIG_LCD_IRQ_PRIORITY         (4<<4)
 #define CONFIG_CONSOLE_IRQ_PRIORITY     (5<<4)
+#define CONFIG_SR_IRQ_PRIORITY          (6<<4)
 
 // printf
 #define CONFIG_PRINTF_BUFFER            16
@@ -35,6 +36,7 @@
 
 // Shift registers
 #define CONFIG_NUM_SR                   3
+#define CONFIG_SR_SCAN_RATE             8000    // transfers per second, the button led matrix scans one row per transfer
 
 // Button Led Matrix
 #define CONFIG_BLM_ROWS                 8
@@ -45,6 +47,7 @@
 
 // ADC
 #define CONFIG_ADC_CHANNELS             4
+#define CONFIG_ADC_OVERSAMPLE           16      // scans averaged per reading
 
 // DAC
 #define CONFIG_DAC_CHANNELS             8
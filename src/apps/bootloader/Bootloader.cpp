@@ -183,7 +183,8 @@ static void bootloader() {
 
         MD5 md5;
 
-        uint32_t buf[1024 / 4];
+        // large chunks let the sd card driver read multiple blocks at once
+        static uint32_t buf[4096 / 4];
         size_t bytesLeft = updateSize;
         while (bytesLeft > 0) {
             int progress = ((updateSize - bytesLeft) * 100) / updateSize;
@@ -245,7 +246,8 @@ static void bootloader() {
         flash_unlock();
 
         uint32_t addr = CONFIG_APPLICATION_ADDR;
-        uint32_t buf[1024 / 4];
+        // large chunks let the sd card driver read multiple blocks at once
+        static uint32_t buf[4096 / 4];
         size_t bytesLeft = updateSize;
 
         while (bytesLeft > 0) {
@@ -59,14 +59,8 @@ bool SdCard::available() {
 
 bool SdCard::read(uint8_t *buf, uint32_t sector, uint8_t count) {
     // DBG("read(sector=%d,count=%d)", sector, count);
-    uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!readBlock(sector + i, data)) {
-            return false;
-        }
-        data += 512;
-    }
-    return true;
+    // contiguous sectors are read with a single multi block command
+    return count == 0 || readBlocks(sector, buf, count);
 }
 
 bool SdCard::cardDetect() {
@@ -295,9 +289,9 @@ bool SdCard::waitDataReady() {
     return false;
 }
 
-bool SdCard::readBlock(uint32_t address, void *buffer) {
+bool SdCard::readBlocks(uint32_t address, void *buffer, uint32_t count) {
     ASSERT(buffer >= (void *)0x20000000, "buffer not in SRAM");
-    // DBG("readBlock(address=%lu, buffer=%p)", address, buffer);
+    // DBG("readBlocks(address=%lu, buffer=%p, count=%lu)", address, buffer, count);
     if (!waitDataReady()) {
         return false;
     }
@@ -341,11 +335,13 @@ bool SdCard::readBlock(uint32_t address, void *buffer) {
     SDIO_DTIMER = 2400000;
 
     // These two registers must be set before SDIO_DCTRL.
-    SDIO_DLEN = 512;
+    SDIO_DLEN = count * 512;
     SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN |
                  SDIO_DCTRL_DTDIR | SDIO_DCTRL_DTEN;
 
-    if (sendCommandWait(17, address) != Success) {
+    // READ_SINGLE_BLOCK (CMD17) or READ_MULTIPLE_BLOCK (CMD18)
+    bool multiBlock = count > 1;
+    if (sendCommandWait(multiBlock ? 18 : 17, address) != Success) {
         return false;
     }
 
@@ -353,29 +349,36 @@ bool SdCard::readBlock(uint32_t address, void *buffer) {
                                           SDIO_STA_RXOVERR |
                                           SDIO_STA_DTIMEOUT |
                                           SDIO_STA_DCRCFAIL);
-    const uint32_t DATA_RX_SUCCESS_FLAGS = (SDIO_STA_DBCKEND |
-                                            SDIO_STA_DATAEND);
-
-    while (!dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
-        // TODO maybe we'd better use interrupts
-        // os::this_task::yield();
-    }
+    // DBCKEND is set after every block, only DATAEND marks the end of a multi block transfer
+    const uint32_t DATA_RX_SUCCESS_FLAGS = SDIO_STA_DATAEND;
 
+    // the data timer of the sdio bounds the wait, a stalled transfer ends with DTIMEOUT
+    bool success = true;
     while (true) {
         volatile uint32_t result = SDIO_STA;
         // DBG("STA = 0x%x", result);
         // DBG("FIFOCNT = %d", SDIO_FIFOCNT);
-        if (result & (DATA_RX_SUCCESS_FLAGS | DATA_RX_ERROR_FLAGS)) {
-            if (result & DATA_RX_ERROR_FLAGS) {
-                return false;
-            } else if (result & DATA_RX_SUCCESS_FLAGS) {
-                break;
-            }
+        if (result & DATA_RX_ERROR_FLAGS) {
+            success = false;
+            break;
+        }
+        if ((result & DATA_RX_SUCCESS_FLAGS) && dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
+            break;
         }
 
         // TODO maybe we'd better use interrupts
         // os::this_task::yield();
     }
 
-    return true;
+    if (!success) {
+        SDIO_DCTRL = 0;
+        dma_disable_stream(DMA2, DMA_STREAM3);
+    }
+
+    // STOP_TRANSMISSION (CMD12), also ends a multi block read that failed half way
+    if ((multiBlock || !success) && sendCommandWait(12, 0) != Success) {
+        return false;
+    }
+
+    return success;
 }
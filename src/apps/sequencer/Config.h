@@ -28,6 +28,13 @@
 // Settings flash storage
 #define CONFIG_SETTINGS_FLASH_SECTOR    3
 #define CONFIG_SETTINGS_FLASH_ADDR      0x0800C000
+#define CONFIG_SETTINGS_FLASH_SECTOR_SIZE (16 * 1024)
+
+// Pattern bank flash storage (sectors 8-11, firmware is limited to 448K by the linker script)
+#define CONFIG_PATTERN_FLASH_SECTOR     8
+#define CONFIG_PATTERN_FLASH_SECTORS    4
+#define CONFIG_PATTERN_FLASH_ADDR       0x08080000
+#define CONFIG_PATTERN_FLASH_SECTOR_SIZE (128 * 1024)
 
 // Parts per quarter note
 #define CONFIG_PPQN                     192
@@ -50,16 +57,21 @@
 // Model
 #define CONFIG_PATTERN_COUNT            8   // Back to original - 10 worked but user requested 8
 #define CONFIG_SNAPSHOT_COUNT           1
-#define CONFIG_SONG_SLOT_COUNT          4   // Reduced from 16 (not used)
+#define CONFIG_PATTERN_BANK_COUNT       64  // Patterns per track paged in from flash
+#define CONFIG_PATTERN_PAGER_ENTRIES    8   // Paged in bank patterns kept in RAM
+#define CONFIG_SONG_SLOT_COUNT          16
 #define CONFIG_TRACK_COUNT              16
 #define CONFIG_STEP_COUNT               64
-#define CONFIG_ROUTE_COUNT              4   // Reduced from 16 (rarely used)
+#define CONFIG_ROUTE_COUNT              16
 #define CONFIG_MIDI_OUTPUT_COUNT        16
-#define CONFIG_USER_SCALE_COUNT         1   // Reduced from 4 (not used)
-#define CONFIG_USER_SCALE_SIZE          8   // Reduced from 32 (not used)
+#define CONFIG_USER_SCALE_COUNT         4
+#define CONFIG_USER_SCALE_SIZE          32
 #define CONFIG_MODULATOR_COUNT          8   // Independent LFO/Random modulators
-#define CONFIG_ENABLE_CURVE_TRACKS      0   // Disabled - removed for memory
-#define CONFIG_ENABLE_MIDICV_TRACKS     0   // Disabled - removed for memory
+#define CONFIG_ENABLE_CURVE_TRACKS      1
+#define CONFIG_ENABLE_MIDICV_TRACKS     1
+
+// Output scheduler
+#define CONFIG_ENABLE_OUTPUT_SCHEDULER  1   // Commit gate/cv edges from the clock timer interrupt
 
 
 #define CONFIG_ENABLE_ASTEROIDS
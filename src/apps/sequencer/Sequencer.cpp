@@ -67,7 +67,7 @@ static Adc adc;
 static CCMRAM_BSS Dac dac(getDacType());
 static CCMRAM_BSS Dio dio;
 static CCMRAM_BSS GateOutput gateOutput(shiftRegister);
-static CCMRAM_BSS Midi midi;
+static Midi midi; // uses DMA, must not be placed in CCMRAM
 static CCMRAM_BSS UsbMidi usbMidi;
 static UsbH usbh(usbMidi);
 static SdCard sdCard;
@@ -97,14 +97,19 @@ static void taskAlive(uint32_t task) {
 }
 
 static CCMRAM_BSS os::PeriodicTask<CONFIG_DRIVER_TASK_STACK_SIZE> driverTask("driver", CONFIG_DRIVER_TASK_PRIORITY, os::time::ms(1), [] () {
-    shiftRegister.process();
-    blm.process();
+    // shift registers and button led matrix are scanned from interrupts (see main)
     encoder.process();
     taskAlive(0);
 });
 
+// wall time including preemption, engine updates exceeding the 1 ms task period are counted as overruns
+PROFILER_INTERVAL_BUDGET(EngineTask, "Engine.update", 1000)
+PROFILER_INTERVAL(UiTask, "Ui.update")
+
 static CCMRAM_BSS os::PeriodicTask<CONFIG_ENGINE_TASK_STACK_SIZE> engineTask("engine", CONFIG_ENGINE_TASK_PRIORITY, os::time::ms(1), [] () {
+    PROFILER_INTERVAL_BEGIN(EngineTask);
     engine.update();
+    PROFILER_INTERVAL_END(EngineTask);
     taskAlive(1);
 });
 
@@ -114,22 +119,35 @@ static CCMRAM_BSS os::PeriodicTask<CONFIG_USBH_TASK_STACK_SIZE> usbhTask("usbh",
 });
 
 static CCMRAM_BSS os::PeriodicTask<CONFIG_UI_TASK_STACK_SIZE> uiTask("ui", CONFIG_UI_TASK_PRIORITY, os::time::ms(1), [] () {
+    PROFILER_INTERVAL_BEGIN(UiTask);
     ui.update();
+    PROFILER_INTERVAL_END(UiTask);
     taskAlive(3);
 });
 
 static os::PeriodicTask<CONFIG_FILE_TASK_STACK_SIZE> fsTask("file", CONFIG_FILE_TASK_PRIORITY, os::time::ms(10), [] () {
     FileManager::processTask();
+    FileManager::autosave(model.project(), model.settings().userSettings().get<UserSetting::Autosave>());
+    // page in bank patterns
+    model.patternPager().update(model.project().playState());
     // no task alive handling because processTask() can take a long time to complete
 });
 
 #if CONFIG_ENABLE_PROFILER || CONFIG_ENABLE_TASK_PROFILER
-static CCMRAM_BSS os::PeriodicTask<CONFIG_PROFILER_TASK_STACK_SIZE> profilerTask("profiler", 0, os::time::ms(5000), [] () {
+// task loads are updated every second for the monitor page, everything is dumped to the console every 5 seconds
+static CCMRAM_BSS os::PeriodicTask<CONFIG_PROFILER_TASK_STACK_SIZE> profilerTask("profiler", 0, os::time::ms(1000), [] () {
+    static int count;
+    bool dump = ++count % 5 == 0;
 #if CONFIG_ENABLE_PROFILER
-    profiler.dump();
+    if (dump) {
+        profiler.dump();
+    }
 #endif // CONFIG_ENABLE_PROFILE
 #if CONFIG_ENABLE_TASK_PROFILER
-    os::TaskProfiler::dump();
+    os::TaskProfiler::update();
+    if (dump) {
+        os::TaskProfiler::dump();
+    }
 #endif // CONFIG_ENABLE_TASK_PROFILER
 });
 #endif // CONFIG_ENABLE_PROFILER || CONFIG_ENABLE_TASK_PROFILER
@@ -181,6 +199,11 @@ int main(void) {
     engine.init();
     ui.init();
 
+    // shift register transfers scan one row of the button led matrix and pick up the gate outputs
+    shiftRegister.startScan(CONFIG_SR_SCAN_RATE, [] () {
+        blm.process();
+    });
+
     System::resetWatchdog();
 
 	os::startScheduler();
@@ -65,6 +65,8 @@ struct SequencerApp {
 
     void update() {
         engine.update();
+        model.patternPager().update(model.project().playState());
+        FileManager::autosave(model.project(), model.settings().userSettings().get<UserSetting::Autosave>());
         ui.update();
     }
 };
@@ -12,6 +12,10 @@
 
 static Random rng;
 
+void ArpeggiatorEngine::seedRandom(uint32_t seed) {
+    rng.seed(seed);
+}
+
 ArpeggiatorEngine::ArpeggiatorEngine(const Arpeggiator &arpeggiator) :
     _arpeggiator(arpeggiator)
 {
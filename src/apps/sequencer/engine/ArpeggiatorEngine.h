@@ -22,6 +22,9 @@ public:
 
     ArpeggiatorEngine(const Arpeggiator &arpeggiator);
 
+    // reseeds the random generator shared by all arpeggiators
+    static void seedRandom(uint32_t seed);
+
     void reset();
 
     void noteOn(int note);
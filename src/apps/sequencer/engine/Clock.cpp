@@ -302,7 +302,7 @@ bool Clock::checkTick(uint32_t *tick) {
     if (_requestedEvents) {
         return false;
     }
-    if (_tickProcessed < _tick) {
+    if (_tickProcessed < _tick + activeTickLookahead()) {
         *tick = _tickProcessed++;
         return true;
     }
@@ -405,6 +405,10 @@ void Clock::outputMidiMessage(uint8_t msg) {
 }
 
 void Clock::outputTick(uint32_t tick) {
+    if (_listener) {
+        _listener->onClockTick(tick);
+    }
+
     outputReset(false);
 
     if (tick % (_ppqn / 24) == 0) {
@@ -35,6 +35,7 @@ public:
     struct Listener {
         virtual void onClockOutput(const OutputState &state) = 0;
         virtual void onClockMidi(uint8_t) = 0;
+        virtual void onClockTick(uint32_t tick) = 0;
     };
 
     Clock(ClockTimer &timer);
@@ -83,6 +84,13 @@ public:
     Event checkEvent();
     bool checkTick(uint32_t *tick);
 
+    // number of ticks the sequencer is allowed to process ahead of the clock while the master clock is running
+    uint32_t tickLookahead() const { return _tickLookahead; }
+    void setTickLookahead(uint32_t lookahead) { _tickLookahead = lookahead; }
+    // lookahead in the current state, only the master clock knows when the next tick happens,
+    // a slave clock can stop or reset before it
+    uint32_t activeTickLookahead() const { return _state == State::MasterRunning ? _tickLookahead : 0; }
+
 private:
     enum class State {
         Idle,
@@ -148,6 +156,7 @@ private:
 
     volatile uint32_t _tick;
     volatile uint32_t _tickProcessed;
+    uint32_t _tickLookahead = 0;
 
     volatile int32_t _activeSlave = -1;
 
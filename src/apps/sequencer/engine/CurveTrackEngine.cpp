@@ -2,7 +2,6 @@
 
 #include "Engine.h"
 #include "Groove.h"
-#include "Slide.h"
 #include "SequenceUtils.h"
 
 #include "core/Debug.h"
@@ -14,15 +13,16 @@
 
 static Random rng;
 
-static float evalStepShape(const CurveSequence::Step &step, bool variation, bool invert, float fraction) {
-    auto function = Curve::function(Curve::Type(variation ? step.shapeVariation() : step.shape()));
-    float value = function(fraction);
-    if (invert) {
-        value = 1.f - value;
+void CurveTrackEngine::seedRandom(uint32_t seed) {
+    rng.seed(seed);
+}
+
+static float evalSegment(const CurveTrackEngine::Segment &segment, float fraction) {
+    uint32_t value = Curve::evalFixed(segment.shape, uint32_t(fraction * Curve::FixedOne));
+    if (segment.invert) {
+        value = Curve::FixedMax - value;
     }
-    float min = float(step.min()) / CurveSequence::Min::Max;
-    float max = float(step.max()) / CurveSequence::Max::Max;
-    return min + value * (max - min);
+    return segment.min + value * (1.f / Curve::FixedMax) * (segment.max - segment.min);
 }
 
 static bool evalShapeVariation(const CurveSequence::Step &step, int probabilityBias) {
@@ -39,6 +39,7 @@ void CurveTrackEngine::reset() {
     _sequenceState.reset();
     _currentStep = -1;
     _currentStepFraction = 0.f;
+    _segment.active = false;
     _shapeVariation = false;
     _fillMode = CurveTrack::FillMode::None;
     _activity = false;
@@ -54,6 +55,7 @@ void CurveTrackEngine::restart() {
     _sequenceState.reset();
     _currentStep = -1;
     _currentStepFraction = 0.f;
+    _segment.active = false;
 }
 
 TrackEngine::TickResult CurveTrackEngine::tick(uint32_t tick) {
@@ -141,20 +143,35 @@ void CurveTrackEngine::update(float dt) {
     } else if (recording) {
         updateRecordValue();
         _cvOutput = _cvOutputTarget = range.denormalize(_recordValue);
+    } else if (running && _segment.active) {
+        // advance the curve between clock ticks, but never past the next tick
+        float progress = std::min(_tickTime / _engine.clock().tickDuration(), 1.f);
+        _currentStepFraction = std::min(_tickFraction + progress * _fractionPerTick, 1.f);
+        _cvOutputTarget = range.denormalize(evalSegment(_segment, _currentStepFraction));
+        _tickTime += dt;
     }
 
     float offset = mute() ? 0.f : _curveTrack.offsetVolts();
 
     if (_curveTrack.slideTime() > 0) {
-        _cvOutput = Slide::applySlide(_cvOutput, _cvOutputTarget + offset, _curveTrack.slideTime(), dt);
+        // the curve moves the target continuously, constant time slides have no distance to cover
+        auto slideMode = _model.project().slideMode();
+        if (slideMode == Types::SlideMode::ConstantTime) {
+            slideMode = Types::SlideMode::Linear;
+        }
+        _cvOutput = _slide.apply(_cvOutput, _cvOutputTarget + offset, _curveTrack.slideTime(), slideMode, dt);
     } else {
         _cvOutput = _cvOutputTarget + offset;
+        _slide.reset();
     }
 }
 
 void CurveTrackEngine::changePattern() {
-    _sequence = &_curveTrack.sequence(pattern());
-    _fillSequence = &_curveTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
+    // bank patterns only hold note sequences
+    int pattern = PlayState::isBankPattern(this->pattern()) ? 0 : this->pattern();
+
+    _sequence = &_curveTrack.sequence(pattern);
+    _fillSequence = &_curveTrack.sequence(std::min(pattern + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
 void CurveTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
@@ -192,8 +209,13 @@ void CurveTrackEngine::updateOutput(uint32_t relativeTick, uint32_t divisor) {
     const auto &range = Types::voltageRangeInfo(sequence.range());
 
     _currentStepFraction = float(relativeTick % divisor) / divisor;
+    _tickFraction = _currentStepFraction;
+    _fractionPerTick = 1.f / divisor;
+    _tickTime = 0.f;
 
     if (mute()) {
+        _segment.active = false;
+
         switch (_curveTrack.muteMode()) {
         case CurveTrack::MuteMode::LastValue:
             // keep value
@@ -218,9 +240,13 @@ void CurveTrackEngine::updateOutput(uint32_t relativeTick, uint32_t divisor) {
         const auto &evalSequence = fillNextPattern ? *_fillSequence : *_sequence;
         const auto &step = evalSequence.step(_currentStep);
 
-        float value = evalStepShape(step, _shapeVariation || fillVariation, fillInvert, _currentStepFraction);
-        value = range.denormalize(value);
-        _cvOutputTarget = value;
+        _segment.active = true;
+        _segment.shape = Curve::Type(_shapeVariation || fillVariation ? step.shapeVariation() : step.shape());
+        _segment.invert = fillInvert;
+        _segment.min = float(step.min()) / CurveSequence::Min::Max;
+        _segment.max = float(step.max()) / CurveSequence::Max::Max;
+
+        _cvOutputTarget = range.denormalize(evalSegment(_segment, _currentStepFraction));
     }
 
     _engine.midiOutputEngine().sendCv(_track.trackIndex(), _cvOutputTarget);
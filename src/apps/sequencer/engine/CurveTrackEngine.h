@@ -4,7 +4,9 @@
 #include "SequenceState.h"
 #include "SortedQueue.h"
 #include "CurveRecorder.h"
+#include "Slide.h"
 
+#include "model/Curve.h"
 #include "model/Track.h"
 
 class CurveTrackEngine : public TrackEngine {
@@ -16,6 +18,9 @@ public:
         reset();
     }
 
+    // reseeds the random generator shared by all CurveTrackEngines
+    static void seedRandom(uint32_t seed);
+
     virtual Track::TrackMode trackMode() const override { return Track::TrackMode::Curve; }
 
     virtual void reset() override;
@@ -42,6 +47,15 @@ public:
 
     enum class MonitorLevel { Min, Max };
 
+    // shape of the current step, evaluated on every engine update so the curve advances between clock ticks
+    struct Segment {
+        bool active = false;
+        Curve::Type shape;
+        bool invert;
+        float min;
+        float max;
+    };
+
     void setMonitorStep(int index) { _monitorStepIndex = (index >= 0 && index < CONFIG_STEP_COUNT) ? index : -1; }
     void setMonitorStepLevel(MonitorLevel level) { _monitorStepLevel = level; }
 
@@ -68,6 +82,10 @@ private:
     SequenceState _sequenceState;
     int _currentStep;
     float _currentStepFraction;
+    Segment _segment;
+    float _tickFraction = 0.f;
+    float _fractionPerTick = 0.f;
+    float _tickTime = 0.f;
     bool _shapeVariation;
     CurveTrack::FillMode _fillMode;
 
@@ -75,6 +93,7 @@ private:
     bool _gateOutput;
     float _cvOutput = 0.f;
     float _cvOutputTarget = 0.f;
+    Slide _slide;
 
     struct Gate {
         uint32_t tick;
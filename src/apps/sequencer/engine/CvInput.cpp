@@ -1,16 +1,41 @@
 #include "CvInput.h"
 
+#include "core/math/Math.h"
+
 CvInput::CvInput(Adc &adc) :
     _adc(adc)
 {
+    for (auto &settings : _settings) {
+        settings.hysteresis = DefaultHysteresis;
+        settings.slewRate = 0.f;
+    }
 }
 
 void CvInput::init() {
-    _channels.fill(0.f);
+    for (int i = 0; i < Channels; ++i) {
+        _targets[i] = 5.f - _adc.channel(i) / 6553.5f;
+    }
+    _channels = _targets;
 }
 
-void CvInput::update() {
+void CvInput::update(float dt) {
     for (int i = 0; i < Channels; ++i) {
-        _channels[i] = 5.f - _adc.channel(i) / 6553.5f;
+        const auto &settings = _settings[i];
+
+        // only follow the input once it moved further than the hysteresis
+        float value = 5.f - _adc.channel(i) / 6553.5f;
+        float &target = _targets[i];
+        if (value > target + settings.hysteresis) {
+            target = value - settings.hysteresis;
+        } else if (value < target - settings.hysteresis) {
+            target = value + settings.hysteresis;
+        }
+
+        if (settings.slewRate > 0.f) {
+            float maxDelta = settings.slewRate * dt;
+            _channels[i] = clamp(target, _channels[i] - maxDelta, _channels[i] + maxDelta);
+        } else {
+            _channels[i] = target;
+        }
     }
 }
@@ -6,22 +6,44 @@
 
 #include <array>
 
+// Converts the (oversampled) ADC readings to voltages.
+// Each channel can apply hysteresis to suppress noise on static inputs and a slew limit to smooth jumps.
 class CvInput {
 public:
     static constexpr int Channels = CONFIG_CV_INPUT_CHANNELS;
 
+    // about one ADC step (10V range, 12 bit)
+    static constexpr float DefaultHysteresis = 0.0025f;
+
     CvInput(Adc &adc);
 
     void init();
 
-    void update();
+    void update(float dt);
 
     float channel(int index) const {
         return _channels[index];
     }
 
+    // minimum change in volts before the channel follows the input
+    void setHysteresis(int index, float hysteresis) {
+        _settings[index].hysteresis = hysteresis;
+    }
+
+    // maximum rate of change in volts per second, 0 disables slew limiting
+    void setSlewRate(int index, float slewRate) {
+        _settings[index].slewRate = slewRate;
+    }
+
 private:
+    struct Settings {
+        float hysteresis;
+        float slewRate;
+    };
+
     Adc &_adc;
 
+    std::array<Settings, Channels> _settings;
+    std::array<float, Channels> _targets;
     std::array<float, Channels> _channels;
 };
@@ -2,6 +2,8 @@
 
 #include "core/math/Math.h"
 
+#include "os/os.h"
+
 CvOutput::CvOutput(Dac &dac, const Calibration &calibration) :
     _dac(dac),
     _calibration(calibration)
@@ -12,8 +14,24 @@ void CvOutput::init() {
 }
 
 void CvOutput::update() {
+    std::array<Dac::Value, Channels> values;
+    for (int i = 0; i < Channels; ++i) {
+        values[i] = _calibration.cvOutput(i).voltsToValue(_channels[i]);
+    }
+
+    // commit() writes scheduled outputs from the clock timer interrupt
+    os::InterruptLock lock;
+    for (int i = 0; i < Channels; ++i) {
+        _dac.setValue(i, values[i]);
+    }
+    _dac.write();
+}
+
+void CvOutput::commit(uint8_t mask) {
     for (int i = 0; i < Channels; ++i) {
-        _dac.setValue(i, _calibration.cvOutput(i).voltsToValue(_channels[i]));
+        if (mask & (1 << i)) {
+            _dac.setValue(i, _calibration.cvOutput(i).voltsToValue(_channels[i]));
+        }
     }
     _dac.write();
 }
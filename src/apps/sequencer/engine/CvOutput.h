@@ -18,6 +18,9 @@ public:
 
     void update();
 
+    // write a set of channels to the dac immediately (interrupt safe)
+    void commit(uint8_t mask);
+
     float channel(int index) const {
         return _channels[index];
     }
@@ -4,10 +4,13 @@
 #include "MidiUtils.h"
 
 #include "core/Debug.h"
+#include "core/profiler/Profiler.h"
 #include "core/midi/MidiMessage.h"
 
 #include "os/os.h"
 
+PROFILER_INTERVAL(TickOutputs, "Engine.tickOutputs")
+
 Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi) :
     _model(model),
     _project(model.project()),
@@ -17,9 +20,11 @@ Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &di
     _usbMidi(usbMidi),
     _cvInput(adc),
     _cvOutput(dac, model.settings().calibration()),
+    _outputScheduler(gateOutput, _cvOutput),
     _clock(clockTimer),
     _midiOutputEngine(*this, model),
-    _routingEngine(*this, model)
+    _routingEngine(*this, model),
+    _sysExTransfer(model.project(), midi, usbMidi)
 {
     _cvOutputOverrideValues.fill(0.f);
     _trackEngines.fill(nullptr);
@@ -34,6 +39,10 @@ void Engine::init() {
     _cvInput.init();
     _cvOutput.init();
     _clock.init();
+#if CONFIG_ENABLE_OUTPUT_SCHEDULER
+    // process ticks one tick ahead of the master clock and commit outputs from the clock timer interrupt
+    _clock.setTickLookahead(1);
+#endif
 
     initClock();
     updateClockSetup();
@@ -45,10 +54,21 @@ void Engine::init() {
     _lastSystemTicks = os::ticks();
 }
 
+void Engine::seedRandom(uint32_t seed) {
+    NoteTrackEngine::seedRandom(seed);
+#if CONFIG_ENABLE_CURVE_TRACKS
+    CurveTrackEngine::seedRandom(seed);
+#endif
+#if CONFIG_ENABLE_MIDICV_TRACKS
+    ArpeggiatorEngine::seedRandom(seed);
+#endif
+}
+
 void Engine::update() {
     // locking
-    _locked = _requestLock;
-    if (_locked) {
+    uint32_t locked = _requestLock.load(std::memory_order_acquire);
+    _locked.store(locked, std::memory_order_release);
+    if (locked) {
         return;
     }
 
@@ -57,14 +77,15 @@ void Engine::update() {
     _lastSystemTicks = systemTicks;
 
     // suspending
-    if (_requestSuspend != _suspended) {
-        if (_requestSuspend) {
+    uint32_t suspended = _requestSuspend.load(std::memory_order_acquire);
+    if (suspended != _suspended.load(std::memory_order_relaxed)) {
+        if (suspended) {
             _clock.masterStop();
         }
-        _suspended = _requestSuspend;
+        _suspended.store(suspended, std::memory_order_release);
     }
 
-    if (_suspended) {
+    if (suspended) {
         // consume ticks
         uint32_t tick;
         while (_clock.checkTick(&tick)) {}
@@ -75,7 +96,8 @@ void Engine::update() {
         while (_midi.recv(&message)) {}
         while (_usbMidi.recv(&cable, &message)) {}
 
-        _cvInput.update();
+        _outputScheduler.reset();
+        _cvInput.update(dt);
         updateOverrides();
         _cvOutput.update();
         _gateOutput.update();
@@ -84,6 +106,9 @@ void Engine::update() {
 
     // process clock events
     while (Clock::Event event = _clock.checkEvent()) {
+        // drop outputs scheduled for ticks that will no longer happen
+        _outputScheduler.reset();
+
         switch (event) {
         case Clock::Start:
             // DBG("START");
@@ -110,6 +135,9 @@ void Engine::update() {
     _nudgeTempo.update(dt);
     _clock.setMasterBpm(_project.tempo() * (1.f + _nudgeTempo.strength() * 0.1f));
 
+    // apply records loaded through sysex before picking up setup changes, continue dumps
+    _sysExTransfer.update();
+
     // update clock setup
     updateClockSetup();
 
@@ -120,7 +148,10 @@ void Engine::update() {
     updatePlayState(false);
 
     // update cv inputs
-    _cvInput.update();
+    _cvInput.update(dt);
+
+    // pick up midi output config changes before sending to MIDI outputs
+    _midiOutputEngine.updateRouting();
 
     // send CV inputs to MIDI CC
     for (int cvInIndex = 0; cvInIndex < CONFIG_CV_INPUT_CHANNELS; ++cvInIndex) {
@@ -137,20 +168,43 @@ void Engine::update() {
     while (_clock.checkTick(&tick)) {
         _tick = tick;
 
+        // send notes held from the previous tick before requests of this tick are merged with them
+        _midiOutputEngine.update();
+        _midiOutputEngine.beginTick(tick);
+
         // update play state
         updatePlayState(true);
 
         // tick track engines
+        uint32_t cvUpdateTracks = 0;
+        uint32_t dirtyTracks = 0;
         for (size_t trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
             auto &trackEngine = _trackEngines[trackIndex];
             uint32_t result = trackEngine->tick(tick);
-            // update track outputs and routings if tick results in updating the track's CV output
-            if (result &= TrackEngine::TickResult::CvUpdate && _trackUpdateReducers[trackIndex].update()) {
+            bool cvUpdate = result & TrackEngine::TickResult::CvUpdate;
+            if (cvUpdate) {
+                cvUpdateTracks |= (1 << trackIndex);
+            }
+            // collect tracks that need their outputs refreshed if tick results in updating the track's CV output
+            if (cvUpdate && _trackUpdateReducers[trackIndex].update()) {
+                trackEngine->update(0.f);
+                dirtyTracks |= (1 << trackIndex);
+            }
+#if CONFIG_ENABLE_OUTPUT_SCHEDULER
+            else if (cvUpdate) {
+                // refresh track cv so it is part of the scheduled outputs
                 trackEngine->update(0.f);
-                updateTrackOutputs();
-                updateOverrides();
-                _routingEngine.update();
             }
+#endif
+        }
+
+        // update outputs of dirty tracks and routings in a single pass
+        if (dirtyTracks) {
+            PROFILER_INTERVAL_BEGIN(TickOutputs);
+            updateTrackOutputs(dirtyTracks);
+            updateOverrides();
+            _routingEngine.update();
+            PROFILER_INTERVAL_END(TickOutputs);
         }
 
         // tick modulators
@@ -167,7 +221,23 @@ void Engine::update() {
         if (tick == 0) {
             _midiOutputEngine.update(true);
         }
+
+        _midiOutputEngine.endTick();
+
+#if CONFIG_ENABLE_OUTPUT_SCHEDULER
+        scheduleTrackOutputs(tick, cvUpdateTracks);
+#endif
+    }
+
+#if CONFIG_ENABLE_OUTPUT_SCHEDULER
+    // commit outputs of ticks that have already passed (engine fell behind the clock)
+    {
+        os::InterruptLock lock;
+        if (_clock.tick() > 0) {
+            _outputScheduler.commit(_clock.tick() - 1);
+        }
     }
+#endif
 
     for (auto trackEngine : _trackEngines) {
         trackEngine->update(dt);
@@ -180,42 +250,55 @@ void Engine::update() {
 
     // update cv/gate outputs
     _cvOutput.update();
-    _gateOutput.update();
+    {
+        // gates may be committed concurrently from the clock timer interrupt
+        os::InterruptLock lock;
+        _gateOutput.update();
+    }
 }
 
+// requests are acknowledged by the engine task on its next update, the calling task sleeps until then
 void Engine::lock() {
+    _requestLock.store(1, std::memory_order_release);
     while (!isLocked()) {
-        _requestLock = 1;
 #ifdef PLATFORM_SIM
         update();
+#else
+        os::delay(1);
 #endif
     }
 }
 
 void Engine::unlock() {
+    _requestLock.store(0, std::memory_order_release);
     while (isLocked()) {
-        _requestLock = 0;
 #ifdef PLATFORM_SIM
         update();
+#else
+        os::delay(1);
 #endif
     }
 }
 
 void Engine::suspend() {
     // TODO make re-entrant
+    _requestSuspend.store(1, std::memory_order_release);
     while (!isSuspended()) {
-        _requestSuspend = 1;
 #ifdef PLATFORM_SIM
         update();
+#else
+        os::delay(1);
 #endif
     }
 }
 
 void Engine::resume() {
+    _requestSuspend.store(0, std::memory_order_release);
     while (isSuspended()) {
-        _requestSuspend = 0;
 #ifdef PLATFORM_SIM
         update();
+#else
+        os::delay(1);
 #endif
     }
 }
@@ -357,6 +440,19 @@ bool Engine::sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message)
     return false;
 }
 
+bool Engine::sendSysEx(MidiPort port, uint8_t cable, const uint8_t *data, size_t length) {
+    switch (port) {
+    case MidiPort::Midi:
+        return _midi.sendSysEx(data, length);
+    case MidiPort::UsbMidi:
+        return _usbMidi.sendSysEx(cable, data, length);
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    return false;
+}
+
 bool Engine::midiProgramChangesEnabled() {
     return _project.midiIntegrationProgramChangesEnabled()
         && trackPatternsConsistent()
@@ -398,7 +494,10 @@ Engine::Stats Engine::stats() const {
     return {
         .uptime = os::ticks() / os::time::ms(1000),
         .midiRxOverflow = _midi.rxOverflow(),
-        .usbMidiRxOverflow = _usbMidi.rxOverflow()
+        .midiTxOverflow = _midi.txOverflow(),
+        .usbMidiRxOverflow = _usbMidi.rxOverflow(),
+        .usbMidiTxOverflow = _usbMidi.txOverflow(),
+        .uiMidiOverflow = _uiMidiOverflow
     };
 }
 
@@ -417,10 +516,9 @@ void Engine::onClockOutput(const Clock::OutputState &state) {
 }
 
 void Engine::onClockMidi(uint8_t data) {
-    // TODO we should send a single byte with priority
     const auto &clockSetup = _project.clockSetup();
     if (clockSetup.midiTx()) {
-        _midi.send(MidiMessage(data));
+        _midi.sendRealTime(data);
     }
     if (clockSetup.usbTx()) {
         // always send clock on cable 0
@@ -428,6 +526,11 @@ void Engine::onClockMidi(uint8_t data) {
     }
 }
 
+void Engine::onClockTick(uint32_t tick) {
+    // interrupt context
+    _outputScheduler.commit(tick);
+}
+
 void Engine::updateTrackSetups() {
     for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
         auto &track = _project.track(trackIndex);
@@ -462,7 +565,24 @@ void Engine::updateTrackSetups() {
     }
 }
 
-void Engine::updateTrackOutputs() {
+void Engine::trackOutputChannels(uint32_t tracks, uint8_t &gateMask, uint8_t &cvMask) const {
+    const auto &gateOutputTracks = _project.gateOutputTracks();
+    const auto &cvOutputTracks = _project.cvOutputTracks();
+
+    gateMask = 0;
+    cvMask = 0;
+
+    for (int channelIndex = 0; channelIndex < CONFIG_CHANNEL_COUNT; ++channelIndex) {
+        if (tracks & (1 << gateOutputTracks[channelIndex])) {
+            gateMask |= (1 << channelIndex);
+        }
+        if (tracks & (1 << cvOutputTracks[channelIndex])) {
+            cvMask |= (1 << channelIndex);
+        }
+    }
+}
+
+void Engine::evalTrackOutputs(uint8_t &gates, OutputScheduler::CvArray &cv, uint8_t gateMask, uint8_t cvMask) const {
     const auto &gateOutputTracks = _project.gateOutputTracks();
     const auto &cvOutputTracks = _project.cvOutputTracks();
 
@@ -474,30 +594,82 @@ void Engine::updateTrackOutputs() {
         trackCvIndex[trackIndex] = 0;
     }
 
+    gates = 0;
+
+    // channels outside of the masks are left untouched, the per track output index is still advanced
     for (int channelIndex = 0; channelIndex < CONFIG_CHANNEL_COUNT; ++channelIndex) {
         int gateOutputTrack = gateOutputTracks[channelIndex];
-        if (!_gateOutputOverride) {
-            _gateOutput.setGate(channelIndex, _trackEngines[gateOutputTrack]->gateOutput(trackGateIndex[gateOutputTrack]++));
+        int gateIndex = trackGateIndex[gateOutputTrack]++;
+        if ((gateMask & (1 << channelIndex)) && _trackEngines[gateOutputTrack]->gateOutput(gateIndex)) {
+            gates |= (1 << channelIndex);
         }
+
         int cvOutputTrack = cvOutputTracks[channelIndex];
-        if (!_cvOutputOverride) {
-            float cvValue = _trackEngines[cvOutputTrack]->cvOutput(trackCvIndex[cvOutputTrack]++);
-
-            // Add modulator value if configured (0 = none, 1-8 = Mod 1-8)
-            int modulatorIndex = _model.project().cvOutputModulator(channelIndex);
-            if (modulatorIndex > 0 && modulatorIndex <= CONFIG_MODULATOR_COUNT) {
-                // Modulator value is 0-127, convert to CV offset (-1.0 to +1.0 volts approximately)
-                // Scale: 127 at center = 0V offset, 0 = -1V, 255 = +1V
-                int modValue = _modulatorEngine.currentValue(modulatorIndex - 1);  // 0-127
-                float modOffset = (modValue - 64) / 64.f;  // -1.0 to +1.0
-                cvValue += modOffset;
-            }
+        int cvIndex = trackCvIndex[cvOutputTrack]++;
+        if (!(cvMask & (1 << channelIndex))) {
+            continue;
+        }
+
+        float cvValue = _trackEngines[cvOutputTrack]->cvOutput(cvIndex);
+
+        // Add modulator value if configured (0 = none, 1-8 = Mod 1-8)
+        int modulatorIndex = _project.cvOutputModulator(channelIndex);
+        if (modulatorIndex > 0 && modulatorIndex <= CONFIG_MODULATOR_COUNT) {
+            // Modulator value is 0-127, convert to CV offset (-1.0 to +1.0 volts approximately)
+            // Scale: 127 at center = 0V offset, 0 = -1V, 255 = +1V
+            int modValue = _modulatorEngine.currentValue(modulatorIndex - 1);  // 0-127
+            float modOffset = (modValue - 64) / 64.f;  // -1.0 to +1.0
+            cvValue += modOffset;
+        }
+
+        cv[channelIndex] = cvValue;
+    }
+}
+
+void Engine::updateTrackOutputs(uint32_t tracks) {
+    uint8_t gateMask;
+    uint8_t cvMask;
+    trackOutputChannels(tracks, gateMask, cvMask);
 
-            _cvOutput.setChannel(channelIndex, cvValue);
+    uint8_t gates;
+    OutputScheduler::CvArray cv;
+    evalTrackOutputs(gates, cv, gateMask, cvMask);
+
+    // channels with scheduled changes are written by the output scheduler
+    os::InterruptLock lock;
+
+    if (!_gateOutputOverride) {
+        gateMask &= ~_outputScheduler.pendingGateMask();
+        _gateOutput.setGates((_gateOutput.gates() & ~gateMask) | (gates & gateMask));
+    }
+    if (!_cvOutputOverride) {
+        cvMask &= ~_outputScheduler.pendingCvMask();
+        for (int channelIndex = 0; channelIndex < CONFIG_CHANNEL_COUNT; ++channelIndex) {
+            if (cvMask & (1 << channelIndex)) {
+                _cvOutput.setChannel(channelIndex, cv[channelIndex]);
+            }
         }
     }
 }
 
+void Engine::scheduleTrackOutputs(uint32_t tick, uint32_t cvUpdateTracks) {
+    if (_gateOutputOverride || _cvOutputOverride) {
+        return;
+    }
+
+    uint8_t gates;
+    OutputScheduler::CvArray cv;
+    evalTrackOutputs(gates, cv);
+
+    // only schedule cv channels driven by tracks that changed their cv on this tick
+    // continuous changes (slides, modulators) are written by the regular update
+    uint8_t gateMask;
+    uint8_t cvMask;
+    trackOutputChannels(cvUpdateTracks, gateMask, cvMask);
+
+    _outputScheduler.schedule(tick, gates, cvMask, cv);
+}
+
 void Engine::reset() {
     for (auto trackEngine : _trackEngines) {
         trackEngine->reset();
@@ -539,6 +711,7 @@ void Engine::updatePlayState(bool ticked) {
     // handle mute & pattern requests
 
     bool changedPatterns = false;
+    uint32_t deferredPatternRequests = 0;
 
     if (hasRequests) {
         int muteRequests = PlayState::TrackState::ImmediateMuteRequest |
@@ -559,12 +732,18 @@ void Engine::updatePlayState(bool ticked) {
 
             // handle pattern requests
             if (trackState.hasRequests(patternRequests)) {
-                trackState.setPattern(trackState.requestedPattern());
-                changedPatterns = true;
+                int requestedPattern = trackState.requestedPattern();
+                if (PlayState::isBankPattern(requestedPattern) && !_model.patternPager().acquire(trackIndex, requestedPattern)) {
+                    // bank pattern is not paged in yet, keep the request pending
+                    deferredPatternRequests |= (1 << trackIndex);
+                } else {
+                    trackState.setPattern(requestedPattern);
+                    changedPatterns = true;
+                }
             }
 
             // clear requests
-            trackState.clearRequests(muteRequests | patternRequests);
+            trackState.clearRequests(muteRequests | ((deferredPatternRequests & (1 << trackIndex)) ? 0 : patternRequests));
         }
 
         bool shouldSendPgmChange = !_preSendMidiPgmChange && changedPatterns;
@@ -633,6 +812,21 @@ void Engine::updatePlayState(bool ticked) {
         }
     }
 
+    // retry deferred pattern requests, synced requests wait for the next sync point
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        if (deferredPatternRequests & (1 << trackIndex)) {
+            auto &trackState = playState.trackState(trackIndex);
+            if (trackState.hasRequests(PlayState::TrackState::SyncedPatternRequest)) {
+                playState.notify(PlayState::Synced);
+            }
+            if (trackState.hasRequests(PlayState::TrackState::ImmediatePatternRequest | PlayState::TrackState::LatchedPatternRequest)) {
+                trackState.clearRequests(PlayState::TrackState::LatchedPatternRequest);
+                trackState.setRequests(PlayState::TrackState::ImmediatePatternRequest);
+                playState.notify(PlayState::Immediate);
+            }
+        }
+    }
+
     // handle song slot change
     if (songState.playing()) {
         const auto &slot = song.slot(songState.currentSlot());
@@ -14,11 +14,13 @@
 #endif
 #include "CvInput.h"
 #include "CvOutput.h"
+#include "OutputScheduler.h"
 #include "RoutingEngine.h"
 #include "MidiOutputEngine.h"
 #include "ModulatorEngine.h"
 #include "MidiPort.h"
 #include "MidiLearn.h"
+#include "SysExTransfer.h"
 #include "CvGateToMidiConverter.h"
 #include "UpdateReducer.h"
 
@@ -33,6 +35,7 @@
 #include "drivers/UsbMidi.h"
 
 #include <array>
+#include <atomic>
 
 #include <cstdint>
 
@@ -66,7 +69,10 @@ public:
     struct Stats {
         uint32_t uptime;
         uint32_t midiRxOverflow;
+        uint32_t midiTxOverflow;
         uint32_t usbMidiRxOverflow;
+        uint32_t usbMidiTxOverflow;
+        uint32_t uiMidiOverflow;
     };
 
     Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi);
@@ -74,17 +80,20 @@ public:
     void init();
     void update();
 
+    // seeds all random generators of the engine, used to get reproducible runs in the simulator
+    void seedRandom(uint32_t seed);
+
     // locking temporarily puts the engine in a state where completely skips all updates
     // lock should only be hold for very short amounts of time
     void lock();
     void unlock();
-    bool isLocked() const { return _locked; }
+    bool isLocked() const { return _locked.load(std::memory_order_acquire); }
 
     // suspending temporarily puts the engine in a state where it only processes basic events but skips all updates
     // suspending can be used during longer periods of time (e.g. file operations)
     void suspend();
     void resume();
-    bool isSuspended() const { return _suspended; }
+    bool isSuspended() const { return _suspended.load(std::memory_order_acquire); }
 
     // clock control
     void togglePlay(bool shift = false);
@@ -118,6 +127,9 @@ public:
     uint32_t syncDivisor() const;
     float syncFraction() const;
 
+    // sequences of bank patterns paged in from flash
+    NoteSequence *bankSequence(int track, int pattern) { return _model.patternPager().sequence(track, pattern); }
+
     const CvInput &cvInput() const { return _cvInput; }
     const CvOutput &cvOutput() const { return _cvOutput; }
     const uint8_t gateOutput() const { return _gateOutput.gates(); }
@@ -158,11 +170,17 @@ public:
     const MidiLearn &midiLearn() const { return _midiLearn; }
           MidiLearn &midiLearn()       { return _midiLearn; }
 
+    const SysExTransfer &sysExTransfer() const { return _sysExTransfer; }
+          SysExTransfer &sysExTransfer()       { return _sysExTransfer; }
+
     bool trackEnginesConsistent() const;
     bool trackPatternsConsistent() const;
 
     bool sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
+    bool sendSysEx(MidiPort port, uint8_t cable, const uint8_t *data, size_t length);
     void setMidiReceiveHandler(MidiReceiveHandler handler) { _midiReceiveHandler = handler; }
+    // called by the midi receive handler when a message could not be queued for the ui task
+    void midiReceiveOverflow() { ++_uiMidiOverflow; }
     void setUsbMidiConnectHandler(UsbMidiConnectHandler handler) { _usbMidiConnectHandler = handler; }
     void setUsbMidiDisconnectHandler(UsbMidiDisconnectHandler handler) { _usbMidiDisconnectHandler = handler; }
     bool midiProgramChangesEnabled();
@@ -179,9 +197,13 @@ private:
     // Clock::Listener
     virtual void onClockOutput(const Clock::OutputState &state) override;
     virtual void onClockMidi(uint8_t data) override;
+    virtual void onClockTick(uint32_t tick) override;
 
     void updateTrackSetups();
-    void updateTrackOutputs();
+    void trackOutputChannels(uint32_t tracks, uint8_t &gateMask, uint8_t &cvMask) const;
+    void evalTrackOutputs(uint8_t &gates, OutputScheduler::CvArray &cv, uint8_t gateMask = 0xff, uint8_t cvMask = 0xff) const;
+    void updateTrackOutputs(uint32_t tracks = 0xffffffff);
+    void scheduleTrackOutputs(uint32_t tick, uint32_t cvUpdateTracks);
     void reset();
     void updatePlayState(bool ticked);
     void updateOverrides();
@@ -207,6 +229,7 @@ private:
 
     CvInput _cvInput;
     CvOutput _cvOutput;
+    OutputScheduler _outputScheduler;
 
     Clock _clock;
     TapTempo _tapTempo;
@@ -221,19 +244,22 @@ private:
 
     RoutingEngine _routingEngine;
     MidiLearn _midiLearn;
+    SysExTransfer _sysExTransfer;
     MidiReceiveHandler _midiReceiveHandler;
     UsbMidiConnectHandler _usbMidiConnectHandler;
     UsbMidiDisconnectHandler _usbMidiDisconnectHandler;
 
     CvGateToMidiConverter _cvGateToMidiConverter;
 
-    // locking
-    volatile uint32_t _requestLock = 0;
-    volatile uint32_t _locked = 0;
+    uint32_t _uiMidiOverflow = 0;
+
+    // locking, requested by another task and acknowledged by the engine task
+    std::atomic<uint32_t> _requestLock { 0 };
+    std::atomic<uint32_t> _locked { 0 };
 
     // suspending
-    volatile uint32_t _requestSuspend = 0;
-    volatile uint32_t _suspended = 0;
+    std::atomic<uint32_t> _requestSuspend { 0 };
+    std::atomic<uint32_t> _suspended { 0 };
 
     uint32_t _tick = 0;
 
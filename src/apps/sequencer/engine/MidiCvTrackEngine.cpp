@@ -1,6 +1,5 @@
 #include "MidiCvTrackEngine.h"
 #include "Engine.h"
-#include "Slide.h"
 #include "MidiUtils.h"
 
 #include "os/os.h"
@@ -47,9 +46,10 @@ void MidiCvTrackEngine::update(float dt) {
     if (_midiCvTrack.voices() == 1) {
         _pitchCvOutputTarget = noteToCv(_voices.front().note + _midiCvTrack.transpose()) + pitchBendToCv(_pitchBend);
         if (_slideActive && _midiCvTrack.slideTime() > 0) {
-            _pitchCvOutput = Slide::applySlide(_pitchCvOutput, _pitchCvOutputTarget, _midiCvTrack.slideTime(), dt);
+            _pitchCvOutput = _pitchSlide.apply(_pitchCvOutput, _pitchCvOutputTarget, _midiCvTrack.slideTime(), _model.project().slideMode(), dt);
         } else {
             _pitchCvOutput = _pitchCvOutputTarget;
+            _pitchSlide.reset();
         }
     }
 }
@@ -218,6 +218,7 @@ void MidiCvTrackEngine::addVoice(int note, int velocity) {
     voice.pressure = 0;
 
     sortVoices();
+    _pitchSlide.retrigger();
 }
 
 void MidiCvTrackEngine::removeVoice(int note) {
@@ -227,6 +228,7 @@ void MidiCvTrackEngine::removeVoice(int note) {
     }
 
     sortVoices();
+    _pitchSlide.retrigger();
 }
 
 MidiCvTrackEngine::Voice *MidiCvTrackEngine::findVoice(int note) {
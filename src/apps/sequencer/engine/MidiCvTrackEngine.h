@@ -2,6 +2,7 @@
 
 #include "TrackEngine.h"
 #include "ArpeggiatorEngine.h"
+#include "Slide.h"
 
 #include "model/Track.h"
 
@@ -87,5 +88,6 @@ private:
     // slides for pitch, only valid in monophonic mode
     bool _slideActive;
     float _pitchCvOutputTarget;
+    Slide _pitchSlide;
     float _pitchCvOutput;
 };
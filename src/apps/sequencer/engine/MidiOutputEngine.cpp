@@ -6,16 +6,37 @@
 
 #include "core/midi/MidiMessage.h"
 
+template<typename Func>
+static void forEachOutput(uint16_t mask, Func func) {
+    for (int outputIndex = 0; mask; ++outputIndex, mask >>= 1) {
+        if (mask & 1) {
+            func(outputIndex);
+        }
+    }
+}
+
 MidiOutputEngine::MidiOutputEngine(Engine &engine, Model &model):
     _engine(engine),
     _midiOutput(model.project().midiOutput())
 {
+    rebuildRouting();
 }
 
 void MidiOutputEngine::reset() {
     for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
         resetOutput(outputIndex);
     }
+
+    rebuildRouting();
+}
+
+void MidiOutputEngine::updateRouting() {
+    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
+        if (_midiOutput.output(outputIndex) != _routedOutputs[outputIndex]) {
+            rebuildRouting();
+            return;
+        }
+    }
 }
 
 void MidiOutputEngine::update(bool forceSendCC) {
@@ -50,14 +71,16 @@ void MidiOutputEngine::update(bool forceSendCC) {
         MidiPort port = MidiPort(output.target().port());
         int channel = output.target().channel();
 
+        bool notesHeld = noteRequestsHeld(outputState);
+
         // send slide requests
-        if (outputState.hasRequest(OutputState::Slide)) {
+        if (!notesHeld && outputState.hasRequest(OutputState::Slide)) {
             sendMidi(port, MidiMessage::makeControlChange(channel, 65, outputState.slide ? 127 : 0));
             outputState.clearRequest(OutputState::Slide);
         }
 
         // send note requests
-        if (outputState.hasRequest(OutputState::NoteOn | OutputState::NoteOff)) {
+        if (!notesHeld && outputState.hasRequest(OutputState::NoteOn | OutputState::NoteOff)) {
             int note = int(output.noteSource()) <= int(MidiOutput::Output::NoteSource::LastTrack) ?
                 outputState.note :
                 int(output.noteSource()) - int(MidiOutput::Output::NoteSource::FirstNote);
@@ -92,6 +115,10 @@ void MidiOutputEngine::update(bool forceSendCC) {
             outputState.clearRequest(OutputState::NoteOn | OutputState::NoteOff);
         }
 
+        if (!notesHeld) {
+            outputState.held = false;
+        }
+
         // send control change requests
         if (sendCC && outputState.hasRequest(OutputState::ControlChange)) {
             sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), outputState.control));
@@ -101,51 +128,38 @@ void MidiOutputEngine::update(bool forceSendCC) {
 }
 
 void MidiOutputEngine::sendGate(int trackIndex, bool gate) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
-        auto &outputState = _outputStates[outputIndex];
-
-        if (output.takesGateFromTrack(trackIndex)) {
-            outputState.setRequest(gate ? OutputState::NoteOn : OutputState::NoteOff);
-        }
-    }
+    forEachOutput(_routing.gate[trackIndex], [&] (int outputIndex) {
+        setNoteRequest(_outputStates[outputIndex], gate ? OutputState::NoteOn : OutputState::NoteOff);
+    });
 }
 
 void MidiOutputEngine::sendSlide(int trackIndex, bool slide) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
+    forEachOutput(_routing.note[trackIndex], [&] (int outputIndex) {
         auto &outputState = _outputStates[outputIndex];
-
-        if (output.takesNoteFromTrack(trackIndex)) {
-            if (slide != outputState.slide) {
-                outputState.slide = slide;
-                outputState.setRequest(OutputState::Slide);
-            }
+        if (slide != outputState.slide) {
+            outputState.slide = slide;
+            setNoteRequest(outputState, OutputState::Slide);
         }
-    }
+    });
 }
 
 void MidiOutputEngine::sendCv(int trackIndex, float cv) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
-        auto &outputState = _outputStates[outputIndex];
-
-        if (output.takesNoteFromTrack(trackIndex)) {
-            outputState.note = clamp(60 + int(std::floor(cv * 12.f + 0.01f)), 0, 127);
-        }
+    forEachOutput(_routing.note[trackIndex], [&] (int outputIndex) {
+        _outputStates[outputIndex].note = clamp(60 + int(std::floor(cv * 12.f + 0.01f)), 0, 127);
+    });
 
-        if (output.takesVelocityFromTrack(trackIndex)) {
-            outputState.velocity = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
-        }
+    forEachOutput(_routing.velocity[trackIndex], [&] (int outputIndex) {
+        _outputStates[outputIndex].velocity = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
+    });
 
-        if (output.takesControlFromTrack(trackIndex)) {
-            int8_t value = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
-            if (value != outputState.control) {
-                outputState.control = value;
-                outputState.setRequest(OutputState::ControlChange);
-            }
+    forEachOutput(_routing.control[trackIndex], [&] (int outputIndex) {
+        auto &outputState = _outputStates[outputIndex];
+        int8_t value = clamp(int(std::floor(cv * (127.f / 5.f))), 0, 127);
+        if (value != outputState.control) {
+            outputState.control = value;
+            outputState.setRequest(OutputState::ControlChange);
         }
-    }
+    });
 }
 
 void MidiOutputEngine::sendProgramChange(int channel, int programNumber) {
@@ -188,6 +202,20 @@ void MidiOutputEngine::resetOutput(int outputIndex) {
     outputState.reset();
 }
 
+void MidiOutputEngine::setNoteRequest(OutputState &outputState, uint8_t request) {
+    outputState.setRequest(request);
+    if (_tickActive) {
+        outputState.held = true;
+        outputState.heldTick = _requestTick;
+    }
+}
+
+bool MidiOutputEngine::noteRequestsHeld(const OutputState &outputState) const {
+    // held while the tick is ahead of the clock, requests are released if the clock was stopped or reset
+    const auto &clock = _engine.clock();
+    return outputState.held && outputState.heldTick - clock.tick() < clock.activeTickLookahead();
+}
+
 void MidiOutputEngine::sendMidi(MidiPort port, const MidiMessage &message) {
     // MidiMessage::dump(message);
     // always use cable 0
@@ -195,40 +223,83 @@ void MidiOutputEngine::sendMidi(MidiPort port, const MidiMessage &message) {
 }
 
 void MidiOutputEngine::sendCvIn(int cvInIndex, float cv) {
-    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
-        const auto &output = _midiOutput.output(outputIndex);
-        if (output.event() == MidiOutput::Output::Event::ControlChange) {
-            auto controlSource = output.controlSource();
-            if (controlSource >= MidiOutput::Output::ControlSource::FirstCvIn &&
-                controlSource <= MidiOutput::Output::ControlSource::LastCvIn) {
-                int sourceIndex = int(controlSource) - int(MidiOutput::Output::ControlSource::FirstCvIn);
-                if (sourceIndex == cvInIndex) {
-                    int ccValue = clamp(int((cv + 5.0f) / 10.0f * 127.0f), 0, 127);
-                    // Read target directly from output config (not from cached state)
-                    MidiPort port = MidiPort(output.target().port());
-                    int channel = output.target().channel();
-                    sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), ccValue));
-                }
-            }
-        }
-    }
+    int ccValue = clamp(int((cv + 5.0f) / 10.0f * 127.0f), 0, 127);
+    forEachOutput(_routing.cvIn[cvInIndex], [&] (int outputIndex) {
+        sendControl(outputIndex, ccValue);
+    });
 }
 
 void MidiOutputEngine::sendModulator(int modulatorIndex, int value) {
+    forEachOutput(_routing.modulator[modulatorIndex], [&] (int outputIndex) {
+        sendControl(outputIndex, value);
+    });
+}
+
+// sends a continuous controller value, only if it differs from the last value sent on the output
+void MidiOutputEngine::sendControl(int outputIndex, int value) {
+    auto &outputState = _outputStates[outputIndex];
+    if (value == outputState.sentControl) {
+        return;
+    }
+    const auto &output = _midiOutput.output(outputIndex);
+    // Read target directly from output config (not from cached state)
+    MidiPort port = MidiPort(output.target().port());
+    int channel = output.target().channel();
+    sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), value));
+    outputState.sentControl = value;
+}
+
+void MidiOutputEngine::Routing::clear() {
+    gate.fill(0);
+    note.fill(0);
+    velocity.fill(0);
+    control.fill(0);
+    modulator.fill(0);
+    cvIn.fill(0);
+}
+
+void MidiOutputEngine::rebuildRouting() {
+    typedef MidiOutput::Output::ControlSource ControlSource;
+
+    _routing.clear();
+
     for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
         const auto &output = _midiOutput.output(outputIndex);
-        if (output.event() == MidiOutput::Output::Event::ControlChange) {
+        OutputMask outputMask = 1 << outputIndex;
+
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            if (output.takesGateFromTrack(trackIndex)) {
+                _routing.gate[trackIndex] |= outputMask;
+            }
+            if (output.takesNoteFromTrack(trackIndex)) {
+                _routing.note[trackIndex] |= outputMask;
+            }
+            if (output.takesVelocityFromTrack(trackIndex)) {
+                _routing.velocity[trackIndex] |= outputMask;
+            }
+            if (output.takesControlFromTrack(trackIndex)) {
+                _routing.control[trackIndex] |= outputMask;
+            }
+        }
+
+        if (output.isControlChangeEvent()) {
             auto controlSource = output.controlSource();
-            if (controlSource >= MidiOutput::Output::ControlSource::FirstModulator &&
-                controlSource <= MidiOutput::Output::ControlSource::LastModulator) {
-                int sourceIndex = int(controlSource) - int(MidiOutput::Output::ControlSource::FirstModulator);
-                if (sourceIndex == modulatorIndex) {
-                    // Read target directly from output config (not from cached state)
-                    MidiPort port = MidiPort(output.target().port());
-                    int channel = output.target().channel();
-                    sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), value));
+            if (controlSource >= ControlSource::FirstModulator && controlSource <= ControlSource::LastModulator) {
+                int modulatorIndex = int(controlSource) - int(ControlSource::FirstModulator);
+                if (modulatorIndex < CONFIG_MODULATOR_COUNT) {
+                    _routing.modulator[modulatorIndex] |= outputMask;
+                }
+            } else if (controlSource >= ControlSource::FirstCvIn && controlSource <= ControlSource::LastCvIn) {
+                int cvInIndex = int(controlSource) - int(ControlSource::FirstCvIn);
+                if (cvInIndex < CONFIG_CV_INPUT_CHANNELS) {
+                    _routing.cvIn[cvInIndex] |= outputMask;
                 }
             }
         }
+
+        // resend the current value after the control number or source changed
+        _outputStates[outputIndex].sentControl = -1;
+
+        _routedOutputs[outputIndex] = output;
     }
 }
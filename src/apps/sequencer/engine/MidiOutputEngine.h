@@ -21,6 +21,15 @@ public:
     void reset();
     void update(bool forceSendCC = false);
 
+    // Note and slide requests made while processing a tick are held until the clock has passed that tick.
+    // Ticks are processed ahead of the clock (see Clock::setTickLookahead), this keeps MIDI notes in line with
+    // the MIDI clock and the cv/gate outputs committed by the clock timer.
+    void beginTick(uint32_t tick) { _requestTick = tick; _tickActive = true; }
+    void endTick() { _tickActive = false; }
+
+    // rebuild the source to output routing if the midi output config has changed
+    void updateRouting();
+
     void sendGate(int trackIndex, bool gate);
     void sendSlide(int trackIndex, bool slide);
     void sendCv(int trackIndex, float cv);
@@ -46,23 +55,30 @@ private:
         MidiTargetConfig target;
 
         uint8_t requests;
+        // note and slide requests are held until the clock passed this tick
+        bool held;
+        uint32_t heldTick;
         int8_t note;
         int8_t slide;
         int8_t velocity;
         int8_t control;
 
         int8_t activeNote;
+        // last value sent by sendModulator/sendCvIn, -1 if none
+        int8_t sentControl;
 
         OutputState() { reset(); }
 
         void reset() {
             requests = 0;
+            held = false;
             note = 60;
             slide = 0;
             velocity = 100;
             control = 0;
 
             activeNote = -1;
+            sentControl = -1;
         };
 
         void setRequest(uint8_t request) { requests |= request; }
@@ -70,12 +86,37 @@ private:
         bool hasRequest(uint8_t request) { return requests & request; }
     };
 
+    // output masks indexed by source, rebuilt when the midi output config changes
+    typedef uint16_t OutputMask;
+    static_assert(CONFIG_MIDI_OUTPUT_COUNT <= 16, "OutputMask too small");
+
+    struct Routing {
+        std::array<OutputMask, CONFIG_TRACK_COUNT> gate;
+        std::array<OutputMask, CONFIG_TRACK_COUNT> note;
+        std::array<OutputMask, CONFIG_TRACK_COUNT> velocity;
+        std::array<OutputMask, CONFIG_TRACK_COUNT> control;
+        std::array<OutputMask, CONFIG_MODULATOR_COUNT> modulator;
+        std::array<OutputMask, CONFIG_CV_INPUT_CHANNELS> cvIn;
+
+        void clear();
+    };
+
+    void rebuildRouting();
+
     void resetOutput(int outputIndex);
 
+    void setNoteRequest(OutputState &outputState, uint8_t request);
+    bool noteRequestsHeld(const OutputState &outputState) const;
+
     void sendMidi(MidiPort port, const MidiMessage &message);
+    void sendControl(int outputIndex, int value);
 
     Engine &_engine;
     const MidiOutput &_midiOutput;
     std::array<OutputState, CONFIG_MIDI_OUTPUT_COUNT> _outputStates;
+    MidiOutput::OutputArray _routedOutputs;
+    Routing _routing;
     uint32_t _lastSendCCTicks = 0;
+    uint32_t _requestTick = 0;
+    bool _tickActive = false;
 };
@@ -2,7 +2,6 @@
 
 #include "Engine.h"
 #include "Groove.h"
-#include "Slide.h"
 #include "SequenceUtils.h"
 
 #include "core/Debug.h"
@@ -13,6 +12,10 @@
 
 static Random rng;
 
+void NoteTrackEngine::seedRandom(uint32_t seed) {
+    rng.seed(seed);
+}
+
 // evaluate if step gate is active
 static bool evalStepGate(const NoteSequence::Step &step, int probabilityBias) {
     int probability = clamp(step.gateProbability() + probabilityBias, -1, NoteSequence::GateProbability::Max);
@@ -177,6 +180,7 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
                 result |= TickResult::CvUpdate;
                 _cvOutputTarget = _cvQueue.front().cv;
                 _slideActive = _cvQueue.front().slide;
+                _slide.retrigger();
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
@@ -256,15 +260,28 @@ void NoteTrackEngine::update(float dt) {
     }
 
     if (_slideActive && _noteTrack.slideTime() > 0) {
-        _cvOutput = Slide::applySlide(_cvOutput, _cvOutputTarget, _noteTrack.slideTime(), dt);
+        _cvOutput = _slide.apply(_cvOutput, _cvOutputTarget, _noteTrack.slideTime(), _model.project().slideMode(), dt);
     } else {
         _cvOutput = _cvOutputTarget;
+        _slide.reset();
     }
 }
 
 void NoteTrackEngine::changePattern() {
-    _sequence = &_noteTrack.sequence(pattern());
-    _fillSequence = &_noteTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
+    int pattern = this->pattern();
+
+    if (PlayState::isBankPattern(pattern)) {
+        if (auto sequence = _engine.bankSequence(_track.trackIndex(), pattern)) {
+            _sequence = sequence;
+            _fillSequence = sequence;
+            return;
+        }
+        // not paged in
+        pattern = 0;
+    }
+
+    _sequence = &_noteTrack.sequence(pattern);
+    _fillSequence = &_noteTrack.sequence(std::min(pattern + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
 void NoteTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
@@ -6,6 +6,7 @@
 #include "Groove.h"
 #include "RecordHistory.h"
 #include "StepRecorder.h"
+#include "Slide.h"
 
 class NoteTrackEngine : public TrackEngine {
 public:
@@ -16,6 +17,9 @@ public:
         reset();
     }
 
+    // reseeds the random generator shared by all NoteTrackEngines
+    static void seedRandom(uint32_t seed);
+
     virtual Track::TrackMode trackMode() const override { return Track::TrackMode::Note; }
 
     virtual void reset() override;
@@ -82,6 +86,7 @@ private:
     float _cvOutput;
     float _cvOutputTarget;
     bool _slideActive;
+    Slide _slide;
 
     struct Gate {
         uint32_t tick;
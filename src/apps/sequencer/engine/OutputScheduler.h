@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Config.h"
+
+#include "CvOutput.h"
+
+#include "drivers/GateOutput.h"
+
+#include "os/os.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Gate/CV output scheduler.
+// The engine task processes clock ticks one tick ahead of the clock timer and schedules the resulting
+// output changes as frames. Frames are committed to the hardware from the clock timer interrupt at their
+// exact tick, which makes output edges accurate to the clock period instead of the RTOS period.
+// Channels with pending changes are masked so the engine task does not write them ahead of time.
+class OutputScheduler {
+public:
+    static constexpr int Channels = CONFIG_CHANNEL_COUNT;
+    static constexpr size_t Capacity = 8;
+
+    typedef std::array<float, Channels> CvArray;
+
+    OutputScheduler(GateOutput &gateOutput, CvOutput &cvOutput) :
+        _gateOutput(gateOutput),
+        _cvOutput(cvOutput)
+    {
+        reset();
+    }
+
+    // drop all pending frames (called when the clock starts/stops)
+    void reset() {
+        os::InterruptLock lock;
+        _read = 0;
+        _write = 0;
+        _pendingGateMask = 0;
+        _pendingCvMask = 0;
+        _scheduledGates = 0;
+    }
+
+    // schedule outputs to be committed at the given tick (engine task)
+    // gate changes are detected automatically, cvMask selects the cv channels to update
+    void schedule(uint32_t tick, uint8_t gates, uint8_t cvMask, const CvArray &cv) {
+        os::InterruptLock lock;
+
+        // compare against the gates as they will be once all pending frames are committed
+        uint8_t currentGates = (_gateOutput.gates() & ~_pendingGateMask) | (_scheduledGates & _pendingGateMask);
+        uint8_t gateMask = gates ^ currentGates;
+
+        if (gateMask == 0 && cvMask == 0) {
+            return;
+        }
+
+        Frame frame;
+        frame.tick = tick;
+        frame.gateMask = gateMask;
+        frame.gates = gates;
+        frame.cvMask = cvMask;
+        frame.cv = cv;
+
+        _scheduledGates = gates;
+
+        // make room by committing the oldest frame early
+        if (size() == Capacity) {
+            apply(_frames[_read]);
+            _read = increase(_read);
+            ++_overflows;
+        }
+
+        _frames[_write] = frame;
+        _write = increase(_write);
+        _pendingGateMask |= frame.gateMask;
+        _pendingCvMask |= frame.cvMask;
+    }
+
+    // commit all frames up to the given tick (clock timer interrupt)
+    void commit(uint32_t tick) {
+        if (_read == _write) {
+            return;
+        }
+        while (_read != _write && int32_t(tick - _frames[_read].tick) >= 0) {
+            apply(_frames[_read]);
+            _read = increase(_read);
+        }
+        updatePendingMasks();
+    }
+
+    // channels that must not be written by the engine task until committed
+    uint8_t pendingGateMask() const { return _pendingGateMask; }
+    uint8_t pendingCvMask() const { return _pendingCvMask; }
+
+    uint32_t overflows() const { return _overflows; }
+
+private:
+    struct Frame {
+        uint32_t tick;
+        uint8_t gateMask;
+        uint8_t gates;
+        uint8_t cvMask;
+        CvArray cv;
+    };
+
+    void apply(const Frame &frame) {
+        if (frame.gateMask) {
+            _gateOutput.setGates((_gateOutput.gates() & ~frame.gateMask) | (frame.gates & frame.gateMask));
+            _gateOutput.commit();
+        }
+        if (frame.cvMask) {
+            for (int i = 0; i < Channels; ++i) {
+                if (frame.cvMask & (1 << i)) {
+                    _cvOutput.setChannel(i, frame.cv[i]);
+                }
+            }
+            _cvOutput.commit(frame.cvMask);
+        }
+    }
+
+    void updatePendingMasks() {
+        uint8_t gateMask = 0;
+        uint8_t cvMask = 0;
+        for (size_t i = _read; i != _write; i = increase(i)) {
+            gateMask |= _frames[i].gateMask;
+            cvMask |= _frames[i].cvMask;
+        }
+        _pendingGateMask = gateMask;
+        _pendingCvMask = cvMask;
+    }
+
+    size_t size() const { return (_write + Capacity + 1 - _read) % (Capacity + 1); }
+    size_t increase(size_t pos) const { return (pos + 1) % (Capacity + 1); }
+
+    GateOutput &_gateOutput;
+    CvOutput &_cvOutput;
+
+    std::array<Frame, Capacity + 1> _frames;
+    volatile size_t _read;
+    volatile size_t _write;
+
+    volatile uint8_t _pendingGateMask;
+    volatile uint8_t _pendingCvMask;
+
+    uint8_t _scheduledGates;
+
+    uint32_t _overflows = 0;
+};
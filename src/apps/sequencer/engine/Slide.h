@@ -1,12 +1,103 @@
 #pragma once
 
-namespace Slide {
+#include "model/Types.h"
 
-static float applySlide(float current, float target, int slideTime, float dt) {
-    float tau = slideTime / 100.f;
-    tau = tau * tau * 2.f;
-    float coeff = tau > 0.f ? std::exp(-1.f * dt / tau) : 0.f;
-    return target + coeff * (current - target);
-}
+#include <algorithm>
 
-} // namespace Slide
+#include <cmath>
+
+// Slews a CV output towards its target.
+// The slide advances in fixed steps of the engine update interval, so the glide does not depend on the timing
+// jitter of the engine task. The per step coefficient only depends on slide time and mode and is recomputed
+// when those change, stepping does no transcendental math.
+// Constant time slides latch their step size when a note starts, targets moving continuously (i.e. curves or
+// pitch bend) are followed at that rate. Curve tracks therefore slide linearly instead.
+class Slide {
+public:
+    static constexpr float Interval = 0.001f;
+    static constexpr float Rate = 1.f / Interval;
+
+    // limits catching up after the engine stalled (i.e. while it was locked)
+    static constexpr int MaxSteps = 100;
+
+    // call when not sliding, restarts the step timing and constant time slides
+    void reset() {
+        _time = 0.f;
+        _step = -1.f;
+    }
+
+    // call when sliding to a new note, constant time slides cover the new distance in the slide time
+    void retrigger() {
+        _step = -1.f;
+    }
+
+    float apply(float current, float target, int slideTime, Types::SlideMode mode, float dt) {
+        if (slideTime != _slideTime || mode != _mode) {
+            updateCoefficient(slideTime, mode);
+            _step = -1.f;
+        }
+
+        if (mode == Types::SlideMode::ConstantTime && _step < 0.f) {
+            // cover the remaining distance in the slide time
+            _step = std::abs(target - current) * _coefficient;
+        }
+
+        _time += dt;
+        int steps = int(_time * Rate + 0.5f);
+        _time -= steps * Interval;
+
+        for (steps = std::min(steps, int(MaxSteps)); steps > 0; --steps) {
+            switch (mode) {
+            case Types::SlideMode::Exponential:
+                current = target + _coefficient * (current - target);
+                break;
+            case Types::SlideMode::Linear:
+                current = moveTowards(current, target, _coefficient);
+                break;
+            case Types::SlideMode::ConstantTime:
+                current = moveTowards(current, target, _step);
+                break;
+            case Types::SlideMode::Last:
+                break;
+            }
+        }
+
+        return current;
+    }
+
+private:
+    void updateCoefficient(int slideTime, Types::SlideMode mode) {
+        _slideTime = slideTime;
+        _mode = mode;
+
+        // exponential time constant
+        float tau = slideTime / 100.f;
+        tau = tau * tau * 2.f;
+
+        switch (mode) {
+        case Types::SlideMode::Exponential:
+            _coefficient = tau > 0.f ? std::exp(-Interval / tau) : 0.f;
+            break;
+        case Types::SlideMode::Linear:
+        case Types::SlideMode::ConstantTime:
+            // linear slides take as long as the exponential slide takes to settle,
+            // for one volt (linear) or for any interval (constant time)
+            _coefficient = tau > 0.f ? Interval / (SettleTimeConstants * tau) : 1.f;
+            break;
+        case Types::SlideMode::Last:
+            break;
+        }
+    }
+
+    static float moveTowards(float current, float target, float step) {
+        return current < target ? std::min(current + step, target) : std::max(current - step, target);
+    }
+
+    static constexpr float SettleTimeConstants = 4.f;
+
+    int _slideTime = -1;
+    Types::SlideMode _mode = Types::SlideMode::Last;
+    float _coefficient = 0.f;
+    float _step = -1.f;
+    float _time = 0.f;
+};
@@ -0,0 +1,549 @@
+#include "SysExTransfer.h"
+
+#include "model/ProjectVersion.h"
+
+#include "core/Debug.h"
+#include "core/hash/FnvHash.h"
+#include "core/profiler/Profiler.h"
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/io/VersionedSerializedReader.h"
+
+#include "os/os.h"
+
+#include <algorithm>
+
+#include <cstring>
+
+static constexpr int PatternCount = CONFIG_PATTERN_COUNT + CONFIG_SNAPSHOT_COUNT;
+
+// length of the message header (manufacturer id, device id, command) excluding the 0xf0 start byte
+static constexpr size_t HeaderLength = 3;
+
+static size_t encodedLength(size_t length) {
+    return length + (length + 6) / 7;
+}
+
+// 7 bytes are encoded in 8, the first byte of each group holds the most significant bits
+static size_t encode(const uint8_t *src, size_t length, uint8_t *dst) {
+    size_t dstLength = 0;
+    for (size_t i = 0; i < length; i += 7) {
+        uint8_t &msbs = dst[dstLength++];
+        msbs = 0;
+        for (size_t j = 0; j < 7 && i + j < length; ++j) {
+            msbs |= (src[i + j] >> 7) << j;
+            dst[dstLength++] = src[i + j] & 0x7f;
+        }
+    }
+    return dstLength;
+}
+
+// decodes straight from the receive buffer, fails if the data exceeds the capacity
+static bool decode(const SysExBuffer &buffer, size_t begin, size_t end, uint8_t *dst, size_t capacity, size_t &length) {
+    length = 0;
+    for (size_t i = begin; i < end; ) {
+        uint8_t msbs = buffer[i++];
+        for (size_t j = 0; j < 7 && i < end; ++j, ++i) {
+            if (length == capacity) {
+                return false;
+            }
+            dst[length++] = buffer[i] | (((msbs >> j) & 1) << 7);
+        }
+    }
+    return true;
+}
+
+static size_t encodeValue(uint32_t value, size_t count, uint8_t *dst) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (value >> (i * 7)) & 0x7f;
+    }
+    return count;
+}
+
+static uint32_t decodeValue(const SysExBuffer &buffer, size_t index, size_t count) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value |= uint32_t(buffer[index + i] & 0x7f) << (i * 7);
+    }
+    return value;
+}
+
+class RecordWriter {
+public:
+    RecordWriter(uint8_t *data, size_t capacity) :
+        _data(data),
+        _capacity(capacity)
+    {}
+
+    void write(const void *data, size_t len) {
+        if (_pos + len > _capacity) {
+            _overflow = true;
+            return;
+        }
+        std::memcpy(&_data[_pos], data, len);
+        _pos += len;
+    }
+
+    size_t size() const { return _pos; }
+    bool overflow() const { return _overflow; }
+
+private:
+    uint8_t *_data;
+    size_t _capacity;
+    size_t _pos = 0;
+    bool _overflow = false;
+};
+
+class RecordReader {
+public:
+    RecordReader(const uint8_t *data, size_t size) :
+        _data(data),
+        _size(size)
+    {}
+
+    void read(void *data, size_t len) {
+        if (_pos + len > _size) {
+            std::memset(data, 0, len);
+            _pos = _size;
+            return;
+        }
+        std::memcpy(data, &_data[_pos], len);
+        _pos += len;
+    }
+
+private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _pos = 0;
+};
+
+// serializes the profiler intervals and task statistics (see SysExTransfer.h for the layout)
+static void writeProfile(RecordWriter &writer) {
+    auto writeValue = [&writer] (uint32_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            uint8_t byte = value >> (i * 8);
+            writer.write(&byte, 1);
+        }
+    };
+    auto writeString = [&writer] (const char *str) {
+        writer.write(str, std::strlen(str) + 1);
+    };
+
+#if CONFIG_ENABLE_PROFILER
+    writeValue(Profiler::intervalCount(), 1);
+    for (int i = 0; i < Profiler::intervalCount(); ++i) {
+        const auto &interval = Profiler::interval(i);
+        auto stats = interval.stats();
+        writeString(interval.desc);
+        writeValue(stats.count, 4);
+        writeValue(stats.min, 4);
+        writeValue(stats.avg, 4);
+        writeValue(stats.p99, 4);
+        writeValue(stats.max, 4);
+        writeValue(stats.overruns, 4);
+        writeValue(interval.budget / CycleCounter::CyclesPerUs, 4);
+    }
+#else // CONFIG_ENABLE_PROFILER
+    writeValue(0, 1);
+#endif // CONFIG_ENABLE_PROFILER
+
+#if CONFIG_ENABLE_TASK_PROFILER
+    int taskCount = 0;
+    os::TaskProfiler::enumerate([&taskCount] (const os::TaskProfiler::TaskInfo &info) { ++taskCount; });
+    writeValue(taskCount, 1);
+    os::TaskProfiler::enumerate([&] (const os::TaskProfiler::TaskInfo &info) {
+        writeString(info.name ? info.name : "");
+        writeValue(info.priority, 1);
+        writeValue(info.load, 1);
+        writeValue(info.stackSize, 2);
+        writeValue(info.stackFree, 2);
+    });
+#else // CONFIG_ENABLE_TASK_PROFILER
+    writeValue(0, 1);
+#endif // CONFIG_ENABLE_TASK_PROFILER
+}
+
+SysExTransfer::SysExTransfer(Project &project, Midi &midi, UsbMidi &usbMidi) :
+    _project(project),
+    _midi(midi),
+    _usbMidi(usbMidi)
+{}
+
+void SysExTransfer::update() {
+    // the record buffer belongs to the ui task until the record was applied
+    switch (_recordState.load(std::memory_order_acquire)) {
+    case RecordState::None:
+        break;
+    case RecordState::Pending:
+        return;
+    case RecordState::Applied:
+        _recordState.store(RecordState::None, std::memory_order_relaxed);
+        reply(_load.port, Command::Ack, uint8_t(Command::RecordEnd), 0);
+        break;
+    case RecordState::Failed:
+        _recordState.store(RecordState::None, std::memory_order_relaxed);
+        reply(_load.port, Command::Nak, uint8_t(Command::RecordEnd), uint8_t(Error::InvalidRecord));
+        break;
+    }
+
+    receive(MidiPort::Midi, _midi.sysExBuffer());
+    receive(MidiPort::UsbMidi, _usbMidi.sysExBuffer());
+
+    if (sendPendingReply()) {
+        sendDump();
+    }
+}
+
+void SysExTransfer::receive(MidiPort port, SysExBuffer &buffer) {
+    while (size_t length = buffer.messageLength()) {
+        if (!sendPendingReply() || _recordState.load(std::memory_order_relaxed) == RecordState::Pending) {
+            return;
+        }
+        handleMessage(port, buffer, length);
+        buffer.consume(length);
+    }
+}
+
+void SysExTransfer::handleMessage(MidiPort port, const SysExBuffer &buffer, size_t length) {
+    // F0 <manufacturer id> <device id> <command> ... F7
+    if (length < HeaderLength + 2 || buffer[1] != ManufacturerId || buffer[2] != DeviceId) {
+        return;
+    }
+
+    switch (Command(buffer[3])) {
+    case Command::DumpRequest:
+        handleDumpRequest(port, buffer, length);
+        break;
+    case Command::RecordBegin:
+        handleRecordBegin(port, buffer, length);
+        break;
+    case Command::Block:
+        handleBlock(port, buffer, length);
+        break;
+    case Command::RecordEnd:
+        handleRecordEnd(port, buffer, length);
+        break;
+    case Command::DumpEnd:
+    case Command::Ack:
+    case Command::Nak:
+        break;
+    }
+}
+
+void SysExTransfer::handleDumpRequest(MidiPort port, const SysExBuffer &buffer, size_t length) {
+    if (length != HeaderLength + 4 || buffer[4] > uint8_t(DumpType::Profile) || buffer[5] >= PatternCount) {
+        reply(port, Command::Nak, uint8_t(Command::DumpRequest), uint8_t(Error::InvalidMessage));
+        return;
+    }
+    if (_load.active || _dump.active) {
+        reply(port, Command::Nak, uint8_t(Command::DumpRequest), uint8_t(Error::Busy));
+        return;
+    }
+
+    _dump.port = port;
+    _dump.type = DumpType(buffer[4]);
+    _dump.patternIndex = buffer[5];
+    _dump.nextRecord = 0;
+    _dump.stage = DumpStage::RecordBegin;
+    _dump.active = nextDumpRecord();
+    if (!_dump.active) {
+        // nothing to dump (pattern of a project without note or curve tracks)
+        _dump.active = true;
+        _dump.stage = DumpStage::DumpEnd;
+    }
+}
+
+void SysExTransfer::handleRecordBegin(MidiPort port, const SysExBuffer &buffer, size_t length) {
+    if (_dump.active || (_load.active && port != _load.port)) {
+        reply(port, Command::Nak, uint8_t(Command::RecordBegin), uint8_t(Error::Busy));
+        return;
+    }
+
+    // a new record discards an incomplete one
+    _load.active = false;
+
+    if (length != HeaderLength + 8) {
+        reply(port, Command::Nak, uint8_t(Command::RecordBegin), uint8_t(Error::InvalidMessage));
+        return;
+    }
+
+    Record record;
+    record.type = RecordType(buffer[4]);
+    record.track = buffer[5];
+    record.pattern = buffer[6];
+    record.size = decodeValue(buffer, 7, 3);
+
+    bool valid = record.size > 0 && (
+        record.type == RecordType::Properties ||
+        (record.type == RecordType::Sequence && record.track < CONFIG_TRACK_COUNT && record.pattern < PatternCount)
+    );
+    if (!valid) {
+        reply(port, Command::Nak, uint8_t(Command::RecordBegin), uint8_t(Error::InvalidRecord));
+        return;
+    }
+    if (record.size > RecordBufferSize) {
+        reply(port, Command::Nak, uint8_t(Command::RecordBegin), uint8_t(Error::RecordTooLarge));
+        return;
+    }
+
+    _load.active = true;
+    _load.port = port;
+    _load.record = record;
+    _load.received = 0;
+    _load.nextBlock = 0;
+
+    reply(port, Command::Ack, uint8_t(Command::RecordBegin), 0);
+}
+
+void SysExTransfer::handleBlock(MidiPort port, const SysExBuffer &buffer, size_t length) {
+    if (!_load.active || port != _load.port || length < HeaderLength + 3) {
+        reply(port, Command::Nak, uint8_t(Command::Block), uint8_t(Error::InvalidMessage));
+        return;
+    }
+
+    uint8_t block = buffer[4];
+    if (block != _load.nextBlock) {
+        _load.active = false;
+        reply(port, Command::Nak, uint8_t(Command::Block), uint8_t(Error::UnexpectedBlock));
+        return;
+    }
+
+    size_t decoded;
+    if (!decode(buffer, 5, length - 1, recordData() + _load.received, _load.record.size - _load.received, decoded)) {
+        _load.active = false;
+        reply(port, Command::Nak, uint8_t(Command::Block), uint8_t(Error::RecordTooLarge));
+        return;
+    }
+    _load.received += decoded;
+    _load.nextBlock = (_load.nextBlock + 1) & 0x7f;
+
+    reply(port, Command::Ack, uint8_t(Command::Block), block);
+}
+
+void SysExTransfer::handleRecordEnd(MidiPort port, const SysExBuffer &buffer, size_t length) {
+    if (!_load.active || port != _load.port || length != HeaderLength + 7) {
+        reply(port, Command::Nak, uint8_t(Command::RecordEnd), uint8_t(Error::InvalidMessage));
+        return;
+    }
+
+    _load.active = false;
+
+    FnvHash hash;
+    hash(recordData(), _load.received);
+    if (_load.received != _load.record.size || hash.result() != decodeValue(buffer, 4, 5)) {
+        reply(port, Command::Nak, uint8_t(Command::RecordEnd), uint8_t(Error::InvalidChecksum));
+        return;
+    }
+
+    if (!recordHashValid()) {
+        reply(port, Command::Nak, uint8_t(Command::RecordEnd), uint8_t(Error::InvalidRecord));
+        return;
+    }
+
+    // acknowledged once the ui task applied the record
+    _recordState.store(RecordState::Pending, std::memory_order_release);
+}
+
+void SysExTransfer::applyPendingRecord() {
+    if (recordPending()) {
+        _recordState.store(applyRecord() ? RecordState::Applied : RecordState::Failed, std::memory_order_release);
+    }
+}
+
+// the record ends with the hash of the serialized data following the version, it is checked before touching the
+// project as a failed read resets the project
+bool SysExTransfer::recordHashValid() const {
+    const auto *data = reinterpret_cast<const uint8_t *>(_recordData);
+    size_t size = _load.record.size;
+    if (size < 2 * sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t hash;
+    std::memcpy(&hash, &data[size - sizeof(hash)], sizeof(hash));
+    FnvHash dataHash;
+    dataHash(&data[sizeof(uint32_t)], size - 2 * sizeof(uint32_t));
+    return dataHash.result() == hash;
+}
+
+// runs in the ui task with the engine suspended, the engine picks up changed track modes when it is resumed
+bool SysExTransfer::applyRecord() {
+    RecordReader recordReader(recordData(), _load.record.size);
+    VersionedSerializedReader reader(recordReader, ProjectVersion::Latest);
+    if (reader.dataVersion() > ProjectVersion::Latest) {
+        return false;
+    }
+
+    switch (_load.record.type) {
+    case RecordType::Properties:
+        return _project.readProperties(reader);
+    case RecordType::Sequence:
+        return _project.readSequence(reader, _load.record.track, _load.record.pattern);
+    case RecordType::Profile:
+        break;
+    }
+
+    return false;
+}
+
+void SysExTransfer::sendDump() {
+    uint8_t message[HeaderLength + 1 + encodedLength(BlockSize)];
+
+    while (_dump.active) {
+        size_t length = 0;
+        message[length++] = ManufacturerId;
+        message[length++] = DeviceId;
+
+        const auto &record = _dump.record;
+        size_t blockSize = 0;
+
+        switch (_dump.stage) {
+        case DumpStage::RecordBegin:
+            message[length++] = uint8_t(Command::RecordBegin);
+            message[length++] = uint8_t(record.type);
+            message[length++] = record.track;
+            message[length++] = record.pattern;
+            length += encodeValue(record.size, 3, &message[length]);
+            break;
+        case DumpStage::Block:
+            blockSize = std::min(size_t(BlockSize), size_t(record.size - _dump.sent));
+            message[length++] = uint8_t(Command::Block);
+            message[length++] = _dump.nextBlock;
+            length += encode(recordData() + _dump.sent, blockSize, &message[length]);
+            break;
+        case DumpStage::RecordEnd:
+            message[length++] = uint8_t(Command::RecordEnd);
+            length += encodeValue(_dump.checksum, 5, &message[length]);
+            break;
+        case DumpStage::DumpEnd:
+            message[length++] = uint8_t(Command::DumpEnd);
+            break;
+        }
+
+        if (!send(_dump.port, message, length)) {
+            // port is busy, continue on the next update
+            return;
+        }
+
+        switch (_dump.stage) {
+        case DumpStage::RecordBegin:
+            _dump.sent = 0;
+            _dump.nextBlock = 0;
+            _dump.stage = DumpStage::Block;
+            break;
+        case DumpStage::Block:
+            _dump.sent += blockSize;
+            _dump.nextBlock = (_dump.nextBlock + 1) & 0x7f;
+            if (_dump.sent == record.size) {
+                _dump.stage = DumpStage::RecordEnd;
+            }
+            break;
+        case DumpStage::RecordEnd:
+            _dump.stage = nextDumpRecord() ? DumpStage::RecordBegin : DumpStage::DumpEnd;
+            break;
+        case DumpStage::DumpEnd:
+            _dump.active = false;
+            break;
+        }
+    }
+}
+
+// finds the next record of the dump and serializes it into the record buffer
+bool SysExTransfer::nextDumpRecord() {
+    int recordCount = 0;
+    switch (_dump.type) {
+    case DumpType::Project: recordCount = 1 + CONFIG_TRACK_COUNT * PatternCount; break;
+    case DumpType::Pattern: recordCount = CONFIG_TRACK_COUNT; break;
+    case DumpType::Profile: recordCount = 1; break;
+    }
+
+    while (_dump.nextRecord < recordCount) {
+        int index = _dump.nextRecord++;
+        auto &record = _dump.record;
+
+        if (_dump.type == DumpType::Profile) {
+            record = { RecordType::Profile, 0, 0, 0 };
+        } else if (_dump.type == DumpType::Pattern) {
+            record = { RecordType::Sequence, uint8_t(index), _dump.patternIndex, 0 };
+        } else if (index == 0) {
+            record = { RecordType::Properties, 0, 0, 0 };
+        } else {
+            index -= 1;
+            record = { RecordType::Sequence, uint8_t(index / PatternCount), uint8_t(index % PatternCount), 0 };
+        }
+
+        if (serializeRecord()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// the engine task preempts the ui task, ui edits do not end up half way in a record
+bool SysExTransfer::serializeRecord() {
+    auto &record = _dump.record;
+
+    RecordWriter recordWriter(recordData(), RecordBufferSize);
+    if (record.type == RecordType::Profile) {
+        writeProfile(recordWriter);
+    } else {
+        VersionedSerializedWriter writer(recordWriter, ProjectVersion::Latest);
+
+        switch (record.type) {
+        case RecordType::Properties:
+            _project.writeProperties(writer);
+            break;
+        case RecordType::Sequence:
+            if (!_project.writeSequence(writer, record.track, record.pattern)) {
+                // track without sequences
+                return false;
+            }
+            break;
+        case RecordType::Profile:
+            break;
+        }
+    }
+
+    if (recordWriter.overflow()) {
+        DBG("sysex transfer: record too large (type=%d, track=%d, pattern=%d)", int(record.type), record.track, record.pattern);
+        return false;
+    }
+
+    record.size = recordWriter.size();
+
+    FnvHash hash;
+    hash(recordData(), record.size);
+    _dump.checksum = hash.result();
+
+    return true;
+}
+
+void SysExTransfer::reply(MidiPort port, Command command, uint8_t value0, uint8_t value1) {
+    _reply.port = port;
+    _reply.data[0] = ManufacturerId;
+    _reply.data[1] = DeviceId;
+    _reply.data[2] = uint8_t(command);
+    _reply.data[3] = value0;
+    _reply.data[4] = value1;
+    _reply.length = 5;
+    sendPendingReply();
+}
+
+bool SysExTransfer::sendPendingReply() {
+    if (_reply.length > 0 && send(_reply.port, _reply.data, _reply.length)) {
+        _reply.length = 0;
+    }
+    return _reply.length == 0;
+}
+
+bool SysExTransfer::send(MidiPort port, const uint8_t *data, size_t length) {
+    switch (port) {
+    case MidiPort::Midi:
+        return _midi.sendSysEx(data, length);
+    case MidiPort::UsbMidi:
+        return _usbMidi.sendSysEx(0, data, length);
+    case MidiPort::CvGate:
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Config.h"
+#include "MidiPort.h"
+
+#include "model/Project.h"
+
+#include "drivers/Midi.h"
+#include "drivers/UsbMidi.h"
+
+#include "core/midi/SysExBuffer.h"
+
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+// Bulk transfer of projects and patterns over system exclusive messages on both MIDI ports.
+//
+// All messages have the form F0 7D 50 <command> <data> F7 (7D is the id for non-commercial use).
+// A project is transferred as a series of records, the same records the project journal is made of: the project
+// properties (everything except the sequences) and single sequences. A record is announced with RecordBegin,
+// followed by its data in Block messages (7 bytes are encoded in 8) and closed with RecordEnd, which carries a
+// checksum of the data.
+//
+// Dump: the host sends DumpRequest, the device replies with the records of the whole project, the sequences of
+// a single pattern or the profile record followed by DumpEnd. Dumps are sent as fast as the port takes them.
+// Load: the host sends records in the same format. Every message is acknowledged with Ack or rejected with Nak,
+// the host may send up to WindowSize messages ahead of the acknowledgements. A record is only applied once it was
+// received completely and its checksum matches. Records are received in the engine task and applied in the ui
+// task with the engine suspended, the RecordEnd acknowledgement is sent once the record was applied. A project load starts with the properties record, which sets up
+// the track modes for the sequence records that follow.
+//
+// Command        Data
+// DumpRequest    what (0 = project, 1 = pattern, 2 = profile), pattern
+// RecordBegin    type (0 = properties, 1 = sequence, 2 = profile), track, pattern, size (3 x 7 bit, lsb first)
+// Block          block number (counting from 0 for every record, 7 bit), encoded data (up to BlockSize bytes)
+// RecordEnd      checksum (fnv-1a of the data, 5 x 7 bit, lsb first)
+// DumpEnd        -
+// Ack            command, block number (0 for commands other than Block)
+// Nak            command, error
+//
+// The profile record (dump only) holds the profiler intervals and the tasks, all values are little endian:
+// interval count (8 bit), per interval: description (zero terminated), runs, min, avg, p99, max (us), overruns,
+// budget (us) (32 bit each); task count (8 bit), per task: name (zero terminated), priority, load (%) (8 bit each),
+// stack size, free stack (bytes) (16 bit each)
+class SysExTransfer {
+public:
+    static constexpr uint8_t ManufacturerId = 0x7d;
+    static constexpr uint8_t DeviceId = 0x50;
+
+    static constexpr size_t BlockSize = 64;
+    static constexpr size_t WindowSize = 4;
+    static constexpr size_t RecordBufferSize = 2048;
+
+    enum class Command : uint8_t {
+        DumpRequest = 1,
+        RecordBegin,
+        Block,
+        RecordEnd,
+        DumpEnd,
+        Ack,
+        Nak,
+    };
+
+    enum class Error : uint8_t {
+        InvalidMessage = 1,
+        InvalidRecord,
+        RecordTooLarge,
+        UnexpectedBlock,
+        InvalidChecksum,
+        Busy,
+    };
+
+    SysExTransfer(Project &project, Midi &midi, UsbMidi &usbMidi);
+
+    // handles received messages and sends the pending parts of a dump (engine task)
+    void update();
+
+    bool isActive() const { return _load.active || _dump.active; }
+
+    // a completely received record waits to be applied (ui task)
+    bool recordPending() const { return _recordState.load(std::memory_order_acquire) == RecordState::Pending; }
+    // applies the pending record to the project, the engine has to be suspended (ui task)
+    void applyPendingRecord();
+
+private:
+    enum class RecordType : uint8_t {
+        Properties,
+        Sequence,
+        Profile,
+    };
+
+    enum class DumpType : uint8_t {
+        Project,
+        Pattern,
+        Profile,
+    };
+
+    enum class RecordState : uint8_t {
+        None,
+        Pending,
+        Applied,
+        Failed,
+    };
+
+    struct Record {
+        RecordType type;
+        uint8_t track;
+        uint8_t pattern;
+        uint32_t size;
+    };
+
+    enum class DumpStage : uint8_t {
+        RecordBegin,
+        Block,
+        RecordEnd,
+        DumpEnd,
+    };
+
+    void receive(MidiPort port, SysExBuffer &buffer);
+    void handleMessage(MidiPort port, const SysExBuffer &buffer, size_t length);
+
+    void handleDumpRequest(MidiPort port, const SysExBuffer &buffer, size_t length);
+    void handleRecordBegin(MidiPort port, const SysExBuffer &buffer, size_t length);
+    void handleBlock(MidiPort port, const SysExBuffer &buffer, size_t length);
+    void handleRecordEnd(MidiPort port, const SysExBuffer &buffer, size_t length);
+
+    bool applyRecord();
+    bool recordHashValid() const;
+
+    void sendDump();
+    bool nextDumpRecord();
+    bool serializeRecord();
+
+    void reply(MidiPort port, Command command, uint8_t value0, uint8_t value1);
+    bool sendPendingReply();
+    bool send(MidiPort port, const uint8_t *data, size_t length);
+
+    uint8_t *recordData() { return reinterpret_cast<uint8_t *>(_recordData); }
+
+    Project &_project;
+    Midi &_midi;
+    UsbMidi &_usbMidi;
+
+    struct {
+        bool active = false;
+        MidiPort port;
+        Record record;
+        uint32_t received;
+        uint8_t nextBlock;
+    } _load;
+
+    struct {
+        bool active = false;
+        MidiPort port;
+        DumpType type;
+        uint8_t patternIndex;
+        int nextRecord;
+        DumpStage stage;
+        Record record;
+        uint32_t checksum;
+        uint32_t sent;
+        uint8_t nextBlock;
+    } _dump;
+
+    // a reply that could not be sent yet, received messages are only processed once it is out
+    struct {
+        MidiPort port;
+        uint8_t data[5];
+        uint8_t length = 0;
+    } _reply;
+
+    // hands a received record from the engine task to the ui task and the result back
+    std::atomic<RecordState> _recordState { RecordState::None };
+
+    // the data of the record currently loaded or dumped
+    uint32_t _recordData[RecordBufferSize / 4];
+};
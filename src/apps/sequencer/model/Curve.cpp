@@ -141,4 +141,205 @@ Curve::Function Curve::function(Type type) {
 
 float Curve::eval(Type type, float x) {
     return functions[type](x);
-}
\ No newline at end of file
+}
+
+//----------------------------------------
+// Fixed point
+//----------------------------------------
+
+static constexpr uint32_t FixedHalf = Curve::FixedOne / 2;
+
+static constexpr int TableBits = 8;
+static constexpr uint32_t TableSize = 1 << TableBits;
+static constexpr int FractionBits = 16 - TableBits;
+
+// TableSize + 1 samples of sqrt(x), x * x * (3 - 2 * x) and 0.5 - 0.5 * cos(x * 2 * pi) scaled to FixedMax
+static const uint16_t logTable[TableSize + 1] = {
+    0, 4096, 5793, 7094, 8192, 9159, 10033, 10837, 11585, 12288, 12952, 13585,
+    14189, 14768, 15326, 15863, 16384, 16888, 17378, 17854, 18318, 18770, 19212, 19643,
+    20066, 20480, 20885, 21283, 21674, 22057, 22434, 22805, 23170, 23529, 23883, 24232,
+    24576, 24915, 25249, 25579, 25905, 26227, 26545, 26859, 27169, 27476, 27780, 28080,
+    28377, 28672, 28963, 29251, 29536, 29819, 30099, 30376, 30651, 30924, 31194, 31461,
+    31727, 31990, 32251, 32510, 32768, 33023, 33276, 33527, 33776, 34023, 34269, 34513,
+    34755, 34996, 35235, 35472, 35708, 35942, 36174, 36405, 36635, 36863, 37090, 37316,
+    37540, 37763, 37984, 38204, 38423, 38641, 38857, 39073, 39287, 39500, 39712, 39922,
+    40132, 40340, 40548, 40754, 40959, 41164, 41367, 41569, 41771, 41971, 42170, 42369,
+    42566, 42763, 42959, 43153, 43347, 43540, 43733, 43924, 44115, 44304, 44493, 44681,
+    44869, 45055, 45241, 45426, 45610, 45794, 45977, 46159, 46340, 46521, 46701, 46880,
+    47059, 47237, 47414, 47590, 47766, 47942, 48116, 48290, 48464, 48637, 48809, 48980,
+    49151, 49322, 49491, 49661, 49829, 49997, 50165, 50332, 50498, 50664, 50829, 50994,
+    51158, 51322, 51485, 51648, 51810, 51972, 52133, 52293, 52454, 52613, 52772, 52931,
+    53089, 53247, 53404, 53561, 53718, 53874, 54029, 54184, 54339, 54493, 54647, 54800,
+    54953, 55105, 55257, 55409, 55560, 55711, 55861, 56011, 56161, 56310, 56459, 56607,
+    56755, 56903, 57050, 57197, 57343, 57489, 57635, 57780, 57925, 58070, 58214, 58358,
+    58502, 58645, 58788, 58930, 59072, 59214, 59356, 59497, 59638, 59778, 59918, 60058,
+    60198, 60337, 60476, 60614, 60753, 60890, 61028, 61165, 61302, 61439, 61575, 61712,
+    61847, 61983, 62118, 62253, 62387, 62522, 62656, 62790, 62923, 63056, 63189, 63322,
+    63454, 63586, 63718, 63849, 63981, 64112, 64242, 64373, 64503, 64633, 64762, 64892,
+    65021, 65150, 65279, 65407, 65535,
+};
+
+static const uint16_t smoothTable[TableSize + 1] = {
+    0, 3, 12, 27, 47, 74, 106, 144, 188, 237, 292, 353,
+    418, 490, 567, 649, 736, 829, 926, 1029, 1137, 1251, 1369, 1492,
+    1620, 1753, 1891, 2033, 2180, 2332, 2489, 2650, 2816, 2986, 3161, 3340,
+    3523, 3711, 3903, 4100, 4300, 4504, 4713, 4926, 5142, 5363, 5587, 5816,
+    6048, 6284, 6523, 6767, 7013, 7264, 7518, 7775, 8036, 8300, 8568, 8838,
+    9112, 9390, 9670, 9953, 10240, 10529, 10822, 11117, 11415, 11716, 12020, 12327,
+    12636, 12948, 13262, 13579, 13898, 14220, 14544, 14871, 15200, 15531, 15864, 16200,
+    16537, 16877, 17219, 17562, 17908, 18255, 18604, 18955, 19308, 19663, 20019, 20376,
+    20736, 21096, 21459, 21822, 22187, 22553, 22921, 23290, 23660, 24031, 24403, 24776,
+    25150, 25525, 25901, 26278, 26656, 27034, 27413, 27793, 28173, 28554, 28935, 29317,
+    29700, 30082, 30465, 30849, 31232, 31616, 32000, 32384, 32768, 33151, 33535, 33919,
+    34303, 34686, 35070, 35453, 35835, 36218, 36600, 36981, 37362, 37742, 38122, 38501,
+    38879, 39257, 39634, 40010, 40385, 40759, 41132, 41504, 41875, 42245, 42614, 42982,
+    43348, 43713, 44076, 44439, 44799, 45159, 45516, 45872, 46227, 46580, 46931, 47280,
+    47627, 47973, 48316, 48658, 48998, 49335, 49671, 50004, 50335, 50664, 50991, 51315,
+    51637, 51956, 52273, 52587, 52899, 53208, 53515, 53819, 54120, 54418, 54713, 55006,
+    55295, 55582, 55865, 56145, 56423, 56697, 56967, 57235, 57499, 57760, 58017, 58271,
+    58522, 58768, 59012, 59251, 59487, 59719, 59948, 60172, 60393, 60609, 60822, 61031,
+    61235, 61435, 61632, 61824, 62012, 62195, 62374, 62549, 62719, 62885, 63046, 63203,
+    63355, 63502, 63644, 63782, 63915, 64043, 64166, 64284, 64398, 64506, 64609, 64706,
+    64799, 64886, 64968, 65045, 65117, 65182, 65243, 65298, 65347, 65391, 65429, 65461,
+    65488, 65508, 65523, 65532, 65535,
+};
+
+static const uint16_t bellTable[TableSize + 1] = {
+    0, 10, 39, 89, 158, 246, 355, 482, 630, 796, 982, 1187,
+    1411, 1654, 1915, 2196, 2494, 2811, 3146, 3499, 3869, 4257, 4662, 5084,
+    5522, 5977, 6448, 6935, 7438, 7956, 8488, 9036, 9597, 10173, 10762, 11365,
+    11980, 12608, 13248, 13900, 14563, 15237, 15922, 16616, 17321, 18035, 18758, 19489,
+    20228, 20975, 21728, 22489, 23256, 24028, 24806, 25588, 26375, 27166, 27960, 28756,
+    29556, 30357, 31160, 31963, 32767, 33572, 34375, 35178, 35979, 36779, 37575, 38369,
+    39160, 39947, 40729, 41507, 42279, 43046, 43807, 44560, 45307, 46046, 46777, 47500,
+    48214, 48919, 49613, 50298, 50972, 51635, 52287, 52927, 53555, 54170, 54773, 55362,
+    55938, 56499, 57047, 57579, 58097, 58600, 59087, 59558, 60013, 60451, 60873, 61278,
+    61666, 62036, 62389, 62724, 63041, 63339, 63620, 63881, 64124, 64348, 64553, 64739,
+    64905, 65053, 65180, 65289, 65377, 65446, 65496, 65525, 65535, 65525, 65496, 65446,
+    65377, 65289, 65180, 65053, 64905, 64739, 64553, 64348, 64124, 63881, 63620, 63339,
+    63041, 62724, 62389, 62036, 61666, 61278, 60873, 60451, 60013, 59558, 59087, 58600,
+    58097, 57579, 57047, 56499, 55938, 55362, 54773, 54170, 53555, 52927, 52287, 51635,
+    50972, 50298, 49613, 48919, 48214, 47500, 46777, 46046, 45307, 44560, 43807, 43046,
+    42279, 41507, 40729, 39947, 39160, 38369, 37575, 36779, 35979, 35178, 34375, 33572,
+    32768, 31963, 31160, 30357, 29556, 28756, 27960, 27166, 26375, 25588, 24806, 24028,
+    23256, 22489, 21728, 20975, 20228, 19489, 18758, 18035, 17321, 16616, 15922, 15237,
+    14563, 13900, 13248, 12608, 11980, 11365, 10762, 10173, 9597, 9036, 8488, 7956,
+    7438, 6935, 6448, 5977, 5522, 5084, 4662, 4257, 3869, 3499, 3146, 2811,
+    2494, 2196, 1915, 1654, 1411, 1187, 982, 796, 630, 482, 355, 246,
+    158, 89, 39, 10, 0,
+};
+
+static uint32_t lookup(const uint16_t *table, uint32_t x) {
+    uint32_t index = x >> FractionBits;
+    if (index >= TableSize) {
+        return table[TableSize];
+    }
+    int32_t a = table[index];
+    int32_t b = table[index + 1];
+    int32_t fraction = x & ((1 << FractionBits) - 1);
+    return a + (((b - a) * fraction) >> FractionBits);
+}
+
+static uint32_t lowFixed(uint32_t x) {
+    return 0;
+}
+
+static uint32_t highFixed(uint32_t x) {
+    return Curve::FixedMax;
+}
+
+static uint32_t rampUpFixed(uint32_t x) {
+    return x - (x >> 16);
+}
+
+static uint32_t rampDownFixed(uint32_t x) {
+    return Curve::FixedMax - rampUpFixed(x);
+}
+
+static uint32_t expUpFixed(uint32_t x) {
+    uint32_t r = rampUpFixed(x);
+    return (r * r + r) >> 16;
+}
+
+static uint32_t expDownFixed(uint32_t x) {
+    return expUpFixed(Curve::FixedOne - x);
+}
+
+// sqrt is steep near zero, the first table segment is looked up scaled (sqrt(x) = sqrt(x * 256) / 16)
+static uint32_t logUpFixed(uint32_t x) {
+    return x < (1 << FractionBits) ? lookup(logTable, x << TableBits) >> (TableBits / 2) : lookup(logTable, x);
+}
+
+static uint32_t logDownFixed(uint32_t x) {
+    return logUpFixed(Curve::FixedOne - x);
+}
+
+static uint32_t smoothUpFixed(uint32_t x) {
+    return lookup(smoothTable, x);
+}
+
+static uint32_t smoothDownFixed(uint32_t x) {
+    return Curve::FixedMax - lookup(smoothTable, x);
+}
+
+template<uint32_t (*Function)(uint32_t)>
+static uint32_t halfFixed(uint32_t x) {
+    return x < FixedHalf ? Function(x * 2) : 0;
+}
+
+static uint32_t triangleFixed(uint32_t x) {
+    return rampUpFixed((x < FixedHalf ? x : Curve::FixedOne - x) * 2);
+}
+
+static uint32_t bellFixed(uint32_t x) {
+    return lookup(bellTable, x);
+}
+
+static uint32_t stepUpFixed(uint32_t x) {
+    return x < FixedHalf ? 0 : Curve::FixedMax;
+}
+
+static uint32_t stepDownFixed(uint32_t x) {
+    return x < FixedHalf ? Curve::FixedMax : 0;
+}
+
+template<uint32_t N>
+static uint32_t expDownNxFixed(uint32_t x) {
+    return x < Curve::FixedOne ? expDownFixed((x * N) & (Curve::FixedOne - 1)) : 0;
+}
+
+typedef uint32_t (*FixedFunction)(uint32_t x);
+
+static const FixedFunction fixedFunctions[] = {
+        &lowFixed,
+        &highFixed,
+        &rampUpFixed,
+        &rampDownFixed,
+        &expUpFixed,
+        &expDownFixed,
+        &logUpFixed,
+        &logDownFixed,
+        &smoothUpFixed,
+        &smoothDownFixed,
+        &halfFixed<rampUpFixed>,
+        &halfFixed<rampDownFixed>,
+        &halfFixed<expUpFixed>,
+        &halfFixed<expDownFixed>,
+        &halfFixed<logUpFixed>,
+        &halfFixed<logDownFixed>,
+        &halfFixed<smoothUpFixed>,
+        &halfFixed<smoothDownFixed>,
+        &triangleFixed,
+        &bellFixed,
+        &stepUpFixed,
+        &stepDownFixed,
+        &expDownNxFixed<2>,
+        &expDownNxFixed<3>,
+        &expDownNxFixed<4>,
+};
+
+static_assert(sizeof(fixedFunctions) / sizeof(fixedFunctions[0]) == Curve::Last, "missing fixed point shape");
+
+uint32_t Curve::evalFixed(Type type, uint32_t x) {
+    return fixedFunctions[type](x);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class Curve {
 public:
     typedef float (*Function)(float x);
@@ -36,4 +38,11 @@ public:
     static Function function(Type type);
 
     static float eval(Type type, float x);
+
+    // Fixed point evaluation used by the engine, avoids the float math (sqrt, fmod, cos) of the shape functions.
+    // x is in [0, FixedOne], the result in [0, FixedMax]. Non-linear shapes are looked up in precomputed tables.
+    static constexpr uint32_t FixedOne = 1 << 16;
+    static constexpr uint32_t FixedMax = 0xffff;
+
+    static uint32_t evalFixed(Type type, uint32_t x);
 };
@@ -105,6 +105,7 @@ void CurveSequence::Step::setLayerValue(Layer layer, int value) {
 void CurveSequence::Step::clear() {
     _data0.raw = 0;
     _data1.raw = 0;
+    _data2.raw = 0;
     setShape(0);
     setShapeVariation(0);
     setShapeVariationProbability(0);
@@ -117,6 +118,7 @@ void CurveSequence::Step::clear() {
 void CurveSequence::Step::write(VersionedSerializedWriter &writer) const {
     writer.write(_data0);
     writer.write(_data1);
+    writer.write(_data2);
 }
 
 void CurveSequence::Step::read(VersionedSerializedReader &reader) {
@@ -126,8 +128,8 @@ void CurveSequence::Step::read(VersionedSerializedReader &reader) {
         reader.read(min);
         reader.read(max);
         _data0.shape = shape;
-        _data0.min = min;
-        _data0.max = max;
+        _data1.min = min;
+        _data1.max = max;
 
         if (reader.dataVersion() < ProjectVersion::Version14) {
             if (_data0.shape <= 1) {
@@ -137,6 +139,7 @@ void CurveSequence::Step::read(VersionedSerializedReader &reader) {
     } else {
         reader.read(_data0);
         reader.read(_data1);
+        reader.read(_data2);
     }
 }
 
@@ -216,7 +219,8 @@ void CurveSequence::write(VersionedSerializedWriter &writer) const {
     writer.write(_firstStep.base);
     writer.write(_lastStep.base);
 
-    writeArray(writer, _steps);
+    // the packed step layout matches the serialized layout, write all steps as one block
+    writer.write(_steps.data(), sizeof(Step) * _steps.size());
 }
 
 void CurveSequence::read(VersionedSerializedReader &reader) {
@@ -231,5 +235,9 @@ void CurveSequence::read(VersionedSerializedReader &reader) {
     reader.read(_firstStep.base);
     reader.read(_lastStep.base);
 
-    readArray(reader, _steps);
+    if (reader.dataVersion() < ProjectVersion::Version15) {
+        readArray(reader, _steps);
+    } else {
+        reader.read(_steps.data(), sizeof(Step) * _steps.size(), 0);
+    }
 }
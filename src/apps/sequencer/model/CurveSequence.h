@@ -86,10 +86,10 @@ public:
 
         // min
 
-        int min() const { return _data0.min; }
+        int min() const { return _data1.min; }
         void setMin(int min) {
-            _data0.min = Min::clamp(min);
-            _data0.max = std::max(max(), this->min());
+            _data1.min = Min::clamp(min);
+            _data1.max = std::max(max(), this->min());
         }
 
         float minNormalized() const { return float(min()) / Min::Max; }
@@ -99,10 +99,10 @@ public:
 
         // max
 
-        int max() const { return _data0.max; }
+        int max() const { return _data1.max; }
         void setMax(int max) {
-            _data0.max = Max::clamp(max);
-            _data0.min = std::min(min(), this->max());
+            _data1.max = Max::clamp(max);
+            _data1.min = std::min(min(), this->max());
         }
 
         float maxNormalized() const { return float(max()) / Max::Max; }
@@ -112,16 +112,16 @@ public:
 
         // gate
 
-        int gate() const { return _data1.gate; }
+        int gate() const { return _data2.gate; }
         void setGate(int gate) {
-            _data1.gate = Gate::clamp(gate);
+            _data2.gate = Gate::clamp(gate);
         }
 
         // gateProbability
 
-        int gateProbability() const { return _data1.gateProbability; }
+        int gateProbability() const { return _data2.gateProbability; }
         void setGateProbability(int gateProbability) {
-            _data1.gateProbability = GateProbability::clamp(gateProbability);
+            _data2.gateProbability = GateProbability::clamp(gateProbability);
         }
 
         int layerValue(Layer layer) const;
@@ -139,7 +139,7 @@ public:
         void read(VersionedSerializedReader &reader);
 
         bool operator==(const Step &other) const {
-            return _data0.raw == other._data0.raw;
+            return _data0.raw == other._data0.raw && _data1.raw == other._data1.raw;
         }
 
         bool operator!=(const Step &other) const {
@@ -147,22 +147,29 @@ public:
         }
 
     private:
+        // steps are packed into 3 x 16 bit words to keep the pattern memory footprint small
+        // (_data0/_data1 are serialized back to back, matching the original 32 bit layout)
         union {
-            uint32_t raw;
-            BitField<uint32_t, 0, Shape::Bits> shape;
-            BitField<uint32_t, 6, Shape::Bits> shapeVariation;
-            BitField<uint32_t, 12, ShapeVariationProbability::Bits> shapeVariationProbability;
-            BitField<uint32_t, 16, Min::Bits> min;
-            BitField<uint32_t, 24, Max::Bits> max;
+            uint16_t raw;
+            BitField<uint16_t, 0, Shape::Bits> shape;
+            BitField<uint16_t, 6, Shape::Bits> shapeVariation;
+            BitField<uint16_t, 12, ShapeVariationProbability::Bits> shapeVariationProbability;
         } _data0;
+        union {
+            uint16_t raw;
+            BitField<uint16_t, 0, Min::Bits> min;
+            BitField<uint16_t, 8, Max::Bits> max;
+        } _data1;
         union {
             uint16_t raw;
             BitField<uint16_t, 0, Gate::Bits> gate;
             BitField<uint16_t, 4, GateProbability::Bits> gateProbability;
             // 9 bits left
-        } _data1;
+        } _data2;
     };
 
+    static_assert(sizeof(Step) == 6, "CurveSequence::Step must be 6 bytes");
+
     using StepArray = std::array<Step, CONFIG_STEP_COUNT>;
 
     //----------------------------------------
@@ -1,6 +1,8 @@
 #include "FileManager.h"
 #include "ProjectVersion.h"
 
+#include "core/Debug.h"
+#include "core/hash/FnvHash.h"
 #include "core/utils/StringBuilder.h"
 #include "core/fs/FileSystem.h"
 #include "core/fs/FileWriter.h"
@@ -22,6 +24,12 @@ FileManager::TaskExecuteCallback FileManager::_taskExecuteCallback;
 FileManager::TaskResultCallback FileManager::_taskResultCallback;
 volatile uint32_t FileManager::_taskPending;
 
+ProjectDirtyState FileManager::_dirtyState;
+int FileManager::_savedSlot = -1;
+uint32_t FileManager::_baseHash = 0;
+int FileManager::_journalRecords = 0;
+uint32_t FileManager::_nextAutosaveTicks = 0;
+
 struct FileTypeInfo {
     const char *dir;
     const char *ext;
@@ -37,6 +45,247 @@ static void slotPath(StringBuilder &str, FileType type, int slot) {
     str("%s/%03d.%s", info.dir, slot + 1, info.ext);
 }
 
+// files next to a project slot: journal (DLT), new project while saving (TMP), previous project while saving (BAK)
+static void projectSlotPath(StringBuilder &str, int slot, const char *ext) {
+    str("%s/%03d.%s", fileTypeInfos[int(FileType::Project)].dir, slot + 1, ext);
+}
+
+static void journalPath(StringBuilder &str, int slot) {
+    projectSlotPath(str, slot, "DLT");
+}
+
+// Buffer for project files, used as a double buffer of two 1 KB halves, so one half is transferred to or from the sd
+// card while the other one is filled or consumed. File operations only run on the file task one at a time, so a
+// single buffer is shared. Not in CCM memory, the sd card dma cannot access it.
+static uint32_t projectFileBuffer[2048 / 4];
+
+// Staging buffer of the snapshot writer, holds the largest part written between two checkpoints (a curve
+// sequence is about 800 bytes). Only used by the file task.
+static uint8_t snapshotBuffer[1024];
+
+// Serializes the model into a staging buffer while task switching is suspended. The buffer is only written to
+// the file (with task switching enabled) at checkpoints, so every part between two checkpoints (each sequence,
+// route, song slot, user scale, journal record) is a consistent copy even though engine and ui keep running.
+// Parts are not consistent with each other, i.e. the project properties written around the sequences can mix
+// edits made during the save. The dirty state is taken before saving, so such edits are saved again next time.
+// Parts larger than the staging buffer are written in pieces. The clock timer and all other interrupts are
+// never blocked.
+class SnapshotWriter {
+public:
+    SnapshotWriter(fs::FileWriter &fileWriter) :
+        _fileWriter(fileWriter)
+    {
+        os::suspendScheduler();
+    }
+
+    ~SnapshotWriter() {
+        finish();
+    }
+
+    void write(const void *data, size_t len) {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        _hash(data, len);
+        while (len > 0) {
+            size_t chunk = std::min(len, sizeof(snapshotBuffer) - _pos);
+            std::memcpy(&snapshotBuffer[_pos], src, chunk);
+            _pos += chunk;
+            src += chunk;
+            len -= chunk;
+            if (_pos == sizeof(snapshotBuffer)) {
+                checkpoint();
+            }
+        }
+    }
+
+    void checkpoint() {
+        if (!_finished) {
+            flush();
+            os::suspendScheduler();
+        }
+    }
+
+    void finish() {
+        if (!_finished) {
+            flush();
+            _finished = true;
+        }
+    }
+
+    uint32_t hash() const { return _hash.result(); }
+
+private:
+    void flush() {
+        os::resumeScheduler();
+        _fileWriter.write(snapshotBuffer, _pos);
+        _pos = 0;
+    }
+
+    fs::FileWriter &_fileWriter;
+    size_t _pos = 0;
+    bool _finished = false;
+    FnvHash _hash;
+};
+
+// Hashes all bytes read from a file, including the parts a serialized reader does not hash itself.
+class HashingFileReader {
+public:
+    HashingFileReader(fs::FileReader &fileReader, FnvHash &hash) :
+        _fileReader(fileReader),
+        _hash(hash)
+    {}
+
+    void read(void *data, size_t len) {
+        _fileReader.read(data, len);
+        _hash(data, len);
+    }
+
+private:
+    fs::FileReader &_fileReader;
+    FnvHash &_hash;
+};
+
+// The journal next to a project file holds the parts of the project that changed since the project file
+// was written. Records are only ever appended, each record is followed by a checksum of its data. A record
+// that was not written completely fails its checksum and ends the journal. The journal belongs to the project file with the matching hash.
+struct JournalHeader {
+    static constexpr uint32_t Magic = 0x544c4450; // PDLT
+
+    uint32_t magic;
+    uint32_t baseHash;
+};
+
+struct JournalRecord {
+    enum class Type : uint8_t {
+        Properties,
+        Sequence,
+    };
+
+    Type type;
+    uint8_t track;
+    uint8_t pattern;
+    uint8_t reserved;
+    // size of the serialized data following the record (excluding the checksum)
+    uint32_t size;
+};
+
+static_assert(sizeof(JournalHeader) == 8, "invalid journal header size");
+static_assert(sizeof(JournalRecord) == 8, "invalid journal record size");
+
+class JournalFileReader {
+public:
+    JournalFileReader(fs::File &file) :
+        _file(file)
+    {}
+
+    void read(void *data, size_t len) {
+        size_t lenRead;
+        if (_file.read(data, len, &lenRead) != fs::OK || lenRead != len) {
+            std::memset(data, 0, len);
+        }
+    }
+
+private:
+    fs::File &_file;
+};
+
+struct ByteCounter {
+    uint32_t count = 0;
+
+    void write(const void *data, size_t len) {
+        count += len;
+    }
+};
+
+// The serialized data contains nested hashes (user scales), so the checksum is taken over the raw bytes.
+// It is computed while writing, the project may change between counting and writing a record.
+template<typename Writer>
+class ChecksumWriter {
+public:
+    ChecksumWriter(Writer &writer) :
+        _writer(writer)
+    {}
+
+    void write(const void *data, size_t len) {
+        _hash(data, len);
+        _writer.write(data, len);
+    }
+
+    void checkpoint() {
+        _writer.checkpoint();
+    }
+
+    uint32_t checksum() const { return _hash.result(); }
+
+private:
+    Writer &_writer;
+    FnvHash _hash;
+};
+
+template<typename Writer>
+static void writeJournalRecordData(Writer &writer, const Project &project, const JournalRecord &record) {
+    VersionedSerializedWriter serializedWriter(writer, ProjectVersion::Latest);
+
+    if (record.type == JournalRecord::Type::Properties) {
+        project.writeProperties(serializedWriter);
+        return;
+    }
+
+    project.writeSequence(serializedWriter, record.track, record.pattern);
+}
+
+static bool readJournalRecordData(fs::File &file, Project &project, const JournalRecord &record) {
+    JournalFileReader journalReader(file);
+    VersionedSerializedReader reader(journalReader, ProjectVersion::Latest);
+
+    if (record.type == JournalRecord::Type::Properties) {
+        return project.readProperties(reader);
+    }
+
+    if (record.type != JournalRecord::Type::Sequence) {
+        return false;
+    }
+
+    return project.readSequence(reader, record.track, record.pattern);
+}
+
+// checks the checksum of a record without touching the project (the file is left after the checksum)
+static bool validJournalRecordData(fs::File &file, const JournalRecord &record) {
+    if (file.tell() + record.size + sizeof(uint32_t) > file.size()) {
+        return false;
+    }
+
+    JournalFileReader journalReader(file);
+    FnvHash hash;
+    uint8_t buffer[64];
+    for (size_t left = record.size; left > 0; ) {
+        size_t len = std::min(left, sizeof(buffer));
+        journalReader.read(buffer, len);
+        hash(buffer, len);
+        left -= len;
+    }
+
+    uint32_t checksum;
+    journalReader.read(&checksum, sizeof(checksum));
+    return hash.result() == checksum;
+}
+
+// Track modes and the slot identify the structure of a project, a save is discarded if they change while it is running.
+struct ProjectLayout {
+    int slot;
+    std::array<Track::TrackMode, CONFIG_TRACK_COUNT> trackModes;
+
+    ProjectLayout(const Project &project) {
+        slot = project.slot();
+        for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
+            trackModes[i] = project.track(i).trackMode();
+        }
+    }
+
+    bool operator==(const ProjectLayout &other) const {
+        return slot == other.slot && trackModes == other.trackModes;
+    }
+};
+
 void FileManager::init() {
     _volumeState = 0;
     _nextVolumeStateCheckTicks = 0;
@@ -55,12 +304,13 @@ bool FileManager::volumeMounted() {
 
 fs::Error FileManager::format() {
     invalidateAllSlots();
+    _dirtyState.invalidate();
     return fs::volume().format();
 }
 
 fs::Error FileManager::writeProject(Project &project, int slot) {
     return writeFile(FileType::Project, slot, [&] (const char *path) {
-        auto result = writeProject(project, path);
+        auto result = saveProject(project, slot, path);
         if (result == fs::OK) {
             project.setSlot(slot);
             writeLastProject(slot);
@@ -71,7 +321,25 @@ fs::Error FileManager::writeProject(Project &project, int slot) {
 
 fs::Error FileManager::readProject(Project &project, int slot) {
     return readFile(FileType::Project, slot, [&] (const char *path) {
-        auto result = readProject(project, path);
+        uint32_t hash;
+        bool latest;
+        auto result = readProjectBase(project, path, hash, latest);
+        if (result != fs::OK && !fs::exists(path)) {
+            result = recoverProject(project, slot, path, hash, latest);
+        }
+        int records = result == fs::OK ? readJournal(project, slot, hash) : -1;
+
+        // older project versions are converted and saved again, a damaged journal is compacted on the next save
+        _dirtyState.invalidate();
+        _savedSlot = -1;
+        if (latest && records >= 0) {
+            _dirtyState.update(project);
+            _dirtyState.commit();
+            _savedSlot = slot;
+            _baseHash = hash;
+            _journalRecords = records;
+        }
+
         if (result == fs::OK) {
             project.setSlot(slot);
             writeLastProject(slot);
@@ -106,37 +374,55 @@ fs::Error FileManager::readUserScale(UserScale &userScale, int slot) {
 }
 
 fs::Error FileManager::writeProject(const Project &project, const char *path) {
-    fs::FileWriter fileWriter(path);
+    uint32_t hash;
+    return writeProjectSnapshot(project, path, hash);
+}
+
+fs::Error FileManager::writeProjectSnapshot(const Project &project, const char *path, uint32_t &hash) {
+    fs::FileWriter fileWriter(path, fs::File::Write, projectFileBuffer, sizeof(projectFileBuffer));
     if (fileWriter.error() != fs::OK) {
         return fileWriter.error();
     }
 
-    FileHeader header(FileType::Project, 0, project.name());
-    fileWriter.write(&header, sizeof(header));
+    {
+        SnapshotWriter snapshotWriter(fileWriter);
+
+        FileHeader header(FileType::Project, 0, project.name());
+        snapshotWriter.write(&header, sizeof(header));
 
-    VersionedSerializedWriter writer(
-        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        ProjectVersion::Latest
-    );
+        VersionedSerializedWriter writer(snapshotWriter, ProjectVersion::Latest);
 
-    project.write(writer);
+        project.write(writer);
+
+        snapshotWriter.finish();
+        hash = snapshotWriter.hash();
+    }
 
     return fileWriter.finish();
 }
 
 fs::Error FileManager::readProject(Project &project, const char *path) {
-    fs::FileReader fileReader(path);
+    uint32_t hash;
+    bool latest;
+    return readProjectBase(project, path, hash, latest);
+}
+
+fs::Error FileManager::readProjectBase(Project &project, const char *path, uint32_t &hash, bool &latest) {
+    latest = false;
+
+    fs::FileReader fileReader(path, projectFileBuffer, sizeof(projectFileBuffer));
     if (fileReader.error() != fs::OK) {
         return fileReader.error();
     }
 
+    FnvHash fileHash;
+
     FileHeader header;
     fileReader.read(&header, sizeof(header));
+    fileHash(&header, sizeof(header));
 
-    VersionedSerializedReader reader(
-        [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
-        ProjectVersion::Latest
-    );
+    HashingFileReader hashingReader(fileReader, fileHash);
+    VersionedSerializedReader reader(hashingReader, ProjectVersion::Latest);
 
     bool success = project.read(reader);
 
@@ -145,9 +431,36 @@ fs::Error FileManager::readProject(Project &project, const char *path) {
         error = fs::INVALID_CHECKSUM;
     }
 
+    hash = fileHash.result();
+    latest = error == fs::OK && reader.dataVersion() == ProjectVersion::Latest;
+
     return error;
 }
 
+// A save interrupted after moving the old project file aside leaves the new project in the temporary file and
+// the old one in the backup file. The first one that reads completely is moved back into the slot, the journal
+// is only applied if it belongs to the restored file.
+fs::Error FileManager::recoverProject(Project &project, int slot, const char *path, uint32_t &hash, bool &latest) {
+    fs::Error result = fs::NO_FILE;
+
+    for (const char *ext : { "TMP", "BAK" }) {
+        FixedStringBuilder<32> candidate;
+        projectSlotPath(candidate, slot, ext);
+        if (!fs::exists(candidate)) {
+            continue;
+        }
+        result = readProjectBase(project, candidate, hash, latest);
+        if (result == fs::OK) {
+            DBG("recovered slot %d from %s", slot + 1, (const char *)(candidate));
+            result = fs::rename(candidate, path);
+            invalidateSlot(FileType::Project, slot);
+            break;
+        }
+    }
+
+    return result;
+}
+
 fs::Error FileManager::writeUserScale(const UserScale &userScale, const char *path) {
     fs::FileWriter fileWriter(path);
     if (fileWriter.error() != fs::OK) {
@@ -157,10 +470,7 @@ fs::Error FileManager::writeUserScale(const UserScale &userScale, const char *pa
     FileHeader header(FileType::UserScale, 0, userScale.name());
     fileWriter.write(&header, sizeof(header));
 
-    VersionedSerializedWriter writer(
-        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        ProjectVersion::Latest
-    );
+    VersionedSerializedWriter writer(fileWriter, ProjectVersion::Latest);
 
     userScale.write(writer);
 
@@ -176,10 +486,7 @@ fs::Error FileManager::readUserScale(UserScale &userScale, const char *path) {
     FileHeader header;
     fileReader.read(&header, sizeof(header));
 
-    VersionedSerializedReader reader(
-        [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
-        ProjectVersion::Latest
-    );
+    VersionedSerializedReader reader(fileReader, ProjectVersion::Latest);
 
     bool success = userScale.read(reader);
 
@@ -200,10 +507,7 @@ fs::Error FileManager::writeSettings(const Settings &settings, const char *path)
     FileHeader header(FileType::Settings, 0, "SETTINGS");
     fileWriter.write(&header, sizeof(header));
 
-    VersionedSerializedWriter writer(
-        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        Settings::Version
-    );
+    VersionedSerializedWriter writer(fileWriter, Settings::Version);
 
     settings.write(writer);
 
@@ -219,10 +523,7 @@ fs::Error FileManager::readSettings(Settings &settings, const char *path) {
     FileHeader header;
     fileReader.read(&header, sizeof(header));
 
-    VersionedSerializedReader reader(
-        [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
-        Settings::Version
-    );
+    VersionedSerializedReader reader(fileReader, Settings::Version);
 
     bool success = settings.read(reader);
 
@@ -244,6 +545,17 @@ void FileManager::slotInfo(FileType type, int slot, SlotInfo &info) {
     FixedStringBuilder<32> path;
     slotPath(path, type, slot);
 
+    // show a project that is restored from an interrupted save when loading the slot
+    if (type == FileType::Project && !fs::exists(path)) {
+        for (const char *ext : { "TMP", "BAK" }) {
+            path.reset();
+            projectSlotPath(path, slot, ext);
+            if (fs::exists(path)) {
+                break;
+            }
+        }
+    }
+
     if (fs::exists(path)) {
         fs::File file(path, fs::File::Read);
         FileHeader header;
@@ -284,6 +596,7 @@ void FileManager::processTask() {
             }
         } else {
             invalidateAllSlots();
+            _dirtyState.invalidate();
         }
 
         _volumeState = newVolumeState;
@@ -297,6 +610,198 @@ void FileManager::processTask() {
 }
 
 
+void FileManager::autosave(const Project &project, uint32_t interval) {
+    uint32_t ticks = os::ticks();
+    if (interval == 0 || int32_t(ticks - _nextAutosaveTicks) < 0) {
+        return;
+    }
+    _nextAutosaveTicks = ticks + os::time::ms(interval);
+
+    // auto loaded projects need to be saved manually first (same as SAVE in the project page)
+    if (!volumeMounted() || !project.slotAssigned() || project.autoLoaded()) {
+        return;
+    }
+
+    int slot = project.slot();
+    auto result = writeFile(FileType::Project, slot, [&] (const char *path) {
+        return saveProject(project, slot, path);
+    });
+
+    DBG("autosave slot %d: %s", slot + 1, fs::errorToString(result));
+}
+
+fs::Error FileManager::saveProject(const Project &project, int slot, const char *path) {
+    _dirtyState.update(project);
+
+    if (slot == _savedSlot && !_dirtyState.dirty()) {
+        return fs::OK;
+    }
+
+    // append the changed parts to the journal, compact the journal into a new project file when it gets too long
+    // or the track modes changed (sequences of a different type cannot be applied to the project file)
+    int records = (_dirtyState.propertiesDirty() ? 1 : 0) + _dirtyState.dirtySequenceCount();
+    if (slot == _savedSlot && _dirtyState.valid() && !_dirtyState.layoutDirty() && _journalRecords + records <= MaxJournalRecords) {
+        ProjectLayout layout(project);
+        auto result = appendJournal(project, slot);
+        if (result == fs::OK && ProjectLayout(project) == layout) {
+            _dirtyState.commit();
+            _journalRecords += records;
+            return fs::OK;
+        }
+        // the journal might end with a partial record now, nothing can be appended anymore
+        DBG("journal slot %d: %s", slot + 1, fs::errorToString(result));
+    }
+
+    return writeProjectCompacted(project, slot, path);
+}
+
+fs::Error FileManager::writeProjectCompacted(const Project &project, int slot, const char *path) {
+    _dirtyState.invalidate();
+    _savedSlot = -1;
+
+    ProjectLayout layout(project);
+
+    // Write to a temporary file first, then move the old project file aside before moving the new one in place.
+    // There is always a complete project in the slot, the temporary or the backup file (see recoverProject).
+    FixedStringBuilder<32> tmpPath;
+    FixedStringBuilder<32> backupPath;
+    projectSlotPath(tmpPath, slot, "TMP");
+    projectSlotPath(backupPath, slot, "BAK");
+
+    uint32_t hash;
+    auto result = writeProjectSnapshot(project, tmpPath, hash);
+    if (result == fs::OK && !(ProjectLayout(project) == layout)) {
+        result = fs::INVALID_PARAMETER;
+    }
+    if (result != fs::OK) {
+        fs::remove(tmpPath);
+        return result;
+    }
+
+    if (fs::exists(path)) {
+        fs::remove(backupPath);
+        result = fs::rename(path, backupPath);
+        if (result != fs::OK) {
+            fs::remove(tmpPath);
+            return result;
+        }
+    }
+
+    result = fs::rename(tmpPath, path);
+    if (result != fs::OK) {
+        // keep the new project in the temporary file, put the old one back if possible
+        fs::rename(backupPath, path);
+        return result;
+    }
+
+    fs::remove(backupPath);
+
+    // the old journal belongs to the old project file, remove it anyway to free the space
+    FixedStringBuilder<32> journal;
+    journalPath(journal, slot);
+    fs::remove(journal);
+
+    _dirtyState.commit();
+    _savedSlot = slot;
+    _baseHash = hash;
+    _journalRecords = 0;
+
+    return fs::OK;
+}
+
+fs::Error FileManager::appendJournal(const Project &project, int slot) {
+    FixedStringBuilder<32> path;
+    journalPath(path, slot);
+
+    bool create = _journalRecords == 0;
+    fs::FileWriter fileWriter(path, create ? fs::File::Write : fs::File::Append, projectFileBuffer, sizeof(projectFileBuffer));
+    if (fileWriter.error() != fs::OK) {
+        return fileWriter.error();
+    }
+
+    {
+        SnapshotWriter snapshotWriter(fileWriter);
+
+        if (create) {
+            JournalHeader header = { JournalHeader::Magic, _baseHash };
+            snapshotWriter.write(&header, sizeof(header));
+        }
+
+        auto writeRecord = [&] (JournalRecord::Type type, int track, int pattern) {
+            JournalRecord record = { type, uint8_t(track), uint8_t(pattern), 0, 0 };
+            ByteCounter counter;
+            writeJournalRecordData(counter, project, record);
+            record.size = counter.count;
+            snapshotWriter.write(&record, sizeof(record));
+            ChecksumWriter<SnapshotWriter> checksumWriter(snapshotWriter);
+            writeJournalRecordData(checksumWriter, project, record);
+            uint32_t checksum = checksumWriter.checksum();
+            snapshotWriter.write(&checksum, sizeof(checksum));
+            snapshotWriter.checkpoint();
+        };
+
+        if (_dirtyState.propertiesDirty()) {
+            writeRecord(JournalRecord::Type::Properties, 0, 0);
+        }
+        for (int track = 0; track < CONFIG_TRACK_COUNT; ++track) {
+            for (int pattern = 0; pattern < ProjectDirtyState::PatternCount; ++pattern) {
+                if (_dirtyState.sequenceDirty(track, pattern)) {
+                    writeRecord(JournalRecord::Type::Sequence, track, pattern);
+                }
+            }
+        }
+
+        snapshotWriter.finish();
+    }
+
+    return fileWriter.finish();
+}
+
+int FileManager::readJournal(Project &project, int slot, uint32_t baseHash) {
+    FixedStringBuilder<32> path;
+    journalPath(path, slot);
+
+    if (!fs::exists(path)) {
+        return 0;
+    }
+
+    fs::File file(path, fs::File::Read);
+    if (file.error() != fs::OK) {
+        return -1;
+    }
+
+    // a journal left over from an older project file is ignored and replaced on the next save
+    JournalHeader header;
+    size_t lenRead;
+    if (file.read(&header, sizeof(header), &lenRead) != fs::OK || lenRead != sizeof(header) ||
+        header.magic != JournalHeader::Magic || header.baseHash != baseHash) {
+        return 0;
+    }
+
+    int records = 0;
+    while (file.tell() < file.size()) {
+        JournalRecord record;
+        if (file.read(&record, sizeof(record), &lenRead) != fs::OK || lenRead != sizeof(record)) {
+            return -1;
+        }
+
+        size_t start = file.tell();
+        if (!validJournalRecordData(file, record)) {
+            DBG("journal slot %d: invalid record %d", slot + 1, records);
+            return -1;
+        }
+        file.seek(start);
+        if (!readJournalRecordData(file, project, record)) {
+            return -1;
+        }
+        file.seek(start + record.size + sizeof(uint32_t));
+
+        ++records;
+    }
+
+    return records;
+}
+
 fs::Error FileManager::writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write) {
     const auto &info = fileTypeInfos[int(type)];
     if (!fs::exists(info.dir)) {
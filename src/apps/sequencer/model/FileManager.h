@@ -2,6 +2,7 @@
 
 #include "FileDefs.h"
 #include "Project.h"
+#include "ProjectDirtyState.h"
 #include "UserScale.h"
 #include "Settings.h"
 
@@ -55,10 +56,30 @@ public:
     static void task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback);
     static void processTask();
 
+    // Autosave
+
+    // writes the project back to its slot if it changed since it was last saved or loaded (file task)
+    static void autosave(const Project &project, uint32_t interval);
+
 private:
+    // number of journal records before the journal is compacted into a new project file
+    static constexpr int MaxJournalRecords = 64;
+
     static fs::Error writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write);
     static fs::Error readFile(FileType type, int slot, std::function<fs::Error(const char *)> read);
 
+    static fs::Error writeProjectSnapshot(const Project &project, const char *path, uint32_t &hash);
+    static fs::Error readProjectBase(Project &project, const char *path, uint32_t &hash, bool &latest);
+    // restores a missing project file from the files left behind by an interrupted save
+    static fs::Error recoverProject(Project &project, int slot, const char *path, uint32_t &hash, bool &latest);
+
+    // incremental saves, only the parts that changed since the last save are appended to a journal
+    static fs::Error saveProject(const Project &project, int slot, const char *path);
+    static fs::Error writeProjectCompacted(const Project &project, int slot, const char *path);
+    static fs::Error appendJournal(const Project &project, int slot);
+    // applies the journal of a slot, returns the number of records or -1 if the journal is damaged
+    static int readJournal(Project &project, int slot, uint32_t baseHash);
+
     static fs::Error writeLastProject(int slot);
     static fs::Error readLastProject(int &slot);
 
@@ -93,4 +114,10 @@ private:
     static TaskExecuteCallback _taskExecuteCallback;
     static TaskResultCallback _taskResultCallback;
     static volatile uint32_t _taskPending;
+
+    static ProjectDirtyState _dirtyState;
+    static int _savedSlot;
+    static uint32_t _baseHash;
+    static int _journalRecords;
+    static uint32_t _nextAutosaveTicks;
 };
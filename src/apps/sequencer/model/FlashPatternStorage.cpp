@@ -1,315 +1,340 @@
 #include "FlashPatternStorage.h"
-#include "Serialize.h"
+#include "FlashReader.h"
+#include "FlashWriter.h"
 #include "ProjectVersion.h"
 
-#include <libopencm3/stm32/flash.h>
+#include "core/Debug.h"
 
-// CRC32 implementation for checksum validation
-static uint32_t crc32_table[256];
-static bool crc32_table_initialized = false;
+#include <algorithm>
 
-static void init_crc32_table() {
-    if (crc32_table_initialized) return;
+void FlashPatternStorage::init() {
+    _head = -1;
+    _headOffset = 0;
+    _nextSequence = 0;
+    _used.fill(0);
 
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (uint32_t j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    for (int sector = 0; sector < Sectors; ++sector) {
+        SectorHeader header;
+        Flash::read(sectorAddress(sector), &header, sizeof(header));
+        _sectorSequences[sector] = header.sequence;
+        if (header.magic == SectorMagic && header.sequence != Erased) {
+            _sectorStates[sector] = SectorState::Valid;
+            _nextSequence = std::max(_nextSequence, header.sequence + 1);
+            continue;
         }
-        crc32_table[i] = crc;
-    }
-    crc32_table_initialized = true;
-}
-
-uint32_t FlashPatternStorage::calculateChecksum(const void* data, size_t length) {
-    init_crc32_table();
 
-    uint32_t crc = 0xFFFFFFFF;
-    const uint8_t* bytes = static_cast<const uint8_t*>(data);
-
-    for (size_t i = 0; i < length; i++) {
-        crc = (crc >> 8) ^ crc32_table[(crc ^ bytes[i]) & 0xFF];
+        // sectors with leftovers (i.e. from an interrupted format) need to be erased before use
+        _sectorStates[sector] = SectorState::Blank;
+        for (uint32_t offset = 0; offset < SectorSize; offset += sizeof(uint32_t)) {
+            uint32_t word;
+            Flash::read(sectorAddress(sector) + offset, &word, sizeof(word));
+            if (word != Erased) {
+                _sectorStates[sector] = SectorState::Dirty;
+                break;
+            }
+        }
     }
 
-    return ~crc;
-}
-
-bool FlashPatternStorage::isAddressSafe(uint32_t address) {
-    // CRITICAL SAFETY CHECK
-    // Verify address is:
-    // 1. At or after our base address (0x08060000)
-    // 2. Before end of Flash (0x08100000)
-    // 3. NOT in firmware area (0x08000000 - 0x08060000)
-
-    if (address < FLASH_BASE_ADDRESS) {
-        // DANGER: Would write to firmware area!
-        return false;
+    std::array<int, Sectors> order;
+    int count = sectorOrder(order);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t end = forEachRecord(order[i], [this] (uint32_t address, const RecordHeader &header) {
+            if (header.committed()) {
+                if (header.size > 0) {
+                    _used[header.track] |= uint64_t(1) << header.bank;
+                } else {
+                    _used[header.track] &= ~(uint64_t(1) << header.bank);
+                }
+            }
+        });
+        _head = order[i];
+        _headOffset = end;
     }
 
-    if (address >= 0x08100000) {
-        // Beyond Flash memory
-        return false;
+    // power was lost while reclaiming the oldest sector, redo it (records that were already copied are not live anymore)
+    if (count == Sectors) {
+        FlashLock flashLock;
+        reclaim(order[0]);
     }
 
-    return true;
-}
+    NoteSequence sequence;
+    _recordSize = recordSize(payloadSize(sequence));
 
-uint32_t FlashPatternStorage::getPatternAddress(int patternIndex) {
-    if (patternIndex < 0 || patternIndex >= MAX_FLASH_PATTERNS) {
-        return 0;
-    }
-
-    return FLASH_BASE_ADDRESS + (patternIndex * PATTERN_SIZE_BYTES);
+    DBG("pattern storage: %d/%d patterns, head sector %d offset %d", usedCount(), capacity(), _head, int(_headOffset));
 }
 
-uint8_t FlashPatternStorage::getSectorForPattern(int patternIndex) {
-    uint32_t address = getPatternAddress(patternIndex);
-    uint32_t offset = address - 0x08000000;
-
-    // STM32F405 Flash sector layout:
-    // Sectors 0-3: 16 KB each (0x00000 - 0x0FFFF)
-    // Sector 4:    64 KB      (0x10000 - 0x1FFFF)
-    // Sectors 5-11: 128 KB each (0x20000 - 0xFFFFF)
-
-    if (offset < 0x20000) {
-        // We should never be here (our base is 0x60000)
-        return 0xFF;  // Invalid
-    } else {
-        // 128 KB sectors starting at 0x20000
-        return 5 + ((offset - 0x20000) / 0x20000);
+int FlashPatternStorage::firstUnused(int track) const {
+    for (int bank = 0; bank < BankCount; ++bank) {
+        if (!used(track, bank)) {
+            return bank;
+        }
     }
+    return -1;
 }
 
-void FlashPatternStorage::initialize() {
-    // Initialize CRC table
-    init_crc32_table();
-
-    // Verify our base address is safe
-    if (!isAddressSafe(FLASH_BASE_ADDRESS)) {
-        // CRITICAL ERROR: Base address unsafe!
-        // This should never happen with 0x08060000
-        while(1);  // Halt - something is very wrong
+int FlashPatternStorage::usedCount() const {
+    int count = 0;
+    for (auto used : _used) {
+        for (; used; used &= used - 1) {
+            ++count;
+        }
     }
+    return count;
 }
 
-bool FlashPatternStorage::patternExists(int patternIndex) {
-    if (patternIndex < 0 || patternIndex >= MAX_FLASH_PATTERNS) {
-        return false;
-    }
+int FlashPatternStorage::capacity() const {
+    // leave one record of slack per sector so compaction always makes progress
+    int recordsPerSector = (SectorSize - sizeof(SectorHeader)) / _recordSize;
+    return (Sectors - 1) * (recordsPerSector - 1);
+}
 
-    PatternHeader header;
-    if (!readHeader(patternIndex, header)) {
+bool FlashPatternStorage::load(int track, int bank, NoteSequence &sequence) const {
+    RecordHeader header;
+    uint32_t address = findRecord(track, bank, header);
+    if (address == 0 || header.size == 0) {
+        sequence.clear();
         return false;
     }
 
-    // Verify magic number
-    if (header.magic != 0xDEADBEEF) {
-        return false;
-    }
+    FlashReader flashReader(address + sizeof(RecordHeader));
+    VersionedSerializedReader reader(flashReader, ProjectVersion::Latest);
 
-    // Verify pattern index matches
-    if (header.patternIndex != patternIndex) {
-        return false;
-    }
+    sequence.read(reader);
 
-    // Verify version
-    if (header.version != PATTERN_VERSION) {
+    if (!reader.checkHash()) {
+        DBG("pattern storage: invalid record for track %d bank %d", track, bank);
+        sequence.clear();
         return false;
     }
 
     return true;
 }
 
-bool FlashPatternStorage::readHeader(int patternIndex, PatternHeader& header) {
-    uint32_t address = getPatternAddress(patternIndex);
-
-    // Safety check
-    if (!isAddressSafe(address)) {
-        return false;
+FlashPatternStorage::Result FlashPatternStorage::store(int track, int bank, const NoteSequence &sequence, bool allowErase) {
+    if (!used(track, bank) && usedCount() >= capacity()) {
+        return Result::Full;
     }
-
-    // Read header directly from Flash
-    const PatternHeader* flashHeader = reinterpret_cast<const PatternHeader*>(address);
-    std::memcpy(&header, flashHeader, sizeof(PatternHeader));
-
-    return true;
+    return append(track, bank, &sequence, allowErase);
 }
 
-bool FlashPatternStorage::writeHeader(int patternIndex, const PatternHeader& header) {
-    uint32_t address = getPatternAddress(patternIndex);
-
-    // Safety check
-    if (!isAddressSafe(address)) {
-        return false;
+FlashPatternStorage::Result FlashPatternStorage::remove(int track, int bank, bool allowErase) {
+    if (!used(track, bank)) {
+        return Result::Success;
     }
+    return append(track, bank, nullptr, allowErase);
+}
 
-    // Write header word by word
-    flash_unlock();
-
-    const uint32_t* data = reinterpret_cast<const uint32_t*>(&header);
-    for (size_t i = 0; i < sizeof(PatternHeader) / 4; i++) {
-        flash_program_word(address + i * 4, data[i]);
-    }
-
-    flash_wait_for_last_operation();
-    flash_lock();
-
-    return true;
+bool FlashPatternStorage::eraseRequired() const {
+    // a store advances into the next sector at most once if that one is erased
+    int next = _head < 0 ? 0 : (_head + 1) % Sectors;
+    bool headFull = _head < 0 || _headOffset + _recordSize > SectorSize;
+    return headFull && _sectorStates[next] == SectorState::Dirty;
 }
 
-void FlashPatternStorage::erasePattern(int patternIndex) {
-    if (patternIndex < 0 || patternIndex >= MAX_FLASH_PATTERNS) {
-        return;
+void FlashPatternStorage::eraseReclaimed() {
+    FlashLock flashLock;
+
+    for (int sector = 0; sector < Sectors; ++sector) {
+        if (_sectorStates[sector] == SectorState::Dirty) {
+            eraseSector(sector);
+        }
     }
+}
 
-    uint32_t address = getPatternAddress(patternIndex);
+uint32_t FlashPatternStorage::payloadSize(const NoteSequence &sequence) {
+    uint32_t size = 0;
+    VersionedSerializedWriter writer(
+        [&size] (const void *data, size_t len) { size += len; },
+        ProjectVersion::Latest
+    );
+    sequence.write(writer);
+    writer.writeHash();
+    return size;
+}
 
-    // Safety check
-    if (!isAddressSafe(address)) {
-        return;
+template<typename Func>
+uint32_t FlashPatternStorage::forEachRecord(int sector, Func func) const {
+    uint32_t offset = sizeof(SectorHeader);
+    while (offset + sizeof(RecordHeader) <= SectorSize) {
+        uint32_t address = sectorAddress(sector) + offset;
+        RecordHeader header;
+        Flash::read(address, &header, sizeof(header));
+        if (header.blank()) {
+            break;
+        }
+        uint32_t size = recordSize(header.size);
+        if (header.track >= CONFIG_TRACK_COUNT || header.bank >= BankCount || offset + size > SectorSize) {
+            // corrupted header, do not append to this sector anymore
+            return SectorSize;
+        }
+        func(address, header);
+        offset += size;
     }
+    return offset;
+}
 
-    uint8_t sector = getSectorForPattern(patternIndex);
-    if (sector == 0xFF) {
-        return;  // Invalid sector
+int FlashPatternStorage::sectorOrder(std::array<int, Sectors> &order) const {
+    int count = 0;
+    for (int sector = 0; sector < Sectors; ++sector) {
+        if (_sectorStates[sector] == SectorState::Valid) {
+            order[count++] = sector;
+        }
     }
-
-    // Erase the sector
-    flash_unlock();
-    flash_erase_sector(sector, FLASH_CR_PROGRAM_X32);
-    flash_wait_for_last_operation();
-    flash_lock();
+    std::sort(order.begin(), order.begin() + count, [this] (int a, int b) {
+        return _sectorSequences[a] < _sectorSequences[b];
+    });
+    return count;
 }
 
-bool FlashPatternStorage::loadPattern(int patternIndex, NoteSequence sequences[CONFIG_TRACK_COUNT]) {
-    if (patternIndex < 0 || patternIndex >= MAX_FLASH_PATTERNS) {
-        return false;
+uint32_t FlashPatternStorage::findRecord(int track, int bank, RecordHeader &header) const {
+    std::array<int, Sectors> order;
+    int count = sectorOrder(order);
+
+    uint32_t result = 0;
+    for (int i = 0; i < count; ++i) {
+        forEachRecord(order[i], [&] (uint32_t address, const RecordHeader &recordHeader) {
+            if (recordHeader.committed() && recordHeader.track == track && recordHeader.bank == bank) {
+                result = address;
+                header = recordHeader;
+            }
+        });
     }
+    return result;
+}
 
-    uint32_t address = getPatternAddress(patternIndex);
+FlashPatternStorage::Result FlashPatternStorage::append(int track, int bank, const NoteSequence *sequence, bool allowErase) {
+    FlashLock flashLock;
 
-    // Safety check
-    if (!isAddressSafe(address)) {
-        return false;
+    uint32_t size = sequence ? payloadSize(*sequence) : 0;
+    if (recordSize(size) > SectorSize - sizeof(SectorHeader)) {
+        return Result::Full;
     }
 
-    // Read and verify header
-    PatternHeader header;
-    if (!readHeader(patternIndex, header)) {
-        return false;
+    // every advance reclaims one sector, after a full round all garbage is gone
+    for (int i = 0; _head < 0 || _headOffset + recordSize(size) > SectorSize; ++i) {
+        if (i >= 2 * Sectors) {
+            return Result::Full;
+        }
+        Result result = advance(allowErase);
+        if (result != Result::Success) {
+            return result;
+        }
     }
 
-    if (header.magic != 0xDEADBEEF) {
-        return false;
-    }
+    writeRecord(track, bank, sequence, size);
 
-    // Read data from Flash
-    uint32_t dataAddress = address + sizeof(PatternHeader);
-    if (!isAddressSafe(dataAddress) || !isAddressSafe(dataAddress + header.dataSize - 1)) {
-        return false;
+    if (size > 0) {
+        _used[track] |= uint64_t(1) << bank;
+    } else {
+        _used[track] &= ~(uint64_t(1) << bank);
     }
 
-    const uint8_t* flashData = reinterpret_cast<const uint8_t*>(dataAddress);
+    return Result::Success;
+}
 
-    // Copy to temp buffer for verification
-    static uint8_t tempBuffer[PATTERN_SIZE_BYTES];
-    std::memcpy(tempBuffer, flashData, header.dataSize);
+FlashPatternStorage::Result FlashPatternStorage::advance(bool allowErase) {
+    int next = _head < 0 ? 0 : (_head + 1) % Sectors;
 
-    // Verify checksum
-    uint32_t calculatedChecksum = calculateChecksum(tempBuffer, header.dataSize);
-    if (calculatedChecksum != header.checksum) {
-        return false;  // Data corruption
+    if (_sectorStates[next] == SectorState::Valid) {
+        // no spare sector left
+        return Result::Full;
+    }
+    if (_sectorStates[next] == SectorState::Dirty) {
+        if (!allowErase) {
+            return Result::EraseRequired;
+        }
+        eraseSector(next);
     }
 
-    // Deserialize using callback
-    size_t readOffset = 0;
-    uint8_t* bufferPtr = tempBuffer;
-    VersionedSerializedReader reader(
-        [bufferPtr, &readOffset] (void *data, size_t len) {
-            std::memcpy(data, bufferPtr + readOffset, len);
-            readOffset += len;
-        },
-        ProjectVersion::Latest
-    );
+    formatSector(next);
+    _head = next;
+    _headOffset = sizeof(SectorHeader);
 
-    for (int track = 0; track < CONFIG_TRACK_COUNT; track++) {
-        sequences[track].read(reader);
+    // make the oldest sector the new spare
+    std::array<int, Sectors> order;
+    if (sectorOrder(order) == Sectors) {
+        reclaim(order[0]);
     }
 
-    return true;
+    return Result::Success;
 }
 
-bool FlashPatternStorage::savePattern(int patternIndex, const NoteSequence sequences[CONFIG_TRACK_COUNT]) {
-    if (patternIndex < 0 || patternIndex >= MAX_FLASH_PATTERNS) {
-        return false;
-    }
-
-    uint32_t address = getPatternAddress(patternIndex);
+void FlashPatternStorage::reclaim(int sector) {
+    forEachRecord(sector, [this] (uint32_t address, const RecordHeader &header) {
+        if (!header.committed() || header.size == 0) {
+            return;
+        }
+        RecordHeader newest;
+        if (findRecord(header.track, header.bank, newest) != address) {
+            return;
+        }
+        if (_headOffset + recordSize(header.size) > SectorSize) {
+            DBG("pattern storage: no room to reclaim track %d bank %d", header.track, header.bank);
+            return;
+        }
+        copyRecord(address, header);
+    });
 
-    // Safety check
-    if (!isAddressSafe(address)) {
-        return false;
-    }
+    _sectorStates[sector] = SectorState::Dirty;
+}
 
-    // Serialize to temp buffer
-    static uint8_t tempBuffer[PATTERN_SIZE_BYTES];
-    uint8_t* bufferPtr = tempBuffer;
-    size_t writeOffset = 0;
+void FlashPatternStorage::eraseSector(int sector) {
+    Flash::unlock();
+    Flash::eraseSector(CONFIG_PATTERN_FLASH_SECTOR + sector);
+    Flash::lock();
+    _sectorStates[sector] = SectorState::Blank;
+}
 
-    VersionedSerializedWriter writer(
-        [bufferPtr, &writeOffset] (const void *data, size_t len) {
-            std::memcpy(bufferPtr + writeOffset, data, len);
-            writeOffset += len;
-        },
-        ProjectVersion::Latest
-    );
+void FlashPatternStorage::formatSector(int sector) {
+    // sequence first, the magic marks the header as complete
+    Flash::unlock();
+    Flash::program(sectorAddress(sector), _nextSequence);
+    Flash::program(sectorAddress(sector) + sizeof(uint32_t), SectorMagic);
+    Flash::lock();
 
-    for (int track = 0; track < CONFIG_TRACK_COUNT; track++) {
-        sequences[track].write(writer);
-    }
+    _sectorStates[sector] = SectorState::Valid;
+    _sectorSequences[sector] = _nextSequence++;
+}
 
-    size_t dataSize = writeOffset;
+void FlashPatternStorage::copyRecord(uint32_t address, const RecordHeader &header) {
+    uint32_t dst = sectorAddress(_head) + _headOffset;
+    uint32_t size = recordSize(header.size);
 
-    // Calculate checksum
-    uint32_t checksum = calculateChecksum(tempBuffer, dataSize);
+    Flash::unlock();
+    for (uint32_t offset = sizeof(uint32_t); offset < size; offset += sizeof(uint32_t)) {
+        uint32_t word;
+        Flash::read(address + offset, &word, sizeof(word));
+        Flash::program(dst + offset, word);
+    }
+    Flash::program(dst, RecordCommitted);
+    Flash::lock();
 
-    // Create header
-    PatternHeader header;
-    header.magic = 0xDEADBEEF;
-    header.version = PATTERN_VERSION;
-    header.patternIndex = patternIndex;
-    header.reserved1 = 0;
-    header.checksum = checksum;
-    header.dataSize = dataSize;
-    header.reserved2[0] = 0;
-    header.reserved2[1] = 0;
+    _headOffset += size;
+}
 
-    // Erase sector first
-    erasePattern(patternIndex);
+void FlashPatternStorage::writeRecord(int track, int bank, const NoteSequence *sequence, uint32_t size) {
+    uint32_t address = sectorAddress(_head) + _headOffset;
 
-    // Write header
-    if (!writeHeader(patternIndex, header)) {
-        return false;
-    }
+    {
+        FlashWriter flashWriter(address + sizeof(uint32_t));
 
-    // Write data
-    uint32_t dataAddress = address + sizeof(PatternHeader);
-    if (!isAddressSafe(dataAddress) || !isAddressSafe(dataAddress + dataSize - 1)) {
-        return false;
-    }
+        RecordHeader header;
+        header.track = track;
+        header.bank = bank;
+        header.size = size;
+        flashWriter.write(&header.track, sizeof(RecordHeader) - sizeof(uint32_t));
 
-    flash_unlock();
+        if (sequence) {
+            VersionedSerializedWriter writer(flashWriter, ProjectVersion::Latest);
+            sequence->write(writer);
+            writer.writeHash();
+        }
 
-    // Write data word by word
-    uint32_t* wordData = reinterpret_cast<uint32_t*>(tempBuffer);
-    size_t wordCount = (dataSize + 3) / 4;  // Round up to word boundary
+        flashWriter.finish();
 
-    for (size_t i = 0; i < wordCount; i++) {
-        flash_program_word(dataAddress + i * 4, wordData[i]);
+        Flash::program(address, RecordCommitted);
     }
 
-    flash_wait_for_last_operation();
-    flash_lock();
-
-    return true;
+    _headOffset += recordSize(size);
 }
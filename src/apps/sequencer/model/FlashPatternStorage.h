@@ -3,79 +3,112 @@
 #include "Config.h"
 #include "NoteSequence.h"
 
+#include <array>
+
 #include <cstdint>
-#include <cstring>
-
-/**
- * FlashPatternStorage - SAFE Implementation
- *
- * Stores patterns in Flash memory to save RAM.
- * Only the active pattern is kept in RAM, all others stored in Flash.
- *
- * CRITICAL SAFETY:
- * - Firmware size: ~331 KB (ends at 0x08050E68)
- * - Flash storage starts at: 0x08060000 (384 KB)
- * - This provides 64 KB safety margin
- * - Available space: 640 KB (for 32 patterns at 20 KB each)
- *
- * STM32F405 Flash Sectors Used:
- * - Sector 6: 0x08060000 - 0x0807FFFF (128 KB) - First 6 patterns
- * - Sector 7: 0x08080000 - 0x0809FFFF (128 KB) - Next 6 patterns
- * - Sector 8-11: Additional patterns
- */
+
+// Stores track patterns in a wear levelled log in the flash sectors above the firmware.
+// Every store appends a record, the newest record of a track/bank pair wins. When the head sector is full,
+// the log advances into the spare sector and the live records of the oldest sector are copied to the head,
+// which turns the oldest sector into the new spare. There is no index in RAM apart from a bitmap of used
+// slots, records are looked up by scanning the record headers.
+// Erasing a sector stalls the cpu for up to two seconds (the STM32F405 has a single flash bank), therefore
+// sectors are only erased when the caller allows it (i.e. on an explicit user request with the engine suspended).
+// Not thread safe, only to be used from the file task.
 class FlashPatternStorage {
 public:
-    // SAFE Flash memory configuration - WELL after firmware
-    static constexpr uint32_t FLASH_BASE_ADDRESS = 0x08060000;  // 384 KB - SAFE!
-    static constexpr uint32_t FIRMWARE_MAX_SIZE   = 0x00060000;  // 384 KB max firmware
-    static constexpr uint32_t PATTERN_SIZE_BYTES  = 20 * 1024;   // 20 KB per pattern
-    static constexpr int MAX_FLASH_PATTERNS       = 32;          // 640 KB / 20 KB
-    static constexpr uint32_t PATTERN_VERSION     = 1;
-
-    // Pattern header for validation
-    struct PatternHeader {
-        uint32_t magic;          // 0xDEADBEEF - pattern validity marker
-        uint16_t version;        // Format version
-        uint8_t  patternIndex;   // Pattern number (0-31)
-        uint8_t  reserved1;
-        uint32_t checksum;       // CRC32 of pattern data
-        uint32_t dataSize;       // Actual data size
-        uint32_t reserved2[2];   // Future use
-    } __attribute__((packed));
-
-    static_assert(sizeof(PatternHeader) == 24, "Pattern header must be 24 bytes");
+    static constexpr int Sectors = CONFIG_PATTERN_FLASH_SECTORS;
+    static constexpr uint32_t SectorSize = CONFIG_PATTERN_FLASH_SECTOR_SIZE;
+    static constexpr int BankCount = CONFIG_PATTERN_BANK_COUNT;
 
-    // Initialize Flash storage (call once at boot)
-    static void initialize();
+    static_assert(Sectors >= 2, "need at least one spare sector");
+    static_assert(BankCount <= 64, "used bitmap is limited to 64 banks");
 
-    // Check if pattern exists in Flash
-    static bool patternExists(int patternIndex);
+    enum class Result : uint8_t {
+        Success,
+        EraseRequired,
+        Full,
+    };
 
-    // Load pattern from Flash to RAM
-    static bool loadPattern(int patternIndex, NoteSequence sequences[CONFIG_TRACK_COUNT]);
+    // scan the log (call once at boot)
+    void init();
 
-    // Save pattern from RAM to Flash
-    static bool savePattern(int patternIndex, const NoteSequence sequences[CONFIG_TRACK_COUNT]);
+    bool used(int track, int bank) const { return _used[track] & (uint64_t(1) << bank); }
+    int firstUnused(int track) const;
 
-    // Erase pattern from Flash
-    static void erasePattern(int patternIndex);
+    // number of stored track patterns and the maximum that fits into the log
+    int usedCount() const;
+    int capacity() const;
 
-private:
-    // Get Flash address for pattern
-    static uint32_t getPatternAddress(int patternIndex);
-
-    // Calculate CRC32 checksum
-    static uint32_t calculateChecksum(const void* data, size_t length);
+    // returns false and clears the sequence if the slot is unused or corrupted
+    bool load(int track, int bank, NoteSequence &sequence) const;
 
-    // Read pattern header
-    static bool readHeader(int patternIndex, PatternHeader& header);
+    Result store(int track, int bank, const NoteSequence &sequence, bool allowErase);
+    Result remove(int track, int bank, bool allowErase);
 
-    // Write pattern header
-    static bool writeHeader(int patternIndex, const PatternHeader& header);
+    // true if the next store needs a sector erased first
+    bool eraseRequired() const;
+    // erases all reclaimed sectors, stalls the cpu for up to two seconds per sector
+    void eraseReclaimed();
 
-    // Get Flash sector number for pattern
-    static uint8_t getSectorForPattern(int patternIndex);
-
-    // Safety check - verify address is in valid range
-    static bool isAddressSafe(uint32_t address);
+private:
+    static constexpr uint32_t SectorMagic = 0x4b4e4250; // PBNK
+    static constexpr uint32_t RecordCommitted = 0x44434552; // RECD
+    static constexpr uint32_t Erased = 0xffffffff;
+
+    enum class SectorState : uint8_t {
+        Blank,
+        Valid,
+        Dirty,
+    };
+
+    struct SectorHeader {
+        uint32_t sequence;
+        uint32_t magic;
+    };
+
+    // state is programmed last and marks the record as complete
+    struct RecordHeader {
+        uint32_t state;
+        uint8_t track;
+        uint8_t bank;
+        uint16_t size;
+
+        bool blank() const { return track == 0xff && bank == 0xff && size == 0xffff; }
+        bool committed() const { return state == RecordCommitted; }
+    };
+
+    static_assert(sizeof(SectorHeader) == 8, "invalid sector header size");
+    static_assert(sizeof(RecordHeader) == 8, "invalid record header size");
+
+    static uint32_t sectorAddress(int sector) { return CONFIG_PATTERN_FLASH_ADDR + sector * SectorSize; }
+    static uint32_t recordSize(uint32_t payloadSize) { return sizeof(RecordHeader) + ((payloadSize + 3) & ~3); }
+    static uint32_t payloadSize(const NoteSequence &sequence);
+
+    // calls func(address, header) for every record in the sector, returns the end of the written area
+    template<typename Func>
+    uint32_t forEachRecord(int sector, Func func) const;
+
+    // valid sectors, oldest first
+    int sectorOrder(std::array<int, Sectors> &order) const;
+
+    // address of the newest committed record of a track/bank pair, 0 if there is none
+    uint32_t findRecord(int track, int bank, RecordHeader &header) const;
+
+    Result append(int track, int bank, const NoteSequence *sequence, bool allowErase);
+    Result advance(bool allowErase);
+    void reclaim(int sector);
+    void eraseSector(int sector);
+    void formatSector(int sector);
+    void copyRecord(uint32_t address, const RecordHeader &header);
+    void writeRecord(int track, int bank, const NoteSequence *sequence, uint32_t size);
+
+    std::array<SectorState, Sectors> _sectorStates;
+    std::array<uint32_t, Sectors> _sectorSequences;
+    int _head = -1;
+    uint32_t _headOffset = 0;
+    uint32_t _nextSequence = 0;
+    uint32_t _recordSize = 0;
+
+    std::array<uint64_t, CONFIG_TRACK_COUNT> _used;
 };
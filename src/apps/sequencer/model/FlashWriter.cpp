@@ -0,0 +1,3 @@
+#include "FlashWriter.h"
+
+os::Mutex FlashLock::_mutex;
@@ -2,8 +2,25 @@
 
 #include "drivers/Flash.h"
 
+#include "os/os.h"
+#include "os/LockGuard.h"
+
+#include <algorithm>
 #include <cstring>
 
+// The flash is written by the settings and the pattern banks. Writers hold the lock for a complete write operation,
+// so one writer never locks the flash while another one is programming it.
+class FlashLock {
+public:
+    FlashLock() :
+        _guard(_mutex)
+    {}
+
+private:
+    static os::Mutex _mutex;
+    os::LockGuard _guard;
+};
+
 class FlashWriter {
 public:
     FlashWriter(uint32_t address, uint32_t sector) :
@@ -13,6 +30,13 @@ public:
         Flash::eraseSector(sector);
     }
 
+    // write to flash that is already erased
+    FlashWriter(uint32_t address) :
+        _address(address)
+    {
+        Flash::unlock();
+    }
+
     ~FlashWriter() {
         finish();
         Flash::lock();
@@ -3,6 +3,11 @@
 
 #include "ModelUtils.h"
 
+#include <algorithm>
+
+// number of steps serialized per block
+static constexpr size_t StepBlockSize = 16;
+
 Types::LayerRange NoteSequence::layerRange(Layer layer) {
     #define CASE(_layer_) \
     case Layer::_layer_: \
@@ -156,7 +161,8 @@ void NoteSequence::Step::setLayerValue(Layer layer, int value) {
 
 void NoteSequence::Step::clear() {
     _data0.raw = 0;
-    _data1.raw = 1;
+    _data1.raw = 0;
+    _data2.raw = 0;
     setGate(false);
     setGateProbability(GateProbability::Max);
     setGateOffset(0);
@@ -173,17 +179,21 @@ void NoteSequence::Step::clear() {
 }
 
 void NoteSequence::Step::write(VersionedSerializedWriter &writer) const {
-    writer.write(_data0.raw);
-    writer.write(_data1.raw);
+    uint32_t data0, data1;
+    toLegacy(data0, data1);
+    writer.write(data0);
+    writer.write(data1);
 }
 
 void NoteSequence::Step::read(VersionedSerializedReader &reader) {
+    uint32_t data0, data1;
     if (reader.dataVersion() < ProjectVersion::Version27) {
-        reader.read(_data0.raw);
-        reader.readAs<uint16_t>(_data1.raw);
+        reader.read(data0);
+        reader.readAs<uint16_t>(data1);
         if (reader.dataVersion() < ProjectVersion::Version5) {
-            _data1.raw &= 0x1f;
+            data1 &= 0x1f;
         }
+        fromLegacy(data0, data1);
         if (reader.dataVersion() < ProjectVersion::Version7) {
             setGateOffset(0);
         }
@@ -191,11 +201,113 @@ void NoteSequence::Step::read(VersionedSerializedReader &reader) {
             setCondition(Types::Condition(0));
         }
     } else {
-        reader.read(_data0.raw);
-        reader.read(_data1.raw);
+        reader.read(data0);
+        reader.read(data1);
+        fromLegacy(data0, data1);
+    }
+}
+
+void NoteSequence::Step::writeSteps(VersionedSerializedWriter &writer, const Step *steps, size_t count) {
+    // convert to the legacy layout in small blocks to keep the stack usage of the file task low
+    std::array<uint32_t, 2 * StepBlockSize> block;
+    while (count > 0) {
+        size_t blockCount = std::min(count, StepBlockSize);
+        for (size_t i = 0; i < blockCount; ++i) {
+            steps[i].toLegacy(block[i * 2], block[i * 2 + 1]);
+        }
+        writer.write(block.data(), blockCount * 2 * sizeof(uint32_t));
+        steps += blockCount;
+        count -= blockCount;
     }
 }
 
+void NoteSequence::Step::readSteps(VersionedSerializedReader &reader, Step *steps, size_t count) {
+    if (reader.dataVersion() < ProjectVersion::Version27) {
+        for (size_t i = 0; i < count; ++i) {
+            steps[i].read(reader);
+        }
+        return;
+    }
+
+    std::array<uint32_t, 2 * StepBlockSize> block;
+    while (count > 0) {
+        size_t blockCount = std::min(count, StepBlockSize);
+        reader.read(block.data(), blockCount * 2 * sizeof(uint32_t), 0);
+        for (size_t i = 0; i < blockCount; ++i) {
+            steps[i].fromLegacy(block[i * 2], block[i * 2 + 1]);
+        }
+        steps += blockCount;
+        count -= blockCount;
+    }
+}
+
+// original step layout, still used in project files
+union LegacyStepData0 {
+    uint32_t raw;
+    BitField<uint32_t, 0, 1> gate;
+    BitField<uint32_t, 1, 1> slide;
+    BitField<uint32_t, 2, NoteSequence::GateProbability::Bits> gateProbability;
+    BitField<uint32_t, 5, NoteSequence::Length::Bits> length;
+    BitField<uint32_t, 8, NoteSequence::LengthVariationRange::Bits> lengthVariationRange;
+    BitField<uint32_t, 12, NoteSequence::LengthVariationProbability::Bits> lengthVariationProbability;
+    BitField<uint32_t, 15, NoteSequence::Note::Bits> note;
+    BitField<uint32_t, 22, NoteSequence::NoteVariationRange::Bits> noteVariationRange;
+    BitField<uint32_t, 29, NoteSequence::NoteVariationProbability::Bits> noteVariationProbability;
+};
+
+union LegacyStepData1 {
+    uint32_t raw;
+    BitField<uint32_t, 0, NoteSequence::Retrigger::Bits> retrigger;
+    BitField<uint32_t, 2, NoteSequence::RetriggerProbability::Bits> retriggerProbability;
+    BitField<uint32_t, 5, NoteSequence::GateOffset::Bits> gateOffset;
+    BitField<uint32_t, 12, NoteSequence::Condition::Bits> condition;
+};
+
+void NoteSequence::Step::toLegacy(uint32_t &data0, uint32_t &data1) const {
+    LegacyStepData0 legacy0;
+    legacy0.raw = 0;
+    legacy0.gate = bool(_data0.gate);
+    legacy0.slide = bool(_data0.slide);
+    legacy0.gateProbability = uint16_t(_data1.gateProbability);
+    legacy0.length = uint16_t(_data2.length);
+    legacy0.lengthVariationRange = uint16_t(_data1.lengthVariationRange);
+    legacy0.lengthVariationProbability = uint16_t(_data2.lengthVariationProbability);
+    legacy0.note = uint16_t(_data0.note);
+    legacy0.noteVariationRange = uint16_t(_data0.noteVariationRange);
+    legacy0.noteVariationProbability = uint16_t(_data2.noteVariationProbability);
+
+    LegacyStepData1 legacy1;
+    legacy1.raw = 0;
+    legacy1.retrigger = uint16_t(_data1.retrigger);
+    legacy1.retriggerProbability = uint16_t(_data2.retriggerProbability);
+    legacy1.gateOffset = uint16_t(_data2.gateOffset);
+    legacy1.condition = uint16_t(_data1.condition);
+
+    data0 = legacy0.raw;
+    data1 = legacy1.raw;
+}
+
+void NoteSequence::Step::fromLegacy(uint32_t data0, uint32_t data1) {
+    LegacyStepData0 legacy0;
+    legacy0.raw = data0;
+    LegacyStepData1 legacy1;
+    legacy1.raw = data1;
+
+    _data0.gate = bool(legacy0.gate);
+    _data0.slide = bool(legacy0.slide);
+    _data0.note = uint32_t(legacy0.note);
+    _data0.noteVariationRange = uint32_t(legacy0.noteVariationRange);
+    _data1.gateProbability = uint32_t(legacy0.gateProbability);
+    _data1.retrigger = uint32_t(legacy1.retrigger);
+    _data1.lengthVariationRange = uint32_t(legacy0.lengthVariationRange);
+    _data1.condition = uint32_t(legacy1.condition);
+    _data2.length = uint32_t(legacy0.length);
+    _data2.lengthVariationProbability = uint32_t(legacy0.lengthVariationProbability);
+    _data2.noteVariationProbability = uint32_t(legacy0.noteVariationProbability);
+    _data2.retriggerProbability = uint32_t(legacy1.retriggerProbability);
+    _data2.gateOffset = uint32_t(legacy1.gateOffset);
+}
+
 void NoteSequence::writeRouted(Routing::Target target, int intValue, float floatValue) {
     switch (target) {
     case Routing::Target::Scale:
@@ -289,7 +401,7 @@ void NoteSequence::write(VersionedSerializedWriter &writer) const {
     writer.write(_firstStep.base);
     writer.write(_lastStep.base);
 
-    writeArray(writer, _steps);
+    Step::writeSteps(writer, _steps.data(), _steps.size());
 }
 
 void NoteSequence::read(VersionedSerializedReader &reader) {
@@ -305,5 +417,5 @@ void NoteSequence::read(VersionedSerializedReader &reader) {
     reader.read(_firstStep.base);
     reader.read(_lastStep.base);
 
-    readArray(reader, _steps);
+    Step::readSteps(reader, _steps.data(), _steps.size());
 }
@@ -90,18 +90,18 @@ public:
 
         // gateProbability
 
-        int gateProbability() const { return _data0.gateProbability; }
+        int gateProbability() const { return _data1.gateProbability; }
         void setGateProbability(int gateProbability) {
-            _data0.gateProbability = GateProbability::clamp(gateProbability);
+            _data1.gateProbability = GateProbability::clamp(gateProbability);
         }
 
         // gateOffset (0-15: micro-timing offset in ticks)
 
-        int gateOffset() const { return _data1.gateOffset; }
+        int gateOffset() const { return _data2.gateOffset; }
         void setGateOffset(int gateOffset) {
             // Timing offset 0-15 for micro-timing (0=on beat, 15=~15 ticks late)
             // At 192 PPQN and 120 BPM: ~2.6ms per tick, so 15 ticks = ~39ms max offset
-            _data1.gateOffset = GateOffset::clamp(gateOffset);
+            _data2.gateOffset = GateOffset::clamp(gateOffset);
         }
 
         // slide
@@ -123,30 +123,30 @@ public:
 
         // retriggerProbability
 
-        int retriggerProbability() const { return _data1.retriggerProbability; }
+        int retriggerProbability() const { return _data2.retriggerProbability; }
         void setRetriggerProbability(int retriggerProbability) {
-            _data1.retriggerProbability = RetriggerProbability::clamp(retriggerProbability);
+            _data2.retriggerProbability = RetriggerProbability::clamp(retriggerProbability);
         }
 
         // length
 
-        int length() const { return _data0.length; }
+        int length() const { return _data2.length; }
         void setLength(int length) {
-            _data0.length = Length::clamp(length);
+            _data2.length = Length::clamp(length);
         }
 
         // lengthVariationRange
 
-        int lengthVariationRange() const { return LengthVariationRange::Min + _data0.lengthVariationRange; }
+        int lengthVariationRange() const { return LengthVariationRange::Min + _data1.lengthVariationRange; }
         void setLengthVariationRange(int lengthVariationRange) {
-            _data0.lengthVariationRange = LengthVariationRange::clamp(lengthVariationRange) - LengthVariationRange::Min;
+            _data1.lengthVariationRange = LengthVariationRange::clamp(lengthVariationRange) - LengthVariationRange::Min;
         }
 
         // lengthVariationProbability
 
-        int lengthVariationProbability() const { return _data0.lengthVariationProbability; }
+        int lengthVariationProbability() const { return _data2.lengthVariationProbability; }
         void setLengthVariationProbability(int lengthVariationProbability) {
-            _data0.lengthVariationProbability = LengthVariationProbability::clamp(lengthVariationProbability);
+            _data2.lengthVariationProbability = LengthVariationProbability::clamp(lengthVariationProbability);
         }
 
         // note
@@ -165,9 +165,9 @@ public:
 
         // noteVariationProbability
 
-        int noteVariationProbability() const { return _data0.noteVariationProbability; }
+        int noteVariationProbability() const { return _data2.noteVariationProbability; }
         void setNoteVariationProbability(int noteVariationProbability) {
-            _data0.noteVariationProbability = NoteVariationProbability::clamp(noteVariationProbability);
+            _data2.noteVariationProbability = NoteVariationProbability::clamp(noteVariationProbability);
         }
 
         // condition
@@ -191,8 +191,12 @@ public:
         void write(VersionedSerializedWriter &writer) const;
         void read(VersionedSerializedReader &reader);
 
+        // serialize a whole step array in blocks instead of field by field (same data layout as write()/read())
+        static void writeSteps(VersionedSerializedWriter &writer, const Step *steps, size_t count);
+        static void readSteps(VersionedSerializedReader &reader, Step *steps, size_t count);
+
         bool operator==(const Step &other) const {
-            return _data0.raw == other._data0.raw && _data1.raw == other._data1.raw;
+            return _data0.raw == other._data0.raw && _data1.raw == other._data1.raw && _data2.raw == other._data2.raw;
         }
 
         bool operator!=(const Step &other) const {
@@ -200,28 +204,37 @@ public:
         }
 
     private:
+        // steps are packed into 3 x 16 bit words to keep the pattern memory footprint small
+        // (project files use the original 2 x 32 bit layout, see toLegacy()/fromLegacy())
+        void toLegacy(uint32_t &data0, uint32_t &data1) const;
+        void fromLegacy(uint32_t data0, uint32_t data1);
+
         union {
-            uint32_t raw;
-            BitField<uint32_t, 0, 1> gate;
-            BitField<uint32_t, 1, 1> slide;
-            BitField<uint32_t, 2, GateProbability::Bits> gateProbability;
-            BitField<uint32_t, 5, Length::Bits> length;
-            BitField<uint32_t, 8, LengthVariationRange::Bits> lengthVariationRange;
-            BitField<uint32_t, 12, LengthVariationProbability::Bits> lengthVariationProbability;
-            BitField<uint32_t, 15, Note::Bits> note;
-            BitField<uint32_t, 22, NoteVariationRange::Bits> noteVariationRange;
-            BitField<uint32_t, 29, NoteVariationProbability::Bits> noteVariationProbability;
+            uint16_t raw;
+            BitField<uint16_t, 0, 1> gate;
+            BitField<uint16_t, 1, 1> slide;
+            BitField<uint16_t, 2, Note::Bits> note;
+            BitField<uint16_t, 9, NoteVariationRange::Bits> noteVariationRange;
         } _data0;
         union {
-            uint32_t raw;
-            BitField<uint32_t, 0, Retrigger::Bits> retrigger;
-            BitField<uint32_t, 2, RetriggerProbability::Bits> retriggerProbability;
-            BitField<uint32_t, 5, GateOffset::Bits> gateOffset;
-            BitField<uint32_t, 12, Condition::Bits> condition;
-            // 13 bits left (19 bits used: 2+3+7+7)
+            uint16_t raw;
+            BitField<uint16_t, 0, GateProbability::Bits> gateProbability;
+            BitField<uint16_t, 3, Retrigger::Bits> retrigger;
+            BitField<uint16_t, 5, LengthVariationRange::Bits> lengthVariationRange;
+            BitField<uint16_t, 9, Condition::Bits> condition;
         } _data1;
+        union {
+            uint16_t raw;
+            BitField<uint16_t, 0, Length::Bits> length;
+            BitField<uint16_t, 3, LengthVariationProbability::Bits> lengthVariationProbability;
+            BitField<uint16_t, 6, NoteVariationProbability::Bits> noteVariationProbability;
+            BitField<uint16_t, 9, RetriggerProbability::Bits> retriggerProbability;
+            BitField<uint16_t, 12, GateOffset::Bits> gateOffset;
+        } _data2;
     };
 
+    static_assert(sizeof(Step) == 6, "NoteSequence::Step must be 6 bytes");
+
     using StepArray = std::array<Step, CONFIG_STEP_COUNT>;
 
     //----------------------------------------
@@ -465,4 +478,5 @@ private:
     uint8_t _edited;
 
     friend class NoteTrack;
+    friend class PatternPager;
 };
@@ -51,7 +51,7 @@ void NoteTrack::clear() {
     }
 }
 
-void NoteTrack::write(VersionedSerializedWriter &writer) const {
+void NoteTrack::write(VersionedSerializedWriter &writer, bool withSequences) const {
     writer.write(_playMode);
     writer.write(_fillMode);
     writer.write(_fillMuted);
@@ -67,10 +67,12 @@ void NoteTrack::write(VersionedSerializedWriter &writer) const {
     writer.write(_polyphony);
     writer.write(_captureTiming);
     writer.write(_timingQuantize);
-    writeArray(writer, _sequences);
+    if (withSequences) {
+        writeArray(writer, _sequences);
+    }
 }
 
-void NoteTrack::read(VersionedSerializedReader &reader) {
+void NoteTrack::read(VersionedSerializedReader &reader, bool withSequences) {
     reader.backupHash();
 
     reader.read(_playMode);
@@ -95,5 +97,7 @@ void NoteTrack::read(VersionedSerializedReader &reader) {
         reader.restoreHash();
     }
 
-    readArray(reader, _sequences);
+    if (withSequences) {
+        readArray(reader, _sequences);
+    }
 }
@@ -333,8 +333,9 @@ public:
 
     void clear();
 
-    void write(VersionedSerializedWriter &writer) const;
-    void read(VersionedSerializedReader &reader);
+    // the sequences can be left out to serialize the track properties only (see ProjectDirtyState)
+    void write(VersionedSerializedWriter &writer, bool withSequences = true) const;
+    void read(VersionedSerializedReader &reader, bool withSequences = true);
 
 private:
     void setTrackIndex(int trackIndex) {
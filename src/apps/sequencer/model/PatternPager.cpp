@@ -0,0 +1,148 @@
+#include "PatternPager.h"
+
+#include "os/os.h"
+
+void PatternPager::init() {
+    _storage.init();
+
+    for (auto &entry : _entries) {
+        entry.state = Entry::State::Free;
+        entry.track = -1;
+    }
+}
+
+bool PatternPager::acquire(int track, int pattern) {
+    os::InterruptLock lock;
+
+    auto entry = findEntry(track, PlayState::bankFromPattern(pattern));
+    if (!entry || !entry->available()) {
+        return false;
+    }
+
+    entry->state = Entry::State::Active;
+    entry->lastUsed = ++_useCounter;
+    return true;
+}
+
+NoteSequence *PatternPager::sequence(int track, int pattern) {
+    auto entry = findEntry(track, PlayState::bankFromPattern(pattern));
+    return entry && entry->state == Entry::State::Active ? &entry->sequence : nullptr;
+}
+
+bool PatternPager::store(int track, int bank, const NoteSequence &sequence, bool erase) {
+    if (_storePending) {
+        return false;
+    }
+
+    _storeTrack = track;
+    _storeBank = bank;
+    _storeSequence = sequence;
+    _storeSequence.setTrackIndex(track);
+    _storeErase = erase;
+    _storePending = true;
+
+    return true;
+}
+
+void PatternPager::eraseStorage() {
+    _storage.eraseReclaimed();
+
+    if (_storePending && _storeErase) {
+        _storeErase = false;
+        processStore();
+    }
+}
+
+void PatternPager::update(const PlayState &playState) {
+    // release bank patterns that are no longer played
+    for (auto &entry : _entries) {
+        os::InterruptLock lock;
+        if (entry.state == Entry::State::Active &&
+            playState.trackState(entry.track).pattern() != PlayState::patternFromBank(entry.bank)) {
+            entry.state = Entry::State::Ready;
+        }
+    }
+
+    processStore();
+
+    // page in played and requested bank patterns
+    for (int track = 0; track < CONFIG_TRACK_COUNT; ++track) {
+        const auto &trackState = playState.trackState(track);
+        if (PlayState::isBankPattern(trackState.pattern())) {
+            load(playState, track, PlayState::bankFromPattern(trackState.pattern()));
+        }
+        if (trackState.hasPatternRequest() && PlayState::isBankPattern(trackState.requestedPattern())) {
+            load(playState, track, PlayState::bankFromPattern(trackState.requestedPattern()));
+        }
+    }
+}
+
+PatternPager::Entry *PatternPager::findEntry(int track, int bank) {
+    for (auto &entry : _entries) {
+        if (entry.state != Entry::State::Free && entry.track == track && entry.bank == bank) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void PatternPager::load(const PlayState &playState, int track, int bank) {
+    if (findEntry(track, bank)) {
+        return;
+    }
+
+    auto inUse = [&playState] (const Entry &entry) {
+        const auto &trackState = playState.trackState(entry.track);
+        int pattern = PlayState::patternFromBank(entry.bank);
+        return trackState.pattern() == pattern || (trackState.hasPatternRequest() && trackState.requestedPattern() == pattern);
+    };
+
+    // use a free entry or evict the least recently used pattern that is neither played nor requested
+    Entry *entry = nullptr;
+    {
+        os::InterruptLock lock;
+        for (auto &candidate : _entries) {
+            if (candidate.state == Entry::State::Free) {
+                entry = &candidate;
+                break;
+            }
+            if (candidate.state == Entry::State::Ready && !inUse(candidate) && (!entry || candidate.lastUsed < entry->lastUsed)) {
+                entry = &candidate;
+            }
+        }
+        if (!entry) {
+            return;
+        }
+        entry->state = Entry::State::Loading;
+        entry->track = track;
+        entry->bank = bank;
+    }
+
+    // unused slots are paged in as empty patterns
+    _storage.load(track, bank, entry->sequence);
+    entry->sequence.setTrackIndex(track);
+
+    os::InterruptLock lock;
+    entry->state = Entry::State::Ready;
+    entry->lastUsed = ++_useCounter;
+}
+
+void PatternPager::processStore() {
+    if (!_storePending || _storeErase) {
+        return;
+    }
+
+    // never erases, the ui erases on request before storing if needed (see FlashPatternStorage::eraseRequired)
+    auto result = _storage.store(_storeTrack, _storeBank, _storeSequence, false);
+
+    if (result == Result::Success) {
+        os::InterruptLock lock;
+        auto entry = findEntry(_storeTrack, _storeBank);
+        if (entry && entry->available()) {
+            entry->sequence = _storeSequence;
+        }
+    }
+
+    _storeResult = result;
+    _storePending = false;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Config.h"
+#include "FlashPatternStorage.h"
+#include "NoteSequence.h"
+#include "PlayState.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Pages note track patterns from the flash pattern banks into a small pool of sequences.
+// The file task loads bank patterns as soon as they are requested in the play state, so they are
+// usually paged in long before a synced request is executed. The engine never waits for the flash,
+// it acquires a paged in pattern when switching to it and keeps the request pending otherwise.
+class PatternPager {
+public:
+    static constexpr int Entries = CONFIG_PATTERN_PAGER_ENTRIES;
+
+    typedef FlashPatternStorage::Result Result;
+
+    void init();
+
+    const FlashPatternStorage &storage() const { return _storage; }
+
+    // engine task
+
+    // marks a paged in bank pattern as playing, returns false if it is not paged in yet
+    bool acquire(int track, int pattern);
+    // returns the sequence of an acquired bank pattern or nullptr
+    NoteSequence *sequence(int track, int pattern);
+
+    // ui task
+
+    // queues storing a sequence to a bank slot, returns false if a store is still pending
+    // a store that needs the flash to be erased first is completed by eraseStorage()
+    bool store(int track, int bank, const NoteSequence &sequence, bool erase = false);
+    bool storePending() const { return _storePending; }
+    Result storeResult() const { return _storeResult; }
+
+    // file task
+
+    void update(const PlayState &playState);
+    // erases reclaimed flash sectors and completes a store waiting for it, stalls the cpu (engine has to be suspended)
+    void eraseStorage();
+
+private:
+    struct Entry {
+        enum class State : uint8_t {
+            Free,
+            Loading,
+            Ready,
+            Active,
+        };
+
+        State state = State::Free;
+        int8_t track = -1;
+        uint8_t bank = 0;
+        uint32_t lastUsed = 0;
+        NoteSequence sequence;
+
+        bool available() const { return state == State::Ready || state == State::Active; }
+    };
+
+    Entry *findEntry(int track, int bank);
+    void load(const PlayState &playState, int track, int bank);
+    void processStore();
+
+    FlashPatternStorage _storage;
+    std::array<Entry, Entries> _entries;
+    uint32_t _useCounter = 0;
+
+    volatile bool _storePending = false;
+    volatile bool _storeErase = false;
+    Result _storeResult = Result::Success;
+    int8_t _storeTrack;
+    uint8_t _storeBank;
+    NoteSequence _storeSequence;
+};
@@ -124,8 +124,8 @@ void PlayState::selectTrackPattern(int track, int pattern, ExecuteType executeTy
 
     selectTrackPatternUnsafe(track, pattern, executeType);
 
-    // switch selected pattern
-    if (track == _project.selectedTrackIndex()) {
+    // switch selected pattern (bank patterns are not editable)
+    if (track == _project.selectedTrackIndex() && !isBankPattern(pattern)) {
         _project.setSelectedPatternIndex(pattern);
     }
 }
@@ -150,6 +150,10 @@ void PlayState::createSnapshot() {
     for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
         int trackPatternIndex = trackState(trackIndex).pattern();
         _snapshot.lastTrackPatternIndex[trackIndex] = trackPatternIndex;
+        // tracks playing a bank pattern keep playing it
+        if (isBankPattern(trackPatternIndex)) {
+            continue;
+        }
         _project.track(trackIndex).copyPattern(trackPatternIndex, SnapshotPatternIndex);
         selectTrackPattern(trackIndex, SnapshotPatternIndex);
     }
@@ -179,7 +183,9 @@ void PlayState::commitSnapshot(int targetPattern) {
 
     for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
         int trackPatternIndex = targetPattern >= 0 ? targetPattern : _snapshot.lastTrackPatternIndex[trackIndex];
-        _project.track(trackIndex).copyPattern(SnapshotPatternIndex, trackPatternIndex);
+        if (!isBankPattern(_snapshot.lastTrackPatternIndex[trackIndex]) && !isBankPattern(trackPatternIndex)) {
+            _project.track(trackIndex).copyPattern(SnapshotPatternIndex, trackPatternIndex);
+        }
         selectTrackPatternUnsafe(trackIndex, trackPatternIndex);
     }
 
@@ -203,7 +209,7 @@ void PlayState::cancelPatternRequests() {
         trackState.setRequestedPattern(trackState.pattern());
 
         // switch selected pattern
-        if (track == _project.selectedTrackIndex()) {
+        if (track == _project.selectedTrackIndex() && !isBankPattern(trackState.pattern())) {
             _project.setSelectedPatternIndex(trackState.pattern());
         }
     }
@@ -280,6 +280,20 @@ public:
 
     // pattern change
 
+    // pattern indices following the edit patterns and the snapshot refer to patterns paged in from the flash banks
+    static constexpr int BankPatternIndex = CONFIG_PATTERN_COUNT + CONFIG_SNAPSHOT_COUNT;
+    static bool isBankPattern(int pattern) { return pattern >= BankPatternIndex; }
+    static int bankFromPattern(int pattern) { return pattern - BankPatternIndex; }
+    static int patternFromBank(int bank) { return BankPatternIndex + bank; }
+
+    static void printPattern(StringBuilder &str, int pattern) {
+        if (isBankPattern(pattern)) {
+            str("B%d", bankFromPattern(pattern) + 1);
+        } else {
+            str("P%d", pattern + 1);
+        }
+    }
+
     void selectTrackPattern(int track, int pattern, ExecuteType executeType = Immediate);
     void selectPattern(int pattern, ExecuteType executeType = Immediate);
 
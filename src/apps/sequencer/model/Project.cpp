@@ -43,6 +43,7 @@ void Project::clear() {
     setMidiProgramOffset(0);
     setCvGateInput(Types::CvGateInput::Off);
     setCurveCvInput(Types::CurveCvInput::Off);
+    setSlideMode(Types::SlideMode::Exponential);
 
     _clockSetup.clear();
 
@@ -104,6 +105,65 @@ void Project::setTrackMode(int trackIndex, Track::TrackMode trackMode) {
 }
 
 void Project::write(VersionedSerializedWriter &writer) const {
+    writeData(writer, true);
+
+    _autoLoaded = false;
+}
+
+bool Project::read(VersionedSerializedReader &reader) {
+    clear();
+
+    return readData(reader, true);
+}
+
+void Project::writeProperties(VersionedSerializedWriter &writer) const {
+    writeData(writer, false);
+}
+
+bool Project::readProperties(VersionedSerializedReader &reader) {
+    return readData(reader, false);
+}
+
+bool Project::writeSequence(VersionedSerializedWriter &writer, int trackIndex, int patternIndex) const {
+    const auto &track = _tracks[trackIndex];
+    switch (track.trackMode()) {
+    case Track::TrackMode::Note:
+        track.noteTrack().sequence(patternIndex).write(writer);
+        break;
+#if CONFIG_ENABLE_CURVE_TRACKS
+    case Track::TrackMode::Curve:
+        track.curveTrack().sequence(patternIndex).write(writer);
+        break;
+#endif
+    default:
+        return false;
+    }
+    writer.writeHash();
+    return true;
+}
+
+bool Project::readSequence(VersionedSerializedReader &reader, int trackIndex, int patternIndex) {
+    if (trackIndex < 0 || trackIndex >= CONFIG_TRACK_COUNT || patternIndex < 0 || patternIndex >= CONFIG_PATTERN_COUNT + CONFIG_SNAPSHOT_COUNT) {
+        return false;
+    }
+
+    auto &track = _tracks[trackIndex];
+    switch (track.trackMode()) {
+    case Track::TrackMode::Note:
+        track.noteTrack().sequence(patternIndex).read(reader);
+        break;
+#if CONFIG_ENABLE_CURVE_TRACKS
+    case Track::TrackMode::Curve:
+        track.curveTrack().sequence(patternIndex).read(reader);
+        break;
+#endif
+    default:
+        return false;
+    }
+    return reader.checkHash();
+}
+
+void Project::writeData(VersionedSerializedWriter &writer, bool withSequences) const {
     writer.write(_name, NameLength + 1);
     writer.write(_tempo.base);
     writer.write(_swing.base);
@@ -120,10 +180,13 @@ void Project::write(VersionedSerializedWriter &writer) const {
     _midiInputSource.write(writer);
     writer.write(_cvGateInput);
     writer.write(_curveCvInput);
+    writer.write(_slideMode);
 
     _clockSetup.write(writer);
 
-    writeArray(writer, _tracks);
+    for (const auto &track : _tracks) {
+        track.write(writer, withSequences);
+    }
     writeArray(writer, _cvOutputTracks);
     writeArray(writer, _cvOutputModulators);
     writeArray(writer, _gateOutputTracks);
@@ -139,13 +202,9 @@ void Project::write(VersionedSerializedWriter &writer) const {
     writer.write(_selectedPatternIndex);
 
     writer.writeHash();
-
-    _autoLoaded = false;
 }
 
-bool Project::read(VersionedSerializedReader &reader) {
-    clear();
-
+bool Project::readData(VersionedSerializedReader &reader, bool withSequences) {
     reader.read(_name, NameLength + 1, ProjectVersion::Version5);
     reader.read(_tempo.base);
     reader.read(_swing.base);
@@ -162,18 +221,23 @@ bool Project::read(VersionedSerializedReader &reader) {
     reader.read(_recordMode);
     if (reader.dataVersion() >= ProjectVersion::Version29) {
         reader.read(_midiInputMode);
-        _midiInputSource.read(reader);
     }
     if (reader.dataVersion() >= ProjectVersion::Version32) {
         reader.read(_midiIntegrationMode);
         reader.read(_midiProgramOffset);
     }
+    if (reader.dataVersion() >= ProjectVersion::Version29) {
+        _midiInputSource.read(reader);
+    }
     reader.read(_cvGateInput, ProjectVersion::Version6);
     reader.read(_curveCvInput, ProjectVersion::Version11);
+    reader.read(_slideMode, ProjectVersion::Version34);
 
     _clockSetup.read(reader);
 
-    readArray(reader, _tracks);
+    for (auto &track : _tracks) {
+        track.read(reader, withSequences);
+    }
     readArray(reader, _cvOutputTracks);
     readArray(reader, _cvOutputModulators);
     readArray(reader, _gateOutputTracks);
@@ -183,8 +247,10 @@ bool Project::read(VersionedSerializedReader &reader) {
     _routing.read(reader);
     _midiOutput.read(reader);
 
-    if (reader.dataVersion() >= ProjectVersion::Version5) {
+    if (reader.dataVersion() >= ProjectVersion::Version33) {
         readArray(reader, UserScale::userScales);
+    } else if (reader.dataVersion() >= ProjectVersion::Version5) {
+        readArray(reader, UserScale::userScales, 1);
     }
 
     reader.read(_selectedTrackIndex);
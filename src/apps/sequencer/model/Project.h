@@ -308,6 +308,21 @@ public:
         str(Types::curveCvInput(_curveCvInput));
     }
 
+    // slideMode
+
+    Types::SlideMode slideMode() const { return _slideMode; }
+    void setSlideMode(Types::SlideMode slideMode) {
+        _slideMode = ModelUtils::clampedEnum(slideMode);
+    }
+
+    void editSlideMode(int value, bool shift) {
+        _slideMode = ModelUtils::adjustedEnum(_slideMode, value);
+    }
+
+    void printSlideMode(StringBuilder &str) const {
+        str(Types::slideModeName(_slideMode));
+    }
+
     // curveMidiInput
 
     // clockSetup
@@ -417,7 +432,10 @@ public:
             _observable.notify(SelectedTrackIndexChanged);
 
             // switch selected pattern
-            setSelectedPatternIndex(_playState.trackState(index).pattern());
+            int pattern = _playState.trackState(index).pattern();
+            if (!PlayState::isBankPattern(pattern)) {
+                setSelectedPatternIndex(pattern);
+            }
         }
     }
 
@@ -513,7 +531,18 @@ public:
     void write(VersionedSerializedWriter &writer) const;
     bool read(VersionedSerializedReader &reader);
 
+    // everything except the track sequences, used for incremental saves (see ProjectDirtyState)
+    void writeProperties(VersionedSerializedWriter &writer) const;
+    bool readProperties(VersionedSerializedReader &reader);
+
+    // a single sequence of a note or curve track, returns false if the track has no sequences
+    bool writeSequence(VersionedSerializedWriter &writer, int trackIndex, int patternIndex) const;
+    bool readSequence(VersionedSerializedReader &reader, int trackIndex, int patternIndex);
+
 private:
+    void writeData(VersionedSerializedWriter &writer, bool withSequences) const;
+    bool readData(VersionedSerializedReader &reader, bool withSequences);
+
     uint8_t _slot = uint8_t(-1);
     char _name[NameLength + 1];
     mutable uint8_t _autoLoaded = 0;
@@ -532,6 +561,7 @@ private:
     uint8_t _midiProgramOffset;
     Types::CvGateInput _cvGateInput;
     Types::CurveCvInput _curveCvInput;
+    Types::SlideMode _slideMode;
 
     ClockSetup _clockSetup;
     TrackArray _tracks;
@@ -0,0 +1,94 @@
+#include "ProjectDirtyState.h"
+#include "ProjectVersion.h"
+
+#include "core/hash/FnvHash.h"
+
+namespace {
+
+struct HashWriter {
+    FnvHash hash;
+
+    void write(const void *data, size_t len) {
+        hash(data, len);
+    }
+};
+
+} // namespace
+
+void ProjectDirtyState::invalidate() {
+    _valid = false;
+}
+
+void ProjectDirtyState::update(const Project &project) {
+    uint32_t propertiesHash = hashProperties(project);
+    if (propertiesHash != _propertiesHash) {
+        _propertiesHash = propertiesHash;
+        _propertiesDirty = true;
+    }
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &track = project.track(trackIndex);
+        if (track.trackMode() != _trackModes[trackIndex]) {
+            _trackModes[trackIndex] = track.trackMode();
+            _layoutDirty = true;
+        }
+        for (int pattern = 0; pattern < PatternCount; ++pattern) {
+            uint32_t hash = hashSequence(track, pattern);
+            if (hash != _sequenceHashes[trackIndex][pattern]) {
+                _sequenceHashes[trackIndex][pattern] = hash;
+                _sequencesDirty[trackIndex] |= 1u << pattern;
+            }
+        }
+    }
+}
+
+void ProjectDirtyState::commit() {
+    _valid = true;
+    _layoutDirty = false;
+    _propertiesDirty = false;
+    _sequencesDirty.fill(0);
+}
+
+bool ProjectDirtyState::dirty() const {
+    return propertiesDirty() || dirtySequenceCount() > 0;
+}
+
+int ProjectDirtyState::dirtySequenceCount() const {
+    if (!_valid) {
+        return CONFIG_TRACK_COUNT * PatternCount;
+    }
+    int count = 0;
+    for (auto dirty : _sequencesDirty) {
+        for (; dirty; dirty &= dirty - 1) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+uint32_t ProjectDirtyState::hashProperties(const Project &project) {
+    HashWriter hashWriter;
+    VersionedSerializedWriter writer(hashWriter, ProjectVersion::Latest);
+    project.writeProperties(writer);
+    return hashWriter.hash.result();
+}
+
+uint32_t ProjectDirtyState::hashSequence(const Track &track, int pattern) {
+    HashWriter hashWriter;
+    VersionedSerializedWriter writer(hashWriter, ProjectVersion::Latest);
+
+    switch (track.trackMode()) {
+    case Track::TrackMode::Note:
+        track.noteTrack().sequence(pattern).write(writer);
+        break;
+#if CONFIG_ENABLE_CURVE_TRACKS
+    case Track::TrackMode::Curve:
+        track.curveTrack().sequence(pattern).write(writer);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    return hashWriter.hash.result();
+}
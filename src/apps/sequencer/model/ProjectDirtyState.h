@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Config.h"
+#include "Project.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Tracks which parts of a project changed since it was last saved or loaded, at the granularity of the
+// project properties (everything but the sequences) and single track sequences.
+// Steps are edited through references handed out to the ui, the launchpad controller, generators and the
+// engine when recording, so instead of hooking setters the serialized data of every part is hashed and
+// compared against the hash of the saved data. Hashing a project takes a few milliseconds (file task only).
+class ProjectDirtyState {
+public:
+    static constexpr int PatternCount = CONFIG_PATTERN_COUNT + CONFIG_SNAPSHOT_COUNT;
+
+    static_assert(PatternCount <= 32, "dirty mask is limited to 32 patterns");
+
+    // forget the saved state, everything is dirty until the next commit
+    void invalidate();
+    bool valid() const { return _valid; }
+
+    // hashes the project and marks all parts that differ from the last commit as dirty
+    void update(const Project &project);
+    // marks all parts hashed by the last update as saved
+    void commit();
+
+    bool dirty() const;
+    // track modes changed
+    bool layoutDirty() const { return !_valid || _layoutDirty; }
+    bool propertiesDirty() const { return !_valid || _propertiesDirty; }
+    bool sequenceDirty(int track, int pattern) const { return !_valid || (_sequencesDirty[track] & (1u << pattern)); }
+    int dirtySequenceCount() const;
+
+private:
+    static uint32_t hashProperties(const Project &project);
+    static uint32_t hashSequence(const Track &track, int pattern);
+
+    bool _valid = false;
+    bool _layoutDirty = false;
+    bool _propertiesDirty = false;
+    std::array<Track::TrackMode, CONFIG_TRACK_COUNT> _trackModes;
+    uint32_t _propertiesHash = 0;
+    std::array<uint32_t, CONFIG_TRACK_COUNT> _sequencesDirty;
+    std::array<std::array<uint32_t, PatternCount>, CONFIG_TRACK_COUNT> _sequenceHashes;
+};
@@ -1,3 +1,5 @@
+#pragma once
+
 enum ProjectVersion {
     // added NoteTrack::cvUpdateMode
     Version4 = 4,
@@ -93,6 +95,12 @@ enum ProjectVersion {
     // added Project::midiIntegrationMode, Project::midiProgramOffset, Project::alwaysSync
     Version32 = 32,
 
+    // restored song slot, route and user scale counts (were reduced to 4, 4 and 1)
+    Version33 = 33,
+
+    // added Project::slideMode
+    Version34 = 34,
+
     // automatically derive latest version
     Last,
     Latest = Last - 1,
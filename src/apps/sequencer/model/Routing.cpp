@@ -232,7 +232,11 @@ void Routing::write(VersionedSerializedWriter &writer) const {
 }
 
 void Routing::read(VersionedSerializedReader &reader) {
-    readArray(reader, _routes);
+    if (reader.dataVersion() < ProjectVersion::Version33) {
+        readArray(reader, _routes, 4);
+    } else {
+        readArray(reader, _routes);
+    }
 }
 
 static std::array<uint16_t, size_t(Routing::Target::Last)> routedSet;
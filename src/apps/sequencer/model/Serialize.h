@@ -8,10 +8,12 @@
 #include <cstdlib>
 #include <cstdint>
 
+// every element ends with a checkpoint, snapshots copy each element (sequence, route, ...) in one piece
 template<typename T, size_t N>
 static void writeArray(VersionedSerializedWriter &writer, const std::array<T, N> &array) {
     for (size_t i = 0; i < array.size(); ++i) {
         array[i].write(writer);
+        writer.checkpoint();
     }
 }
 
@@ -2,6 +2,14 @@
 #include "FlashWriter.h"
 #include "FlashReader.h"
 
+#include "core/Debug.h"
+#include "core/hash/FnvHash.h"
+
+#include <algorithm>
+#include <array>
+
+#include <cstring>
+
 const char *Settings::Filename = "SETTINGS.DAT";
 
 Settings::Settings() {
@@ -34,26 +42,232 @@ bool Settings::read(VersionedSerializedReader &reader) {
     return success;
 }
 
-void Settings::writeToFlash() const {
-    FlashWriter flashWriter(CONFIG_SETTINGS_FLASH_ADDR, CONFIG_SETTINGS_FLASH_SECTOR);
+//----------------------------------------
+// Flash log
+//----------------------------------------
+
+// The settings sector starts with a magic word followed by records. Calibration and user settings are stored
+// in separate records, every write appends the records whose contents changed and the newest valid record of
+// each type wins. The state word of a record is programmed last and commits it, the payload is a serialized
+// part followed by its hash. When the sector is full, it is erased and the current records are written again.
+// Note: there is no second sector to copy to (bootloader, hardware config and firmware occupy the others),
+// settings written since the last save are lost if power fails between erasing and rewriting the sector.
+
+static constexpr uint32_t SectorAddress = CONFIG_SETTINGS_FLASH_ADDR;
+static constexpr uint32_t SectorSize = CONFIG_SETTINGS_FLASH_SECTOR_SIZE;
+static constexpr uint32_t SectorMagic = 0x474e5453; // STNG
+static constexpr uint32_t RecordCommitted = 0x44434552; // RECD
+
+enum class RecordType : uint8_t {
+    Calibration,
+    UserSettings,
+    Last
+};
+
+struct RecordHeader {
+    uint32_t state;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t size;
+
+    bool blank() const { return type == 0xff && reserved == 0xff && size == 0xffff; }
+    bool committed() const { return state == RecordCommitted; }
+};
+
+static_assert(sizeof(RecordHeader) == 8, "invalid record header size");
+
+static uint32_t recordSize(uint32_t payloadSize) {
+    return sizeof(RecordHeader) + ((payloadSize + 3) & ~3);
+}
+
+struct SettingsLog {
+    bool formatted;
+    // offset of the first free byte
+    uint32_t end;
+    // address of the newest valid record of each type, 0 if there is none
+    std::array<uint32_t, size_t(RecordType::Last)> records;
+};
+
+// the hash stored at the end of the payload
+static uint32_t recordHash(uint32_t address, const RecordHeader &header) {
+    uint32_t hash;
+    Flash::read(address + sizeof(RecordHeader) + header.size - sizeof(hash), &hash, sizeof(hash));
+    return hash;
+}
+
+// the payload starts with the writer version, which is not part of the hash
+static bool validRecord(uint32_t address, const RecordHeader &header) {
+    if (header.size < 2 * sizeof(uint32_t)) {
+        return false;
+    }
+    FnvHash hash;
+    uint32_t begin = address + sizeof(RecordHeader) + sizeof(uint32_t);
+    uint32_t end = address + sizeof(RecordHeader) + header.size - sizeof(uint32_t);
+    for (uint32_t offset = begin; offset < end; ) {
+        uint8_t buffer[64];
+        uint32_t chunk = std::min(uint32_t(sizeof(buffer)), end - offset);
+        Flash::read(offset, buffer, chunk);
+        hash(buffer, chunk);
+        offset += chunk;
+    }
+    return hash.result() == recordHash(address, header);
+}
+
+static SettingsLog scanLog() {
+    SettingsLog log;
+    log.end = SectorSize;
+    log.records.fill(0);
+
+    uint32_t magic;
+    Flash::read(SectorAddress, &magic, sizeof(magic));
+    log.formatted = magic == SectorMagic;
+    if (!log.formatted) {
+        return log;
+    }
+
+    uint32_t offset = sizeof(magic);
+    while (offset + sizeof(RecordHeader) <= SectorSize) {
+        uint32_t address = SectorAddress + offset;
+        RecordHeader header;
+        Flash::read(address, &header, sizeof(header));
+        if (header.blank()) {
+            break;
+        }
+        uint32_t size = recordSize(header.size);
+        if (header.type >= uint8_t(RecordType::Last) || offset + size > SectorSize) {
+            // corrupted header, do not append to this sector anymore
+            offset = SectorSize;
+            break;
+        }
+        if (header.committed() && validRecord(address, header)) {
+            log.records[header.type] = address;
+        }
+        offset += size;
+    }
+    log.end = offset;
+
+    return log;
+}
+
+// size and hash of a serialized part, the hash is the last thing written
+template<typename Part>
+static void measurePart(const Part &part, uint32_t &size, uint32_t &hash) {
+    size = 0;
+    VersionedSerializedWriter writer([&] (const void *data, size_t len) {
+        size += len;
+        if (len == sizeof(hash)) {
+            std::memcpy(&hash, data, sizeof(hash));
+        }
+    }, Settings::Version);
+    part.write(writer);
+    writer.writeHash();
+}
 
-    VersionedSerializedWriter writer(
-        [&flashWriter] (const void *data, size_t len) { flashWriter.write(data, len); },
-        Version
-    );
+template<typename Part>
+static void writeRecord(uint32_t address, RecordType type, uint32_t size, const Part &part) {
+    FlashWriter flashWriter(address + sizeof(uint32_t));
 
-    write(writer);
+    RecordHeader header;
+    header.type = uint8_t(type);
+    header.reserved = 0xff;
+    header.size = size;
+    flashWriter.write(&header.type, sizeof(RecordHeader) - sizeof(uint32_t));
+
+    VersionedSerializedWriter writer(flashWriter, Settings::Version);
+    part.write(writer);
+    writer.writeHash();
 
     flashWriter.finish();
+
+    Flash::program(address, RecordCommitted);
+}
+
+template<typename Part>
+static bool readRecord(uint32_t address, Part &part) {
+    if (address == 0) {
+        return false;
+    }
+    FlashReader flashReader(address + sizeof(RecordHeader));
+    VersionedSerializedReader reader(flashReader, Settings::Version);
+    part.read(reader);
+    return reader.checkHash();
+}
+
+void Settings::writeToFlash() const {
+    FlashLock flashLock;
+
+    auto log = scanLog();
+
+    struct {
+        uint32_t size;
+        uint32_t hash;
+        bool changed;
+    } parts[size_t(RecordType::Last)];
+
+    measurePart(_calibration, parts[0].size, parts[0].hash);
+    measurePart(_userSettings, parts[1].size, parts[1].hash);
+
+    uint32_t required = 0;
+    for (size_t type = 0; type < size_t(RecordType::Last); ++type) {
+        uint32_t address = log.records[type];
+        parts[type].changed = true;
+        if (address != 0) {
+            RecordHeader header;
+            Flash::read(address, &header, sizeof(header));
+            parts[type].changed = header.size != parts[type].size || recordHash(address, header) != parts[type].hash;
+        }
+        if (parts[type].changed) {
+            required += recordSize(parts[type].size);
+        }
+    }
+
+    if (required == 0) {
+        return;
+    }
+
+    if (!log.formatted || log.end + required > SectorSize) {
+        DBG("settings: erasing flash sector");
+        Flash::unlock();
+        Flash::eraseSector(CONFIG_SETTINGS_FLASH_SECTOR);
+        Flash::program(SectorAddress, SectorMagic);
+        Flash::lock();
+        log.end = sizeof(uint32_t);
+        for (auto &part : parts) {
+            part.changed = true;
+        }
+    }
+
+    if (parts[0].changed) {
+        writeRecord(SectorAddress + log.end, RecordType::Calibration, parts[0].size, _calibration);
+        log.end += recordSize(parts[0].size);
+    }
+    if (parts[1].changed) {
+        writeRecord(SectorAddress + log.end, RecordType::UserSettings, parts[1].size, _userSettings);
+        log.end += recordSize(parts[1].size);
+    }
 }
 
 bool Settings::readFromFlash() {
-    FlashReader flashReader(CONFIG_SETTINGS_FLASH_ADDR);
+    auto log = scanLog();
 
-    VersionedSerializedReader reader(
-        [&flashReader] (void *data, size_t len) { flashReader.read(data, len); },
-        Version
-    );
+    if (!log.formatted) {
+        // single image written by earlier firmware, converted to a log on the next write
+        FlashReader flashReader(SectorAddress);
+        VersionedSerializedReader reader(flashReader, Version);
+        return read(reader);
+    }
+
+    clear();
 
-    return read(reader);
+    bool success = true;
+    if (!readRecord(log.records[size_t(RecordType::Calibration)], _calibration)) {
+        _calibration.clear();
+        success = false;
+    }
+    if (!readRecord(log.records[size_t(RecordType::UserSettings)], _userSettings)) {
+        _userSettings.clear();
+        success = false;
+    }
+
+    return success;
 }
@@ -6,7 +6,7 @@
 
 class Settings {
 public:
-    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t Version = 2; // 2: autosave user setting
 
     static const char *Filename;
 
@@ -23,6 +23,9 @@ public:
     void write(VersionedSerializedWriter &writer) const;
     bool read(VersionedSerializedReader &reader);
 
+    // the settings flash sector holds a log of calibration and user settings records (see Settings.cpp)
+    // writing only appends the records that changed, the sector is erased when it is full
+    // writing is serialized with the other flash writers (see FlashLock)
     void writeToFlash() const;
     bool readFromFlash();
 
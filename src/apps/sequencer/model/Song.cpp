@@ -135,6 +135,8 @@ void Song::write(VersionedSerializedWriter &writer) const {
 void Song::read(VersionedSerializedReader &reader) {
     if (reader.dataVersion() < ProjectVersion::Version18) {
         readArray(reader, _slots, 16);
+    } else if (reader.dataVersion() < ProjectVersion::Version33) {
+        readArray(reader, _slots, 4);
     } else {
         readArray(reader, _slots);
     }
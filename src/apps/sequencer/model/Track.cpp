@@ -90,17 +90,17 @@ void Track::cvOutputName(int index, StringBuilder &str) const {
     }
 }
 
-void Track::write(VersionedSerializedWriter &writer) const {
+void Track::write(VersionedSerializedWriter &writer, bool withSequences) const {
     writer.writeEnum(_trackMode, trackModeSerialize);
     writer.write(_linkTrack);
 
     switch (_trackMode) {
     case TrackMode::Note:
-        _track.note->write(writer);
+        _track.note->write(writer, withSequences);
         break;
 #if CONFIG_ENABLE_CURVE_TRACKS
     case TrackMode::Curve:
-        _track.curve->write(writer);
+        _track.curve->write(writer, withSequences);
         break;
 #endif
 #if CONFIG_ENABLE_MIDICV_TRACKS
@@ -113,19 +113,23 @@ void Track::write(VersionedSerializedWriter &writer) const {
     }
 }
 
-void Track::read(VersionedSerializedReader &reader) {
+void Track::read(VersionedSerializedReader &reader, bool withSequences) {
+    auto trackMode = _trackMode;
     reader.readEnum(_trackMode, trackModeSerialize);
     reader.read(_linkTrack);
 
-    initContainer();
+    // keep the sequences when only reading the properties
+    if (withSequences || _trackMode != trackMode) {
+        initContainer();
+    }
 
     switch (_trackMode) {
     case TrackMode::Note:
-        _track.note->read(reader);
+        _track.note->read(reader, withSequences);
         break;
 #if CONFIG_ENABLE_CURVE_TRACKS
     case TrackMode::Curve:
-        _track.curve->read(reader);
+        _track.curve->read(reader, withSequences);
         break;
 #endif
 #if CONFIG_ENABLE_MIDICV_TRACKS
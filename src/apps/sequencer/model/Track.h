@@ -143,8 +143,9 @@ public:
     void gateOutputName(int index, StringBuilder &str) const;
     void cvOutputName(int index, StringBuilder &str) const;
 
-    void write(VersionedSerializedWriter &writer) const;
-    void read(VersionedSerializedReader &reader);
+    // the sequences can be left out to serialize the track properties only (see ProjectDirtyState)
+    void write(VersionedSerializedWriter &writer, bool withSequences = true) const;
+    void read(VersionedSerializedReader &reader, bool withSequences = true);
 
     Track &operator=(const Track &other) {
         ASSERT(_trackMode == other._trackMode, "invalid track mode");
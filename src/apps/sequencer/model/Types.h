@@ -114,6 +114,25 @@ public:
         return nullptr;
     }
 
+    // SlideMode
+
+    enum class SlideMode : uint8_t {
+        Exponential,
+        Linear,
+        ConstantTime,
+        Last
+    };
+
+    static const char *slideModeName(SlideMode slideMode) {
+        switch (slideMode) {
+        case SlideMode::Exponential:    return "Exponential";
+        case SlideMode::Linear:         return "Linear";
+        case SlideMode::ConstantTime:   return "Const. Time";
+        case SlideMode::Last:           break;
+        }
+        return nullptr;
+    }
+
     // PlayMode
 
     enum class PlayMode : uint8_t {
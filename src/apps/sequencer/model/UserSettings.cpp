@@ -1,44 +1,139 @@
 #include "UserSettings.h"
 
-void UserSettings::set(int key, int value) {
-    _settings[key]->setValue(value);
-}
+#include "core/math/Math.h"
+
+// Brightness
+
+const char * const UserSettingTraits<UserSetting::Brightness>::Name = "Brightness";
+const char * const UserSettingTraits<UserSetting::Brightness>::ItemNames[] = {
+    "1", "2", "3", "4", "5", "6", "7", "8", "9", "10"
+};
+const float UserSettingTraits<UserSetting::Brightness>::ItemValues[] = {
+    0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.f
+};
+
+// Screensaver
+
+const char * const UserSettingTraits<UserSetting::Screensaver>::Name = "Screensaver";
+const char * const UserSettingTraits<UserSetting::Screensaver>::ItemNames[] = {
+    "off", "3s", "5s", "10s", "30s", "1m", "10m", "30m"
+};
+const uint32_t UserSettingTraits<UserSetting::Screensaver>::ItemValues[] = {
+    0, 3000, 5000, 10000, 30000, 60000, 600000, 1800000
+};
+
+// WakeMode
+
+const char * const UserSettingTraits<UserSetting::WakeMode>::Name = "Wake Mode";
+const char * const UserSettingTraits<UserSetting::WakeMode>::ItemNames[] = {
+    "always", "required"
+};
+const int UserSettingTraits<UserSetting::WakeMode>::ItemValues[] = {
+    0, 1
+};
+
+// DimSequence
+
+const char * const UserSettingTraits<UserSetting::DimSequence>::Name = "Dim Sequence";
+const char * const UserSettingTraits<UserSetting::DimSequence>::ItemNames[] = {
+    "off", "on"
+};
+const bool UserSettingTraits<UserSetting::DimSequence>::ItemValues[] = {
+    false, true
+};
+
+// Autosave
+
+const char * const UserSettingTraits<UserSetting::Autosave>::Name = "Autosave";
+const char * const UserSettingTraits<UserSetting::Autosave>::ItemNames[] = {
+    "off", "1m", "5m", "10m", "30m"
+};
+const uint32_t UserSettingTraits<UserSetting::Autosave>::ItemValues[] = {
+    0, 60000, 300000, 600000, 1800000
+};
+
+//----------------------------------------
+// UserSettings
+//----------------------------------------
 
-void UserSettings::shift(int key, int shift) {
-    _settings[key]->shiftValue(shift);
+template<UserSetting S>
+constexpr UserSettings::Entry UserSettings::entry() {
+    return {
+        &UserSettingTraits<S>::Name,
+        UserSettingTraits<S>::ItemNames,
+        UserSettingTraits<S>::DefaultItem,
+        &UserSettings::item<S>,
+        &UserSettings::setItem<S>,
+        &UserSettings::readValue<S>,
+        &UserSettings::writeValue<S>
+    };
 }
 
-BaseSetting *UserSettings::_get(const std::string& key) {
-    for (auto &setting : _settings) {
-        if (setting->getKey() == key) {
-            return setting;
+const UserSettings::Entry UserSettings::_entries[] = {
+    entry<UserSetting::Brightness>(),
+    entry<UserSetting::Screensaver>(),
+    entry<UserSetting::WakeMode>(),
+    entry<UserSetting::DimSequence>(),
+    entry<UserSetting::Autosave>(),
+};
+
+template<UserSetting S>
+int UserSettings::item() const {
+    for (int i = 0; i < UserSettingTraits<S>::ItemCount; ++i) {
+        if (UserSettingTraits<S>::ItemValues[i] == get<S>()) {
+            return i;
         }
     }
-    return nullptr;
+    return -1;
+}
+
+template<UserSetting S>
+void UserSettings::setItem(int item) {
+    get<S>() = UserSettingTraits<S>::ItemValues[clamp(item, 0, UserSettingTraits<S>::ItemCount - 1)];
+}
+
+template<UserSetting S>
+void UserSettings::readValue(VersionedSerializedReader &reader) {
+    reader.read(get<S>(), UserSettingTraits<S>::AddedInVersion);
+    if (item<S>() < 0) {
+        setItem<S>(UserSettingTraits<S>::DefaultItem);
+    }
 }
 
-BaseSetting *UserSettings::get(int key) {
-    return _settings[key];
+template<UserSetting S>
+void UserSettings::writeValue(VersionedSerializedWriter &writer) const {
+    writer.write(get<S>());
 }
 
-std::vector<BaseSetting *> UserSettings::all() {
-    return _settings;
+const char *UserSettings::name(int index) const {
+    return *_entries[index].name;
+}
+
+const char *UserSettings::itemName(int index) const {
+    const auto &entry = _entries[index];
+    int item = (this->*entry.item)();
+    return item >= 0 ? entry.itemNames[item] : "-";
+}
+
+void UserSettings::shift(int index, int shift) {
+    const auto &entry = _entries[index];
+    (this->*entry.setItem)((this->*entry.item)() + shift);
 }
 
 void UserSettings::clear() {
-    for (auto &setting : _settings) {
-        setting->reset();
+    for (const auto &entry : _entries) {
+        (this->*entry.setItem)(entry.defaultItem);
     }
 }
 
 void UserSettings::write(VersionedSerializedWriter &writer) const {
-    for (auto &setting : _settings) {
-        setting->write(writer);
+    for (const auto &entry : _entries) {
+        (this->*entry.write)(writer);
     }
 }
 
 void UserSettings::read(VersionedSerializedReader &reader) {
-    for (auto &setting : _settings) {
-        setting->read(reader);
+    for (const auto &entry : _entries) {
+        (this->*entry.read)(reader);
     }
-}
\ No newline at end of file
+}
@@ -1,178 +1,153 @@
 #pragma once
 
-#include <core/io/VersionedSerializedWriter.h>
-#include <core/io/VersionedSerializedReader.h>
-#include <unordered_map>
-#include <vector>
-#include <algorithm>
-#include <string>
-
-#define SettingBrightness "brightness"
-#define SettingScreensaver "screensaver"
-#define SettingWakeMode "wakemode"
-#define SettingDimSequence "dimsequence"
-
-class BaseSetting {
-public:
-    virtual std::string getKey() = 0;
-    virtual void shiftValue(int shift) = 0;
-    virtual void setValue(int value) = 0;
-    virtual std::string getMenuItem() = 0;
-    virtual std::string getMenuItemKey() = 0;
-    virtual void read(VersionedSerializedReader &writer) = 0;
-    virtual void write(VersionedSerializedWriter &writer) = 0;
-    virtual void reset() = 0;
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/io/VersionedSerializedReader.h"
+
+#include <tuple>
+
+#include <cstddef>
+#include <cstdint>
+
+// Keys of the user settings, in the order they are listed and serialized.
+enum class UserSetting : uint8_t {
+    Brightness,
+    Screensaver,
+    WakeMode,
+    DimSequence,
+    Autosave,
+    Last
 };
 
-template<typename T>
-class Setting : public BaseSetting {
-public:
-    Setting(
-        std::string key,
-        std::string menuItem,
-        std::vector<std::string> menuItemKeys,
-        std::vector<T> menuItemValues,
-        T defaultValue
-    ) :
-        _value(defaultValue),
-        _key(std::move(key)),
-        _menuItem(std::move(menuItem)),
-        _menuItemKeys(std::move(menuItemKeys)),
-        _menuItemValues(std::move(menuItemValues)),
-        _defaultValue(defaultValue)
-    {}
-
-    std::string getKey() override {
-        return _key;
-    }
-
-    std::string getMenuItem() override {
-        return _menuItem;
-    }
-
-    std::string getMenuItemKey() override {
-        return _menuItemKeys[getCurrentIndex()];
-    }
-
-    void setValue(int index) override {
-        unsigned int validIndex = (index >= 0) ? index : 0;
-        if (validIndex > _menuItemValues.size() - 1) validIndex = _menuItemValues.size() - 1;
-        _value = _menuItemValues[validIndex];
-    };
-
-    void shiftValue(int shift) override {
-        setValue(getCurrentIndex() + shift);
-    };
-
-    T &getValue() {
-        return _value;
-    };
-
-    const T &getValue() const {
-        return _value;
-    }
-
-    void reset() override {
-        _value = _defaultValue;
-    };
-
-    void read(VersionedSerializedReader &reader) override {
-        reader.read(getValue());
-    };
-
-    void write(VersionedSerializedWriter &writer) override {
-        writer.write(getValue());
-    };
-
-private:
-    int getCurrentIndex() {
-        auto it = std::find(_menuItemValues.begin(), _menuItemValues.end(), _value);
-        return std::distance(_menuItemValues.begin(), it);
-    }
-
-    T _value;
-
-    std::string _key;
-    std::string _menuItem;
-    std::vector<std::string> _menuItemKeys;
-    std::vector<T> _menuItemValues;
-    T _defaultValue;
+// Compile-time description of a user setting: value type, menu name, menu items and default item.
+// The menu tables are constant and live in flash (see UserSettings.cpp).
+template<UserSetting S>
+struct UserSettingTraits;
+
+template<>
+struct UserSettingTraits<UserSetting::Brightness> {
+    typedef float Type;
+    static constexpr int ItemCount = 10;
+    static constexpr int DefaultItem = 9;
+    static constexpr uint32_t AddedInVersion = 0;
+    static const char * const Name;
+    static const char * const ItemNames[ItemCount];
+    static const Type ItemValues[ItemCount];
 };
 
-class BrightnessSetting : public Setting<float> {
-public:
-    BrightnessSetting() : Setting(
-            SettingBrightness,
-            "Brightness",
-            {"1", "2", "3", "4", "5", "6", "7", "8", "9", "10"},
-            {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0},
-            1.0
-    ) {}
+template<>
+struct UserSettingTraits<UserSetting::Screensaver> {
+    typedef uint32_t Type;
+    static constexpr int ItemCount = 8;
+    static constexpr int DefaultItem = 0;
+    static constexpr uint32_t AddedInVersion = 0;
+    static const char * const Name;
+    static const char * const ItemNames[ItemCount];
+    static const Type ItemValues[ItemCount];
 };
 
-class ScreensaverSetting : public Setting<uint32_t> {
-public:
-    ScreensaverSetting() : Setting(
-            SettingScreensaver,
-            "Screensaver",
-            {"off", "3s", "5s", "10s", "30s", "1m", "10m", "30m"},
-            {0, 3000,  5000,  10000, 30000, 60000, 600000, 1800000},
-            0
-    ) {}
+template<>
+struct UserSettingTraits<UserSetting::WakeMode> {
+    typedef int Type;
+    static constexpr int ItemCount = 2;
+    static constexpr int DefaultItem = 0;
+    static constexpr uint32_t AddedInVersion = 0;
+    static const char * const Name;
+    static const char * const ItemNames[ItemCount];
+    static const Type ItemValues[ItemCount];
 };
 
-class WakeModeSetting : public Setting<int> {
-public:
-    WakeModeSetting() : Setting(
-            SettingWakeMode,
-            "Wake Mode",
-            {"always", "required"},
-            {0, 1},
-            0
-    ) {}
+template<>
+struct UserSettingTraits<UserSetting::DimSequence> {
+    typedef bool Type;
+    static constexpr int ItemCount = 2;
+    static constexpr int DefaultItem = 0;
+    static constexpr uint32_t AddedInVersion = 0;
+    static const char * const Name;
+    static const char * const ItemNames[ItemCount];
+    static const Type ItemValues[ItemCount];
 };
 
-class DimSequenceSetting : public Setting<bool> {
-public:
-    DimSequenceSetting() : Setting(
-            SettingDimSequence,
-            "Dim Sequence",
-            {"off", "on"},
-            {false, true},
-            false
-    ) {}
+template<>
+struct UserSettingTraits<UserSetting::Autosave> {
+    typedef uint32_t Type;
+    static constexpr int ItemCount = 5;
+    static constexpr int DefaultItem = 0;
+    static constexpr uint32_t AddedInVersion = 2;
+    static const char * const Name;
+    static const char * const ItemNames[ItemCount];
+    static const Type ItemValues[ItemCount];
 };
 
+// User settings stored in a plain struct (tuple) indexed by the setting key.
+// Typed access through get<UserSetting::X>() resolves at compile time and never allocates, values can be
+// referenced directly (e.g. the canvas holds a reference to the brightness).
 class UserSettings {
 public:
+    template<UserSetting S>
+    using Type = typename UserSettingTraits<S>::Type;
+
+    static constexpr int Count = int(UserSetting::Last);
+
     UserSettings() {
-        addSetting(new BrightnessSetting());
-        addSetting(new ScreensaverSetting());
-        addSetting(new WakeModeSetting());
-        addSetting(new DimSequenceSetting());
+        clear();
     }
 
     //----------------------------------------
     // Methods
     //----------------------------------------
 
-    void set(int key, int value);
-    void shift(int key, int shift);
-    BaseSetting *get(int key);
-    template<typename S>
-    S *get(std::string key) { return dynamic_cast<S *>(_get(key)); }
-    std::vector<BaseSetting *> all();
+    template<UserSetting S>
+    Type<S> &get() { return std::get<size_t(S)>(_values); }
+
+    template<UserSetting S>
+    const Type<S> &get() const { return std::get<size_t(S)>(_values); }
+
+    // menu access by index, used by the settings list
+    const char *name(int index) const;
+    const char *itemName(int index) const;
+    void shift(int index, int shift);
 
     void clear();
     void write(VersionedSerializedWriter &writer) const;
     void read(VersionedSerializedReader &reader);
 
 private:
-    std::vector<BaseSetting *> _settings;
+    // type erased operations of a setting, one constant table entry per key
+    struct Entry {
+        const char * const *name;
+        const char * const *itemNames;
+        int defaultItem;
+        int (UserSettings::*item)() const;
+        void (UserSettings::*setItem)(int item);
+        void (UserSettings::*read)(VersionedSerializedReader &reader);
+        void (UserSettings::*write)(VersionedSerializedWriter &writer) const;
+    };
 
-    template<typename T>
-    void addSetting(Setting<T> *setting) {
-        _settings.push_back(setting);
-    }
-    BaseSetting *_get(const std::string &key);
+    template<UserSetting S>
+    static constexpr Entry entry();
+
+    // index of the current value in the menu items, -1 if the value is not in the menu
+    template<UserSetting S>
+    int item() const;
+
+    template<UserSetting S>
+    void setItem(int item);
+
+    template<UserSetting S>
+    void readValue(VersionedSerializedReader &reader);
+
+    template<UserSetting S>
+    void writeValue(VersionedSerializedWriter &writer) const;
+
+    static const Entry _entries[Count];
+
+    std::tuple<
+        Type<UserSetting::Brightness>,
+        Type<UserSetting::Screensaver>,
+        Type<UserSetting::WakeMode>,
+        Type<UserSetting::DimSequence>,
+        Type<UserSetting::Autosave>
+    > _values;
+
+    static_assert(std::tuple_size<decltype(_values)>::value == Count, "one value per setting");
 };
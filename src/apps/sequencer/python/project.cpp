@@ -68,6 +68,7 @@ void register_project(py::module &m) {
         .def_property_readonly("midiInputSource", [] (Project &project) { return &project.midiInputSource(); })
         .def_property("cvGateInput", &Project::cvGateInput, &Project::setCvGateInput)
         .def_property("curveCvInput", &Project::curveCvInput, &Project::setCurveCvInput)
+        .def_property("slideMode", &Project::slideMode, &Project::setSlideMode)
         .def_property_readonly("clockSetup", [] (Project &project) { return &project.clockSetup(); })
         .def_property_readonly("tracks", [] (Project &project) {
             py::list result;
@@ -141,6 +142,13 @@ void register_project(py::module &m) {
         .export_values()
     ;
 
+    py::enum_<Types::SlideMode>(types, "SlideMode")
+        .value("Exponential", Types::SlideMode::Exponential)
+        .value("Linear", Types::SlideMode::Linear)
+        .value("ConstantTime", Types::SlideMode::ConstantTime)
+        .export_values()
+    ;
+
     py::enum_<Types::PlayMode>(types, "PlayMode")
         .value("Aligned", Types::PlayMode::Aligned)
         .value("Free", Types::PlayMode::Free)
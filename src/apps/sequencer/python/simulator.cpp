@@ -1,6 +1,7 @@
 #include "sim/Simulator.h"
 
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 
@@ -21,7 +22,55 @@ void register_simulator(py::module &m) {
         .def("setDio", &Simulator::setDio)
         .def("sendMidi", &Simulator::sendMidi)
         .def("screenshot", &Simulator::screenshot)
+        .def("requestFrame", &Simulator::requestFrame)
+        .def_property("headless", &Simulator::headless, &Simulator::setHeadless)
         .def_property_readonly("targetState", &Simulator::targetState, py::return_value_policy::reference)
+        .def_property_readonly("outputJitterMonitor", &Simulator::outputJitterMonitor, py::return_value_policy::reference)
+        .def_property_readonly("outputTrace", &Simulator::outputTrace, py::return_value_policy::reference)
+    ;
+
+    // ------------------------------------------------------------------------
+    // OutputJitterMonitor
+    // ------------------------------------------------------------------------
+
+    py::class_<OutputJitterMonitor> outputJitterMonitor(m, "OutputJitterMonitor");
+    outputJitterMonitor
+        .def("reset", &OutputJitterMonitor::reset)
+        .def("dump", [] (const OutputJitterMonitor &monitor) { monitor.dump(); })
+        .def_property_readonly("edges", &OutputJitterMonitor::edges)
+        .def_property_readonly("summary", &OutputJitterMonitor::summary)
+    ;
+
+    py::class_<OutputJitterMonitor::Edge> edge(outputJitterMonitor, "Edge");
+    edge
+        .def_readonly("channel", &OutputJitterMonitor::Edge::channel)
+        .def_readonly("value", &OutputJitterMonitor::Edge::value)
+        .def_readonly("time", &OutputJitterMonitor::Edge::time)
+        .def_readonly("jitter", &OutputJitterMonitor::Edge::jitter)
+    ;
+
+    py::class_<OutputJitterMonitor::Summary> summary(outputJitterMonitor, "Summary");
+    summary
+        .def_readonly("count", &OutputJitterMonitor::Summary::count)
+        .def_readonly("min", &OutputJitterMonitor::Summary::min)
+        .def_readonly("avg", &OutputJitterMonitor::Summary::avg)
+        .def_readonly("max", &OutputJitterMonitor::Summary::max)
+    ;
+
+    // ------------------------------------------------------------------------
+    // OutputTrace
+    // ------------------------------------------------------------------------
+
+    py::class_<OutputTrace> outputTrace(m, "OutputTrace");
+    outputTrace
+        .def("start", &OutputTrace::start)
+        .def("stop", &OutputTrace::stop)
+        .def("clear", &OutputTrace::clear)
+        .def("text", &OutputTrace::text)
+        .def("saveToText", &OutputTrace::saveToText)
+        .def("hash", &OutputTrace::hash)
+        .def("__len__", [] (const OutputTrace &trace) { return trace.events().size(); })
+        .def_property_readonly("recording", &OutputTrace::recording)
     ;
 
     // ------------------------------------------------------------------------
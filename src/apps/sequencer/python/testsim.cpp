@@ -10,10 +10,12 @@ void register_simulator(py::module &m);
 void register_sequencer(py::module &m);
 
 struct Environment {
-    Environment() {
+    // headless environments skip rendering the display, the seed makes runs with random elements reproducible
+    Environment(bool headless, uint32_t seed) {
         simulator.reset(new sim::Simulator({
-            .create = [this] () {
+            .create = [this, seed] () {
                 sequencer.reset(new SequencerApp());
+                sequencer->engine.seedRandom(seed);
             },
             .destroy = [this] () {
                 sequencer.reset();
@@ -22,6 +24,7 @@ struct Environment {
                 sequencer->update();
             }
         }));
+        simulator->setHeadless(headless);
     }
 
     std::unique_ptr<SequencerApp> sequencer;
@@ -45,7 +48,7 @@ PYBIND11_MODULE(testsim, m) {
 
     py::class_<Environment> environment(m, "Environment", py::dynamic_attr());
     environment
-        .def(py::init<>())
+        .def(py::init<bool, uint32_t>(), py::arg("headless") = false, py::arg("seed") = 0)
 
         .def_property_readonly("simulator", [] (Environment &env) {
             return env.simulator.get();
@@ -0,0 +1,30 @@
+import sys
+import testframework as tf
+
+# Measures the timing of gate output edges relative to the clock ticks.
+# usage: output-jitter.py [tempo] [duration in ms]
+
+tempo = float(sys.argv[1]) if len(sys.argv) > 1 else 120
+duration = int(sys.argv[2]) if len(sys.argv) > 2 else 4000
+
+env = tf.Environment()
+c = tf.Controller(env.simulator)
+c.wait(3000)
+
+project = env.sequencer.model.project
+project.tempo = tempo
+
+# enable all steps on the first 8 tracks
+for trackIndex in range(8):
+    sequence = project.tracks[trackIndex].noteTrack.sequences[0]
+    for step in sequence.steps:
+        step.gate = True
+
+monitor = env.simulator.outputJitterMonitor
+
+c.press("play").wait(100)
+monitor.reset()
+c.wait(duration)
+c.press("play")
+
+monitor.dump()
@@ -0,0 +1,37 @@
+import sys
+import time
+import testframework as tf
+
+# Runs the sequencer headless and records a trace of the gate, cv and midi outputs.
+# Traces of the same duration and seed are identical, compare the hash (or the trace file) against a known good run.
+# usage: output-trace.py [duration in minutes] [seed] [trace file]
+
+minutes = float(sys.argv[1]) if len(sys.argv) > 1 else 10
+seed = int(sys.argv[2]) if len(sys.argv) > 2 else 0
+filename = sys.argv[3] if len(sys.argv) > 3 else None
+
+env = tf.Environment(headless=True, seed=seed)
+c = tf.Controller(env.simulator)
+c.wait(3000)
+
+# enable all steps on the first 8 tracks
+project = env.sequencer.model.project
+for trackIndex in range(8):
+    sequence = project.tracks[trackIndex].noteTrack.sequences[0]
+    for step in sequence.steps:
+        step.gate = True
+
+trace = env.simulator.outputTrace
+
+start = time.time()
+trace.start()
+c.press("play")
+c.wait(int(minutes * 60000))
+c.press("play")
+trace.stop()
+elapsed = time.time() - start
+
+if filename:
+    trace.saveToText(filename)
+
+print("%d events in %.1f simulated minutes (%.1f s), hash %016x" % (len(trace), minutes, elapsed, trace.hash()))
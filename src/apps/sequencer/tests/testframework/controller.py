@@ -138,6 +138,7 @@ class Controller:
         return self
 
     def screenshot(self, filename):
+        self._simulator.requestFrame()
         self.wait(50)
         (name, ext) = os.path.splitext(filename)
         filename = os.path.join(self._screenshotDir, name + ".png")
@@ -14,3 +14,7 @@ Controller::~Controller() {
 bool Controller::sendMidi(uint8_t cable, const MidiMessage &message) {
     return _manager.sendMidi(cable, message);
 }
+
+bool Controller::sendSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+    return _manager.sendSysEx(cable, data, length);
+}
@@ -29,6 +29,7 @@ public:
 
 protected:
     bool sendMidi(uint8_t cable, const MidiMessage &message);
+    bool sendSysEx(uint8_t cable, const uint8_t *data, size_t length);
 
     ControllerManager &_manager;
     Model &_model;
@@ -65,3 +65,7 @@ bool ControllerManager::recvMidi(MidiPort port, uint8_t cable, const MidiMessage
 bool ControllerManager::sendMidi(uint8_t cable, const MidiMessage &message) {
     return _engine.sendMidi(_port, cable, message);
 }
+
+bool ControllerManager::sendSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+    return _engine.sendSysEx(_port, cable, data, length);
+}
@@ -28,6 +28,7 @@ public:
 
 private:
     bool sendMidi(uint8_t cable, const MidiMessage &message);
+    bool sendSysEx(uint8_t cable, const uint8_t *data, size_t length);
 
     Model &_model;
     Engine &_engine;
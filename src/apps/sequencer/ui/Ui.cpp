@@ -16,7 +16,7 @@ Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &en
         _blm(blm),
         _encoder(encoder),
         _frameBuffer(CONFIG_LCD_WIDTH, CONFIG_LCD_HEIGHT, _frameBufferData),
-        _canvas(_frameBuffer, settings.userSettings().get<BrightnessSetting>(SettingBrightness)->getValue()),
+        _canvas(_frameBuffer, settings.userSettings().get<UserSetting::Brightness>()),
         _pageManager(_pages),
         _pageContext({ _messageManager, _pageKeyState, _globalKeyState, _model, _engine }),
         _pages(_pageManager, _pageContext),
@@ -24,8 +24,8 @@ Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &en
         // TODO pass as arg
         _screensaver(Screensaver(
                 _canvas,
-                settings.userSettings().get<ScreensaverSetting>(SettingScreensaver)->getValue(),
-                settings.userSettings().get<WakeModeSetting>(SettingWakeMode)->getValue()
+                settings.userSettings().get<UserSetting::Screensaver>(),
+                settings.userSettings().get<UserSetting::WakeMode>()
         ))
 {
 }
@@ -46,11 +46,10 @@ void Ui::init() {
     _pageManager.push(&_pages.startup);
 
     _engine.setMidiReceiveHandler([this] (MidiPort port, uint8_t cable, const MidiMessage &message) {
-        if (!_receiveMidiEvents.writable()) {
-            DBG("ui midi buffer overflow");
-            _receiveMidiEvents.read();
+        // engine task is the only producer, drop the message if the ui task falls behind
+        if (!_receiveMidiEvents.write({ port, cable, message })) {
+            _engine.midiReceiveOverflow();
         }
-        _receiveMidiEvents.write({ port, cable, message });
         return port == MidiPort::UsbMidi && _controllerManager.isConnected();
     });
 
@@ -76,6 +75,7 @@ void Ui::update() {
     handleKeys();
     handleEncoder();
     handleMidi();
+    handleSysExTransfer();
 
     // abort if track engines are not consistent with model
     if (!_engine.trackEnginesConsistent()) {
@@ -91,14 +91,22 @@ void Ui::update() {
     uint32_t intervalTicks = os::time::ms(1000 / _pageManager.fps());
     if (currentTicks - _lastFrameBufferUpdateTicks >= intervalTicks) {
         _screensaver.incScreenOnTicks(intervalTicks);
+        // rendering is skipped when the simulator runs headless, messages still time out
+        bool render = _lcd.visible();
         if (!_screensaver.shouldBeOn()) {
-            _pageManager.draw(_canvas);
+            if (render) {
+                _pageManager.draw(_canvas);
+            }
             _messageManager.update();
-            _messageManager.draw(_canvas);
-        } else {
+            if (render) {
+                _messageManager.draw(_canvas);
+            }
+        } else if (render) {
             _screensaver.on(_engine.gateOutput());
         }
-        _lcd.draw(_frameBuffer.data());
+        if (render) {
+            _lcd.draw(_frameBuffer);
+        }
         _lastFrameBufferUpdateTicks += intervalTicks;
     }
 
@@ -129,7 +137,7 @@ void Ui::showAssert(const char *filename, int line, const char *msg) {
 
     _canvas.drawText(4, 58, "PRESS ENCODER TO RESET");
 
-    _lcd.draw(_frameBuffer.data());
+    _lcd.draw(_frameBuffer, true);
 }
 
 void Ui::handleKeys() {
@@ -182,6 +190,30 @@ void Ui::handleEncoder() {
     }
 }
 
+// records loaded through sysex are applied like a project loaded from the sd card, the busy page stays up until
+// no record arrived for a while
+void Ui::handleSysExTransfer() {
+    auto &sysExTransfer = _engine.sysExTransfer();
+    uint32_t currentTicks = os::ticks();
+
+    // engine is suspended by a file operation, apply once it completed
+    if (sysExTransfer.recordPending() && !_engine.isSuspended()) {
+        if (!_sysExLoading) {
+            _pages.busy.show("LOADING SYSEX ...");
+            _sysExLoading = true;
+        }
+        _engine.suspend();
+        sysExTransfer.applyPendingRecord();
+        _engine.resume();
+        _lastSysExRecordTicks = currentTicks;
+    }
+
+    if (_sysExLoading && currentTicks - _lastSysExRecordTicks >= os::time::ms(500) && !sysExTransfer.recordPending()) {
+        _pages.busy.close();
+        _sysExLoading = false;
+    }
+}
+
 void Ui::handleMidi() {
     while (_receiveMidiEvents.readable()) {
         auto receiveEvent = _receiveMidiEvents.read();
@@ -40,6 +40,7 @@ private:
     void handleKeys();
     void handleEncoder();
     void handleMidi();
+    void handleSysExTransfer();
 
     Model &_model;
     Engine &_engine;
@@ -55,8 +56,11 @@ private:
     };
     RingBuffer<ReceiveMidiEvent, 16> _receiveMidiEvents;
 
-    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT];
-    FrameBuffer8bit _frameBuffer;
+    bool _sysExLoading = false;
+    uint32_t _lastSysExRecordTicks;
+
+    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT / 2];
+    FrameBuffer4bit _frameBuffer;
     Canvas _canvas;
     uint32_t _lastFrameBufferUpdateTicks;
 
@@ -124,6 +124,10 @@ LaunchpadController::LaunchpadController(ControllerManager &manager, Model &mode
         return sendMidi(cable, message);
     });
 
+    _device->setSendSysExHandler([this] (uint8_t cable, const uint8_t *data, size_t length) {
+        return sendSysEx(cable, data, length);
+    });
+
     _device->setButtonHandler([this] (int row, int col, bool state) {
         // DBG("button %d/%d - %d", row, col, state);
         if (state) {
@@ -640,6 +644,18 @@ void LaunchpadController::patternDraw() {
         navigationDraw(_pattern.navigation);
     } else {
         for (int trackIndex = 0; trackIndex < 8; ++trackIndex) {
+            int pattern = playState.trackState(trackIndex).pattern();
+            int requestedPattern = playState.trackState(trackIndex).requestedPattern();
+
+            // bank patterns have no grid cell, light the column of the track instead (selected -> medium green,
+            // requested -> dim green)
+            if (PlayState::isBankPattern(pattern) || PlayState::isBankPattern(requestedPattern)) {
+                Color color = PlayState::isBankPattern(pattern) ? colorGreen(2) : colorGreen(1);
+                for (int row = 0; row < 8; ++row) {
+                    setGridLed(row, trackIndex, color);
+                }
+            }
+
             // draw edited patterns (note tracks -> dim yellow, curve tracks -> dim red)
             for (int row = 0; row < 8; ++row) {
                 int patternIndex = row - _pattern.navigation.row * 8;
@@ -664,10 +680,10 @@ void LaunchpadController::patternDraw() {
             }
 
             // draw selected (green) & requested (dim green) patterns
-            int pattern = playState.trackState(trackIndex).pattern();
-            int requestedPattern = playState.trackState(trackIndex).requestedPattern();
-            setGridLed(pattern + _pattern.navigation.row * 8, trackIndex, colorGreen());
-            if (pattern != requestedPattern) {
+            if (!PlayState::isBankPattern(pattern)) {
+                setGridLed(pattern + _pattern.navigation.row * 8, trackIndex, colorGreen());
+            }
+            if (pattern != requestedPattern && !PlayState::isBankPattern(requestedPattern)) {
                 setGridLed(requestedPattern + _pattern.navigation.row * 8, trackIndex, colorGreen(1));
             }
         }
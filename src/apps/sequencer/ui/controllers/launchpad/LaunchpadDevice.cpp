@@ -1,5 +1,9 @@
 #include "LaunchpadDevice.h"
 
+#include "core/Debug.h"
+
+#include <algorithm>
+
 //  +---+---+---+---+---+---+---+---+
 //  |104|105|106|107|108|109|110|111| < CC messages
 //  +---+---+---+---+---+---+---+---+
@@ -49,6 +53,41 @@ void LaunchpadDevice::recvMidi(uint8_t cable, const MidiMessage &message) {
     }
 }
 
+void LaunchpadDevice::syncLedsSysEx(uint8_t cable, const uint8_t *header, size_t headerLength, bool lightingType) {
+    ASSERT(headerLength <= MaxSysExHeaderLength, "header too long");
+
+    std::array<uint8_t, MaxSysExHeaderLength + ButtonCount * 3> message;
+    std::copy(header, header + headerLength, message.begin());
+    size_t length = headerLength;
+
+    for (int index = 0; index < ButtonCount; ++index) {
+        if (_deviceLedState[index] == _ledState[index]) {
+            continue;
+        }
+        int row = index / Cols;
+        int col = index % Cols;
+        uint8_t led;
+        if (row < Rows) {
+            led = 11 + 10 * (7 - row) + col;
+        } else if (row == SceneRow) {
+            led = 19 + 10 * (7 - col);
+        } else {
+            led = 91 + col;
+        }
+        if (lightingType) {
+            // static color from palette
+            message[length++] = 0;
+        }
+        message[length++] = led;
+        message[length++] = _ledState[index];
+    }
+
+    // the message is queued as a whole or not at all, on failure all changes are sent again on the next sync
+    if (length > headerLength && sendSysEx(cable, message.data(), length)) {
+        _deviceLedState = _ledState;
+    }
+}
+
 void LaunchpadDevice::syncLeds() {
     // grid
     for (int row = 0; row < Rows; ++row) {
@@ -18,6 +18,7 @@ public:
     static constexpr int FunctionRow = 9;
 
     using SendMidiHandler = std::function<bool(uint8_t cable, const MidiMessage &)>;
+    using SendSysExHandler = std::function<bool(uint8_t cable, const uint8_t *data, size_t length)>;
     using ButtonHandler = std::function<void(int, int, bool)>;
 
     struct Color {
@@ -41,6 +42,10 @@ public:
         _sendMidiHandler = sendMidiHandler;
     }
 
+    void setSendSysExHandler(SendSysExHandler sendSysExHandler) {
+        _sendSysExHandler = sendSysExHandler;
+    }
+
     virtual void recvMidi(uint8_t cable, const MidiMessage &message);
 
     // initialization
@@ -84,6 +89,18 @@ protected:
         return false;
     }
 
+    bool sendSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+        if (_sendSysExHandler) {
+            return _sendSysExHandler(cable, data, length);
+        }
+        return false;
+    }
+
+    // Sends all changed leds in a single system exclusive message: <header> [<lighting type>] <led> <color> ...
+    // Used by devices in programmer mode that can set multiple leds at once, a full redraw fits into one message.
+    static constexpr size_t MaxSysExHeaderLength = 6;
+    void syncLedsSysEx(uint8_t cable, const uint8_t *header, size_t headerLength, bool lightingType);
+
     void setButtonState(int row, int col, bool state) {
         _buttonState[row * Cols + col] = state;
         if (_buttonHandler) {
@@ -92,6 +109,7 @@ protected:
     }
 
     SendMidiHandler _sendMidiHandler;
+    SendSysExHandler _sendSysExHandler;
     ButtonHandler _buttonHandler;
     std::bitset<ButtonCount> _buttonState;
     std::array<uint8_t, ButtonCount> _ledState;
@@ -57,35 +57,7 @@ void LaunchpadMk3Device::recvMidi(uint8_t cable, const MidiMessage &message) {
 }
 
 void LaunchpadMk3Device::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - row) + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
-        }
-    }
-
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 19 + 10 * (7 - col), _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
-
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 91 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
+    // send changed leds in one message (led lighting, static colors)
+    static const uint8_t header[] = { 0x00, 0x20, 0x29, 0x02, 0x0d, 0x03 };
+    syncLedsSysEx(Cable, header, sizeof(header), true);
 }
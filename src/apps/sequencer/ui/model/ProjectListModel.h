@@ -62,6 +62,7 @@ private:
         MidiProgramOffset,
         CvGateInput,
         CurveCvInput,
+        SlideMode,
         Last
     };
 
@@ -82,6 +83,7 @@ private:
         case MidiProgramOffset:     return "MIDI Pgm Off.";
         case CvGateInput:           return "CV/Gate Input";
         case CurveCvInput:          return "Curve CV Input";
+        case SlideMode:             return "Slide Mode";
         case Last:                  break;
         }
         return nullptr;
@@ -138,6 +140,9 @@ private:
         case CurveCvInput:
             _project.printCurveCvInput(str);
             break;
+        case SlideMode:
+            _project.printSlideMode(str);
+            break;
         case Last:
             break;
         }
@@ -189,6 +194,9 @@ private:
         case CurveCvInput:
             _project.editCurveCvInput(value, shift);
             break;
+        case SlideMode:
+            _project.editSlideMode(value, shift);
+            break;
         case Last:
             break;
         }
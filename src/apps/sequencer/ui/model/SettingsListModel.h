@@ -13,7 +13,7 @@ public:
     {}
 
     int rows() const override {
-        return _userSettings.all().size();
+        return UserSettings::Count;
     }
 
     int columns() const override {
@@ -22,9 +22,9 @@ public:
 
     void cell(int row, int column, StringBuilder &str) const override {
         if (column == 0) {
-            str("%s", _userSettings.get(row)->getMenuItem().c_str());
+            str("%s", _userSettings.name(row));
         } else if (column == 1) {
-            str("%s", _userSettings.get(row)->getMenuItemKey().c_str());
+            str("%s", _userSettings.itemName(row));
         }
     }
 
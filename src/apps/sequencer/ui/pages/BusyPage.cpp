@@ -21,6 +21,7 @@ BusyPage::BusyPage(PageManager &manager, PageContext &context) :
 
 void BusyPage::show(const char *text) {
     _text = text;
+    _closeRequested = false;
     BasePage::show();
 }
 
@@ -43,4 +44,9 @@ void BusyPage::draw(Canvas &canvas) {
 }
 
 void BusyPage::updateLeds(Leds &leds) {
+    // the page is on top of the stack, so it can close itself while pages are updated
+    if (_closeRequested) {
+        _closeRequested = false;
+        close();
+    }
 }
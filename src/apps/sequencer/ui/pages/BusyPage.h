@@ -9,6 +9,9 @@ public:
     using BasePage::show;
     void show(const char *text);
 
+    // closes the page on the next ui update, can be called from other tasks (i.e. file task result callbacks)
+    void requestClose() { _closeRequested = true; }
+
     virtual void enter() override;
     virtual void exit() override;
 
@@ -19,4 +22,5 @@ public:
 
 private:
     const char *_text;
+    volatile bool _closeRequested = false;
 };
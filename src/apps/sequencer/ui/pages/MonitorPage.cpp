@@ -5,8 +5,11 @@
 #include "engine/CvInput.h"
 #include "engine/CvOutput.h"
 
+#include "core/profiler/Profiler.h"
 #include "core/utils/StringBuilder.h"
 
+#include "os/os.h"
+
 enum class Function {
     CvIn    = 0,
     CvOut   = 1,
@@ -88,8 +91,9 @@ void MonitorPage::exit() {
 void MonitorPage::draw(Canvas &canvas) {
     WindowPainter::clear(canvas);
     WindowPainter::drawHeader(canvas, _model, _engine, "MONITOR");
-    WindowPainter::drawActiveFunction(canvas, functionNames[int(_mode)]);
-    WindowPainter::drawFooter(canvas, functionNames, pageKeyState(), int(_mode));
+    bool profile = _mode == Mode::Profile;
+    WindowPainter::drawActiveFunction(canvas, profile ? "PROFILE" : functionNames[int(_mode)]);
+    WindowPainter::drawFooter(canvas, functionNames, pageKeyState(), profile ? int(Function::Stats) : int(_mode));
 
     canvas.setBlendMode(BlendMode::Set);
     canvas.setFont(Font::Tiny);
@@ -111,6 +115,9 @@ void MonitorPage::draw(Canvas &canvas) {
     case Mode::Version:
         drawVersion(canvas);
         break;
+    case Mode::Profile:
+        drawProfile(canvas);
+        break;
     }
 }
 
@@ -136,16 +143,25 @@ void MonitorPage::keyPress(KeyPressEvent &event) {
             _mode = Mode::Midi;
             break;
         case Function::Stats:
-            _mode = Mode::Stats;
+            // pressing stats again switches to the profile
+            _mode = _mode == Mode::Stats ? Mode::Profile : Mode::Stats;
             break;
         case Function::Version:
             _mode = Mode::Version;
             break;
         }
     }
+
+    if (key.isEncoder() && _mode == Mode::Profile) {
+        Profiler::reset();
+        showMessage("PROFILE RESET");
+    }
 }
 
 void MonitorPage::encoder(EncoderEvent &event) {
+    if (_mode == Mode::Profile) {
+        _profileRow = clamp(_profileRow + event.value(), 0, std::max(0, _profileRowCount - 4));
+    }
 }
 
 void MonitorPage::midi(MidiEvent &event) {
@@ -210,8 +226,9 @@ void MonitorPage::drawStats(Canvas &canvas) {
     auto stats = _engine.stats();
 
     auto drawValue = [&] (int index, const char *name, const char *value) {
-        canvas.drawText(10, 20 + index * 10, name);
-        canvas.drawText(100, 20 + index * 10, value);
+        int x = (index / 4) * 128;
+        canvas.drawText(x + 10, 20 + (index % 4) * 10, name);
+        canvas.drawText(x + 100, 20 + (index % 4) * 10, value);
     };
 
     {
@@ -232,6 +249,59 @@ void MonitorPage::drawStats(Canvas &canvas) {
         drawValue(2, "USBMIDI OVF:", str);
     }
 
+    {
+        FixedStringBuilder<16> str("%d", stats.uiMidiOverflow);
+        drawValue(3, "UI MIDI OVF:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%d", stats.midiTxOverflow);
+        drawValue(5, "MIDI TX OVF:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%d", stats.usbMidiTxOverflow);
+        drawValue(6, "USB TX OVF:", str);
+    }
+
+}
+
+// tasks followed by profiler intervals, the encoder scrolls through the list
+void MonitorPage::drawProfile(Canvas &canvas) {
+    int row = 0;
+
+    auto drawRow = [&] (const char *name, const char *value0, const char *value1) {
+        int index = row++ - _profileRow;
+        if (index >= 0 && index < 4) {
+            canvas.drawText(8, 20 + index * 10, name);
+            canvas.drawText(80, 20 + index * 10, value0);
+            canvas.drawText(212, 20 + index * 10, value1);
+        }
+    };
+
+#if CONFIG_ENABLE_TASK_PROFILER
+    os::TaskProfiler::enumerate([&] (const os::TaskProfiler::TaskInfo &info) {
+        FixedStringBuilder<16> load("LOAD %d%%", info.load);
+        FixedStringBuilder<16> stack("FREE %d", info.stackFree);
+        drawRow(info.name ? info.name : "-", load, stack);
+    });
+#endif // CONFIG_ENABLE_TASK_PROFILER
+
+#if CONFIG_ENABLE_PROFILER
+    for (int i = 0; i < Profiler::intervalCount(); ++i) {
+        const auto &interval = Profiler::interval(i);
+        auto stats = interval.stats();
+        FixedStringBuilder<32> times("AVG %d P99 %d MAX %d", stats.avg, stats.p99, stats.max);
+        FixedStringBuilder<16> overruns("OVR %d", stats.overruns);
+        drawRow(interval.desc, times, interval.budget > 0 ? overruns : "");
+    }
+#endif // CONFIG_ENABLE_PROFILER
+
+    _profileRowCount = row;
+
+    if (row == 0) {
+        canvas.drawTextCentered(0, 24, Width, 16, "PROFILER DISABLED");
+    }
 }
 
 void MonitorPage::drawVersion(Canvas &canvas) {
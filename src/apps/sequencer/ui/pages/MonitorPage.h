@@ -25,6 +25,7 @@ private:
     void drawCvOut(Canvas &canvas);
     void drawMidi(Canvas &canvas);
     void drawStats(Canvas &canvas);
+    void drawProfile(Canvas &canvas);
     void drawVersion(Canvas &canvas);
 
     enum class Mode : uint8_t {
@@ -33,10 +34,14 @@ private:
         Midi,
         Stats,
         Version,
+        // shares the function key with stats
+        Profile,
     };
 
     Mode _mode = Mode::CvIn;
     MidiMessage _lastMidiMessage;
     MidiPort _lastMidiMessagePort;
     uint32_t _lastMidiMessageTicks = -1;
+    int _profileRow = 0;
+    int _profileRowCount = 0;
 };
@@ -124,7 +124,9 @@ void OverviewPage::draw(Canvas &canvas) {
         // track number / pattern number
         canvas.setColor(trackState.mute() ? Color::Medium : Color::Bright);
         canvas.drawText(2, y, FixedStringBuilder<8>("T%d", trackIndex + 1));
-        canvas.drawText(18, y, FixedStringBuilder<8>("P%d", trackState.pattern() + 1));
+        FixedStringBuilder<8> patternName;
+        PlayState::printPattern(patternName, trackState.pattern());
+        canvas.drawText(18, y, patternName);
 
         // gate output (only show for tracks 0-7 which have physical CV/Gate outputs)
         if (trackIndex < 8) {
@@ -139,11 +141,11 @@ void OverviewPage::draw(Canvas &canvas) {
 
         switch (track.trackMode()) {
         case Track::TrackMode::Note:
-            drawNoteTrack(canvas, i, trackEngine.as<NoteTrackEngine>(), track.noteTrack().sequence(trackState.pattern()));
+            drawNoteTrack(canvas, i, trackEngine.as<NoteTrackEngine>(), trackEngine.as<NoteTrackEngine>().sequence());
             break;
 #if CONFIG_ENABLE_CURVE_TRACKS
         case Track::TrackMode::Curve:
-            drawCurveTrack(canvas, i, trackEngine.as<CurveTrackEngine>(), track.curveTrack().sequence(trackState.pattern()));
+            drawCurveTrack(canvas, i, trackEngine.as<CurveTrackEngine>(), trackEngine.as<CurveTrackEngine>().sequence());
             break;
 #endif
 #if CONFIG_ENABLE_MIDICV_TRACKS
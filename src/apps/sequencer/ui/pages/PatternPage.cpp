@@ -5,6 +5,7 @@
 #include "ui/LedPainter.h"
 #include "ui/painters/WindowPainter.h"
 
+#include "model/FileManager.h"
 #include "model/PlayState.h"
 
 #include "core/utils/StringBuilder.h"
@@ -24,6 +25,7 @@ enum class ContextAction {
     Paste,
     Duplicate,
     Save,
+    Store,
     Last
 };
 
@@ -33,8 +35,24 @@ static const ContextMenuModel::Item contextMenuItems[] = {
     { "PASTE" },
     { "DUP"},
     { "SAVE PR."},
+    { "STORE" },
 };
 
+// steps beyond the edit patterns select the first bank patterns
+static int patternFromStep(int step) {
+    return step < CONFIG_PATTERN_COUNT ? step : PlayState::patternFromBank(step - CONFIG_PATTERN_COUNT);
+}
+
+static int stepFromPattern(int pattern) {
+    if (pattern < CONFIG_PATTERN_COUNT) {
+        return pattern;
+    }
+    if (PlayState::isBankPattern(pattern) && PlayState::bankFromPattern(pattern) < 16 - CONFIG_PATTERN_COUNT) {
+        return CONFIG_PATTERN_COUNT + PlayState::bankFromPattern(pattern);
+    }
+    return -1;
+}
+
 
 PatternPage::PatternPage(PageManager &manager, PageContext &context) :
     BasePage(manager, context)
@@ -98,10 +116,10 @@ void PatternPage::draw(Canvas &canvas) {
         for (int p = 0; p < 16; ++p) {
             int px = x + (p % 8) * 3 + 2;
             int py = y + (p / 8) * 3 + 2;
-            if (p == trackState.pattern()) {
+            if (p == stepFromPattern(trackState.pattern())) {
                 canvas.setColor(Color::Bright);
                 canvas.fillRect(px, py, 3, 3);
-            } else if (trackState.hasPatternRequest() && p == trackState.requestedPattern()) {
+            } else if (trackState.hasPatternRequest() && p == stepFromPattern(trackState.requestedPattern())) {
                 canvas.setColor(Color::Medium);
                 canvas.fillRect(px, py, 3, 3);
             } else {
@@ -113,7 +131,9 @@ void PatternPage::draw(Canvas &canvas) {
         y += 5;
 
         canvas.setColor(trackSelected ? Color::Bright : Color::Medium);
-        canvas.drawTextCentered(x, y + 7, w, 8, snapshotActive ? "S" : FixedStringBuilder<8>("P%d", trackState.pattern() + 1));
+        FixedStringBuilder<8> patternName;
+        PlayState::printPattern(patternName, trackState.pattern());
+        canvas.drawTextCentered(x, y + 7, w, 8, snapshotActive ? "S" : patternName);
 
         if (trackState.hasPatternRequest() && trackState.pattern() != trackState.requestedPattern()) {
             hasRequested = true;
@@ -130,7 +150,8 @@ void PatternPage::updateLeds(Leds &leds) {
     const auto &playState = _project.playState();
 
     if (playState.snapshotActive()) {
-        LedPainter::drawSelectedPattern(leds, _snapshotTargetPattern, _snapshotTargetPattern);
+        int step = _snapshotTargetPattern >= 0 ? stepFromPattern(_snapshotTargetPattern) : -1;
+        LedPainter::drawSelectedPattern(leds, step, step);
     } else if (globalKeyState()[Key::Shift]) {
         LedPainter::drawSelectedPattern(leds, _project.selectedPatternIndex(), _project.selectedPatternIndex());
     } else {
@@ -146,13 +167,13 @@ void PatternPage::updateLeds(Leds &leds) {
             int trackIndex = trackOffset + i;
             const auto &trackState = playState.trackState(trackIndex);
             bool hasPatternRequest = trackState.hasPatternRequest();
-            int pattern = trackState.pattern();
-            int requestedPattern = trackState.requestedPattern();
-            allActivePatterns |= (pattern < 16) ? (1<<pattern) : 0;
-            allRequestedPatterns |= (hasPatternRequest && requestedPattern < 16) ? (1<<requestedPattern) : 0;
+            int pattern = stepFromPattern(trackState.pattern());
+            int requestedPattern = stepFromPattern(trackState.requestedPattern());
+            allActivePatterns |= (pattern >= 0) ? (1<<pattern) : 0;
+            allRequestedPatterns |= (hasPatternRequest && requestedPattern >= 0) ? (1<<requestedPattern) : 0;
             if (pageKeyState()[MatrixMap::fromTrack(i)]) {
-                selectedActivePatterns |= (pattern < 16) ? (1<<pattern) : 0;
-                selectedRequestedPatterns |= (hasPatternRequest && requestedPattern < 16) ? (1<<requestedPattern) : 0;
+                selectedActivePatterns |= (pattern >= 0) ? (1<<pattern) : 0;
+                selectedRequestedPatterns |= (hasPatternRequest && requestedPattern >= 0) ? (1<<requestedPattern) : 0;
             }
         }
 
@@ -182,7 +203,7 @@ void PatternPage::keyDown(KeyEvent &event) {
     }
 
     if (_project.playState().snapshotActive() && key.isStep()) {
-        _snapshotTargetPattern = key.step();
+        _snapshotTargetPattern = patternFromStep(key.step());
         event.consume();
     }
 }
@@ -286,11 +307,13 @@ void PatternPage::keyPress(KeyPressEvent &event) {
     }
 
     if (key.isStep()) {
-        int pattern = key.step();
+        int pattern = patternFromStep(key.step());
 
         if (key.shiftModifier()) {
             // select edit pattern
-            _project.setSelectedPatternIndex(pattern);
+            if (!PlayState::isBankPattern(pattern)) {
+                _project.setSelectedPatternIndex(pattern);
+            }
         } else {
             // select playing pattern
 
@@ -314,7 +337,9 @@ void PatternPage::keyPress(KeyPressEvent &event) {
             }
             if (globalChange) {
                 playState.selectPattern(pattern, executeType);
-                _project.setSelectedPatternIndex(pattern);
+                if (!PlayState::isBankPattern(pattern)) {
+                    _project.setSelectedPatternIndex(pattern);
+                }
             }
         }
         event.consume();
@@ -338,8 +363,14 @@ void PatternPage::encoder(EncoderEvent &event) {
     for (int track = 0; track < CONFIG_TRACK_COUNT; ++track) {
         if (pageKeyState()[MatrixMap::fromTrack(track % 8)]) {
             // Track button is held - change that track's pattern
+            // note tracks can also play bank patterns, the snapshot pattern is skipped
             int currentPattern = playState.trackState(track).pattern();
-            int newPattern = clamp(currentPattern + event.value(), 0, CONFIG_PATTERN_COUNT - 1);
+            bool noteTrack = _project.track(track).trackMode() == Track::TrackMode::Note;
+            int maxPattern = noteTrack ? PlayState::patternFromBank(CONFIG_PATTERN_BANK_COUNT - 1) : CONFIG_PATTERN_COUNT - 1;
+            int newPattern = clamp(currentPattern + event.value(), 0, maxPattern);
+            if (newPattern >= CONFIG_PATTERN_COUNT && !PlayState::isBankPattern(newPattern)) {
+                newPattern = event.value() > 0 ? PlayState::BankPatternIndex : CONFIG_PATTERN_COUNT - 1;
+            }
             playState.selectTrackPattern(track, newPattern, PlayState::Immediate);
             anyTrackHeld = true;
         }
@@ -377,6 +408,9 @@ void PatternPage::contextAction(int index) {
     case ContextAction::Save:
         sendMidiProgramSave();
         break;
+    case ContextAction::Store:
+        storePattern();
+        break;
     case ContextAction::Last:
         break;
     }
@@ -388,6 +422,8 @@ bool PatternPage::contextActionEnabled(int index) const {
         return _model.clipBoard().canPastePattern();
     case ContextAction::Save:
         return _engine.midiProgramChangesEnabled() && _project.midiIntegrationMalekkoEnabled();
+    case ContextAction::Store:
+        return _project.selectedTrack().trackMode() == Track::TrackMode::Note && !_model.patternPager().storePending();
     default:
         return true;
     }
@@ -425,6 +461,63 @@ void PatternPage::sendMidiProgramSave() {
     }
 }
 
+void PatternPage::storePattern() {
+    int trackIndex = _project.selectedTrackIndex();
+    auto &patternPager = _model.patternPager();
+    const auto &storage = patternPager.storage();
+
+    int bank = storage.firstUnused(trackIndex);
+    if (bank < 0 || storage.usedCount() >= storage.capacity()) {
+        showMessage("PATTERN BANKS FULL");
+        return;
+    }
+
+    // erasing a flash sector stops everything for up to two seconds, so it is only done when confirmed
+    if (storage.eraseRequired()) {
+        _manager.pages().confirmation.show("ERASE FLASH? STOPS CLOCK", [this] (bool result) {
+            if (result) {
+                erasePatternStorage();
+            }
+        });
+        return;
+    }
+
+    // written to flash in the background
+    if (patternPager.store(trackIndex, bank, _project.selectedTrack().noteTrack().sequence(_project.selectedPatternIndex()))) {
+        showMessage(FixedStringBuilder<32>("PATTERN STORED TO B%d", bank + 1));
+    }
+}
+
+void PatternPage::erasePatternStorage() {
+    int trackIndex = _project.selectedTrackIndex();
+    auto &patternPager = _model.patternPager();
+    int bank = patternPager.storage().firstUnused(trackIndex);
+
+    _engine.suspend();
+
+    // the sequence is copied here in the ui task, the file task stores the copy right after erasing
+    if (bank < 0 || !patternPager.store(trackIndex, bank, _project.selectedTrack().noteTrack().sequence(_project.selectedPatternIndex()), true)) {
+        _engine.resume();
+        return;
+    }
+
+    _manager.pages().busy.show("ERASING FLASH ...");
+
+    FileManager::task([this] () {
+        _model.patternPager().eraseStorage();
+        return fs::OK;
+    }, [this, bank] (fs::Error result) {
+        // the result callback runs in the file task, it must not touch the project or the page stack
+        if (_model.patternPager().storeResult() == PatternPager::Result::Success) {
+            showMessage(FixedStringBuilder<32>("PATTERN STORED TO B%d", bank + 1));
+        } else {
+            showMessage("PATTERN BANKS FULL");
+        }
+        _manager.pages().busy.requestClose();
+        _engine.resume();
+    });
+}
+
 int PatternPage::clamp(int value, int min, int max) {
     if (value < min) return min;
     if (value > max) return max;
@@ -31,6 +31,8 @@ private:
     void pastePattern();
     void duplicatePattern();
     void sendMidiProgramSave();
+    void storePattern();
+    void erasePatternStorage();
 
     int clamp(int value, int min, int max);
 
@@ -95,10 +95,9 @@ void PerformerPage::draw(Canvas &canvas) {
             }
 
             // draw label inside the box
-            // In pattern mode: always show pattern number (P1-P16), dark on white if muted
+            // In pattern mode: always show pattern number (P1-P8, B1-Bn for bank patterns), dark on white if muted
             // In normal mode: show track number (T1-T16) only when not muted
             if (_patternMode) {
-                int patternNum = trackState.pattern() + 1;
                 if (isMuted) {
                     // Dark text on white background: use Sub mode to darken
                     canvas.setBlendMode(BlendMode::Sub);
@@ -108,7 +107,9 @@ void PerformerPage::draw(Canvas &canvas) {
                     canvas.setBlendMode(BlendMode::Add);
                     canvas.setColor(Color::Bright);
                 }
-                canvas.drawTextCentered(x, y + 2, w, 8, FixedStringBuilder<8>("P%d", patternNum));
+                FixedStringBuilder<8> str;
+                PlayState::printPattern(str, trackState.pattern());
+                canvas.drawTextCentered(x, y + 2, w, 8, str);
             } else if (!isMuted) {
                 // Show track number only when not muted
                 canvas.setBlendMode(BlendMode::Add);
@@ -145,7 +146,6 @@ void PerformerPage::draw(Canvas &canvas) {
 
             // In pattern mode: draw pattern number inside the square for quick feedback
             if (_patternMode) {
-                int patternNum = trackState.pattern() + 1;
                 if (isMuted) {
                     // Dark text on white background: use Sub mode to darken
                     canvas.setBlendMode(BlendMode::Sub);
@@ -156,7 +156,9 @@ void PerformerPage::draw(Canvas &canvas) {
                     canvas.setColor(Color::Bright);
                 }
                 // Center vertically within the box
-                canvas.drawTextCentered(x, y + (h - 8) / 2, w, 8, FixedStringBuilder<8>("P%d", patternNum));
+                FixedStringBuilder<8> str;
+                PlayState::printPattern(str, trackState.pattern());
+                canvas.drawTextCentered(x, y + (h - 8) / 2, w, 8, str);
             }
 
             // draw sequence progress
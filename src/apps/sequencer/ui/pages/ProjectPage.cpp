@@ -184,7 +184,7 @@ void ProjectPage::initRoute() {
 }
 
 void ProjectPage::saveProjectToSlot(int slot) {
-    _engine.suspend();
+    // the engine keeps running, the project is written from consistent snapshots
     _manager.pages().busy.show("SAVING PROJECT ...");
 
     FileManager::task([this, slot] () {
@@ -197,7 +197,6 @@ void ProjectPage::saveProjectToSlot(int slot) {
         }
         // TODO lock ui mutex
         _manager.pages().busy.close();
-        _engine.resume();
     });
 }
 
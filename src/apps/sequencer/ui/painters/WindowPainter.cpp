@@ -131,7 +131,9 @@ void WindowPainter::drawActiveState(Canvas &canvas, int track, int playPattern,
         drawInvertedText(canvas, 61, 8 - 2, "SNAP", true);
     } else {
         // draw active pattern
-        drawInvertedText(canvas, 61, 8 - 2, FixedStringBuilder<8>("P%d", playPattern + 1), songActive);
+        FixedStringBuilder<8> str;
+        PlayState::printPattern(str, playPattern);
+        drawInvertedText(canvas, 61, 8 - 2, str, songActive);
 
         // draw edit pattern
         drawInvertedText(canvas, 80, 8 - 2, FixedStringBuilder<8>("E%d", editPattern + 1), playPattern == editPattern);
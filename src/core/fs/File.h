@@ -98,6 +98,23 @@ public:
         return _error;
     }
 
+#if FF_USE_FASTSEEK
+    // Builds a map of the cluster chain so reads and seeks no longer have to follow the chain in the FAT.
+    // The table has to stay valid while the file is open, the file cannot grow while in fast seek mode.
+    // Returns NOT_ENOUGH_CORE and stays in normal mode if the file is too fragmented for the table.
+    Error enableFastSeek(DWORD *table, size_t tableSize) {
+        table[0] = tableSize;
+        _file->cltbl = table;
+        size_t pos = tell();
+        _error = Error(f_lseek(_file, CREATE_LINKMAP));
+        if (_error != OK) {
+            _file->cltbl = nullptr;
+            return _error;
+        }
+        return seek(pos);
+    }
+#endif
+
     Error sync() {
         _error = Error(f_sync(_file));
         return _error;
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "File.h"
+#include "FileSystem.h"
+
+#include "core/Debug.h"
+
+#include <algorithm>
 
 #include <cstring>
 #include <cstddef>
@@ -11,11 +16,37 @@ namespace fs {
 /**
  * File reader.
  * Buffers reads to increase throughput and keeps track of potential errors, which are returned when calling finish().
+ * The buffer is always refilled from a sector boundary of the file, reads of whole sectors bypass the buffer and
+ * go straight from the card into the caller's memory. Callers can pass a larger buffer (a multiple of the sector
+ * size, in SRAM) to get multi block transfers. A buffer of an even number of sectors is used as a double buffer,
+ * the following sectors are read into one half while the other half is consumed.
+ * The cluster chain is looked up using FatFS fast seek if available.
  */
 class FileReader {
 public:
-    FileReader(const char *path) {
+    static constexpr size_t SectorSize = FF_MAX_SS;
+
+    FileReader(const char *path) :
+        FileReader(path, _defaultBuffer, sizeof(_defaultBuffer))
+    {}
+
+    FileReader(const char *path, void *buffer, size_t bufferSize) :
+        _buffer(static_cast<uint8_t *>(buffer)),
+        _bufferSize(bufferSize)
+    {
+        ASSERT(bufferSize >= SectorSize && bufferSize % SectorSize == 0, "buffer size must be a multiple of the sector size");
         _error = _file.open(path, File::Read);
+#if FF_USE_FASTSEEK
+        if (_error == OK) {
+            // a fragmented file simply stays in normal mode
+            _file.enableFastSeek(_linkMap, sizeof(_linkMap) / sizeof(_linkMap[0]));
+        }
+#endif
+        _doubleBuffered = _error == OK && bufferSize % (2 * SectorSize) == 0 && beginBufferedTransfers(buffer, bufferSize);
+        if (_doubleBuffered) {
+            _bufferSize /= 2;
+        }
+        _fill = _buffer;
     }
 
     ~FileReader() {
@@ -26,6 +57,10 @@ public:
 
     Error finish() {
         if (!_finished) {
+            // wait for reading ahead before the buffer is released
+            if (_doubleBuffered) {
+                endBufferedTransfers();
+            }
             if (_error == OK) {
                 _error = _file.close();
             } else {
@@ -38,21 +73,40 @@ public:
 
     Error read(void *data, size_t len) {
         uint8_t *dst = static_cast<uint8_t *>(data);
-        uint8_t *buffer = reinterpret_cast<uint8_t *>(_buffer);
         while (_error == OK && len > 0) {
-            if (_pos == 0 || _pos == BufferSize) {
-                _error = _file.read(buffer, BufferSize, &_bufferSize);
-                if (_error != OK) {
+            if (_pos == _filled) {
+                if (_filled != 0 && _filled < _bufferSize) {
+                    _error = END_OF_FILE;
                     break;
                 }
+                // the file is sector aligned when the buffer is empty, read whole sectors without copying
+                if (len >= SectorSize) {
+                    size_t chunk = len - len % SectorSize;
+                    size_t lenRead;
+                    _error = _file.read(dst, chunk, &lenRead);
+                    if (_error == OK && lenRead != chunk) {
+                        _error = END_OF_FILE;
+                    }
+                    dst += chunk;
+                    len -= chunk;
+                    continue;
+                }
+                // alternate halves, the other half is read ahead while this one is consumed
+                if (_doubleBuffered) {
+                    _fill = _fill == _buffer ? _buffer + _bufferSize : _buffer;
+                }
+                _error = _file.read(_fill, _bufferSize, &_filled);
                 _pos = 0;
+                if (_error != OK) {
+                    break;
+                }
+                if (_filled == 0) {
+                    _error = END_OF_FILE;
+                    break;
+                }
             }
-            size_t chunk = std::min(len, _bufferSize - _pos);
-            if (chunk == 0) {
-                _error = END_OF_FILE;
-                break;
-            }
-            memcpy(dst, &buffer[_pos], chunk);
+            size_t chunk = std::min(len, _filled - _pos);
+            std::memcpy(dst, &_fill[_pos], chunk);
             _pos += chunk;
             dst += chunk;
             len -= chunk;
@@ -61,14 +115,20 @@ public:
     }
 
 private:
-    static constexpr size_t BufferSize = 512;
-
     File _file;
     bool _finished = false;
     Error _error;
-    uint32_t _buffer[BufferSize / 4];
-    size_t _bufferSize = 0;
+    uint8_t *_buffer;
+    size_t _bufferSize;
+    bool _doubleBuffered;
+    uint8_t *_fill;
+    size_t _filled = 0;
     size_t _pos = 0;
+#if FF_USE_FASTSEEK
+    // enough for files with up to 3 fragments
+    DWORD _linkMap[8];
+#endif
+    uint32_t _defaultBuffer[SectorSize / 4];
 };
 
 } // namespace fs
@@ -46,6 +46,82 @@ bool exists(const char *path) {
     return stat(path, info) == OK;
 }
 
+struct BufferedTransfers {
+    uint8_t *buffer = nullptr;
+    size_t halfSize = 0;
+
+    // transfer running in the background or sectors read ahead
+    bool active = false;
+    bool write = false;
+    bool readAhead = false;
+    uint8_t *buf;
+    uint32_t sector;
+    uint32_t count;
+};
+
+static BufferedTransfers g_transfers;
+
+bool beginBufferedTransfers(void *buffer, size_t size) {
+    if (g_transfers.buffer) {
+        return false;
+    }
+    g_transfers.buffer = static_cast<uint8_t *>(buffer);
+    g_transfers.halfSize = size / 2;
+    return true;
+}
+
+// waits for the background transfer, reading ahead is speculative, so only a failed write is an error
+static bool finishTransfer() {
+    auto &transfers = g_transfers;
+    if (!transfers.active) {
+        return true;
+    }
+    transfers.active = false;
+    bool success = g_sdCard->finishTransfer();
+    transfers.readAhead &= success;
+    return success || !transfers.write;
+}
+
+Error endBufferedTransfers() {
+    bool success = finishTransfer();
+    g_transfers.readAhead = false;
+    g_transfers.buffer = nullptr;
+    return success ? OK : DISK_ERR;
+}
+
+static bool isBuffered(const void *buf) {
+    return g_transfers.buffer && buf >= g_transfers.buffer && buf < g_transfers.buffer + 2 * g_transfers.halfSize;
+}
+
+static bool isReadAhead(const void *buf, uint32_t sector, uint32_t count) {
+    const auto &transfers = g_transfers;
+    return transfers.readAhead && sector >= transfers.sector && sector + count <= transfers.sector + transfers.count &&
+        buf == transfers.buf + (sector - transfers.sector) * 512;
+}
+
+// once a read filled one half of the buffer, start reading the following sectors into the other half
+static void startReadAhead(uint8_t *buf, uint32_t sector, uint32_t count) {
+    auto &transfers = g_transfers;
+    if (!isBuffered(buf)) {
+        return;
+    }
+    size_t end = (buf - transfers.buffer) + count * 512;
+    if (end != transfers.halfSize && end != 2 * transfers.halfSize) {
+        return;
+    }
+    uint8_t *other = end == transfers.halfSize ? transfers.buffer + transfers.halfSize : transfers.buffer;
+    uint32_t aheadSector = sector + count;
+    uint32_t aheadCount = transfers.halfSize / 512;
+    if (aheadSector + aheadCount > g_sdCard->sectorCount() || !g_sdCard->startRead(other, aheadSector, aheadCount)) {
+        return;
+    }
+    transfers.active = true;
+    transfers.write = false;
+    transfers.readAhead = true;
+    transfers.buf = other;
+    transfers.sector = aheadSector;
+    transfers.count = aheadCount;
+}
 } // namespace fs
 
 
@@ -72,12 +148,41 @@ DSTATUS disk_status(BYTE pdrv) {
 DRESULT disk_read(BYTE pdrv, BYTE *buf, DWORD sector, UINT count) {
     ASSERT(pdrv == 0, "only one physical drive available");
     // DBG("disk_read(pdrv=%d,sector=%d,count=%d)", pdrv, sector, count);
-    return fs::g_sdCard->read(buf, sector, count) ? RES_OK : RES_ERROR;
+    bool readAhead = fs::isReadAhead(buf, sector, count);
+    if (!fs::finishTransfer()) {
+        return RES_ERROR;
+    }
+    // serve the sectors from the buffer if they were read ahead successfully
+    if (!(readAhead && fs::g_transfers.readAhead)) {
+        fs::g_transfers.readAhead = false;
+        if (!fs::g_sdCard->read(buf, sector, count)) {
+            return RES_ERROR;
+        }
+    }
+    fs::startReadAhead(buf, sector, count);
+    return RES_OK;
 }
 
 DRESULT disk_write(BYTE pdrv, const BYTE *buf, DWORD sector, UINT count) {
     ASSERT(pdrv == 0, "only one physical drive available");
     // DBG("disk_write(pdrv=%d,sector=%d,count=%d)", pdrv, sector, count);
+    auto &transfers = fs::g_transfers;
+    if (!fs::finishTransfer()) {
+        return RES_ERROR;
+    }
+    transfers.readAhead = false;
+    // writes from the double buffer continue in the background
+    if (fs::isBuffered(buf) && count <= SdCard::MaxTransferBlocks) {
+        if (!fs::g_sdCard->startWrite(buf, sector, count)) {
+            return RES_ERROR;
+        }
+        transfers.active = true;
+        transfers.write = true;
+        transfers.buf = const_cast<BYTE *>(buf);
+        transfers.sector = sector;
+        transfers.count = count;
+        return RES_OK;
+    }
     return fs::g_sdCard->write(buf, sector, count) ? RES_OK : RES_ERROR;
 }
 
@@ -86,6 +191,9 @@ DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buf) {
     // DBG("disk_ioctl(pdrv=%d,cmd=%d)", pdrv, cmd);
     switch (cmd) {
     case CTRL_SYNC:
+        if (!fs::finishTransfer()) {
+            return RES_ERROR;
+        }
         fs::g_sdCard->sync();
         return RES_OK;
     case GET_SECTOR_COUNT:
@@ -20,4 +20,13 @@ Error rename(const char *oldPath, const char *newPath);
 
 bool exists(const char *path);
 
+// Double buffered transfers (used by FileWriter and FileReader).
+// Writes from the buffer return as soon as the transfer is started, reads filling one half of the buffer start
+// reading the following sectors into the other half. Any other disk access first waits for the running transfer,
+// so errors of a background write are reported by the next disk access or endBufferedTransfers().
+// Only one buffer can be registered, returns false if another one already is.
+bool beginBufferedTransfers(void *buffer, size_t size);
+// waits for the running transfer and releases the buffer
+Error endBufferedTransfers();
+
 } // namespace fs
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "File.h"
+#include "FileSystem.h"
+
+#include "core/Debug.h"
 
 #include <algorithm>
 
@@ -13,11 +16,33 @@ namespace fs {
 /**
  * File writer.
  * Buffers writes to increase throughput and keeps track of potential errors, which are returned when calling finish().
+ * The buffer is flushed on sector boundaries of the file, so FatFS writes whole sectors straight from the buffer to
+ * the card instead of going through its sector window. Writes of whole sectors bypass the buffer altogether.
+ * Callers can pass a larger buffer (a multiple of the sector size, in SRAM) to get multi block transfers.
+ * A buffer of an even number of sectors is used as a double buffer, one half is filled while the other half is
+ * written to the card in the background.
  */
 class FileWriter {
 public:
-    FileWriter(const char *path) {
-        _error = _file.open(path, File::Write);
+    static constexpr size_t SectorSize = FF_MAX_SS;
+
+    FileWriter(const char *path, File::Mode mode = File::Write) :
+        FileWriter(path, mode, _defaultBuffer, sizeof(_defaultBuffer))
+    {}
+
+    FileWriter(const char *path, File::Mode mode, void *buffer, size_t bufferSize) :
+        _buffer(static_cast<uint8_t *>(buffer)),
+        _bufferSize(bufferSize)
+    {
+        ASSERT(bufferSize >= SectorSize && bufferSize % SectorSize == 0, "buffer size must be a multiple of the sector size");
+        _error = _file.open(path, mode);
+        _doubleBuffered = _error == OK && bufferSize % (2 * SectorSize) == 0 && beginBufferedTransfers(buffer, bufferSize);
+        if (_doubleBuffered) {
+            _bufferSize /= 2;
+        }
+        _fill = _buffer;
+        // appending starts in the middle of a sector, the first flush realigns to the sector boundary
+        _limit = _bufferSize - (_error == OK ? _file.tell() % SectorSize : 0);
     }
 
     ~FileWriter() {
@@ -29,7 +54,11 @@ public:
     Error finish() {
         if (!_finished) {
             if (_error == OK) {
-                _error = _file.writeAll(_buffer, _pos);
+                _error = _file.writeAll(_fill, _pos);
+            }
+            if (_doubleBuffered) {
+                Error error = endBufferedTransfers();
+                _error = _error == OK ? error : _error;
             }
             if (_error == OK) {
                 _error = _file.close();
@@ -43,29 +72,44 @@ public:
 
     Error write(const void *data, size_t len) {
         const uint8_t *src = static_cast<const uint8_t *>(data);
-        uint8_t *buffer = reinterpret_cast<uint8_t *>(_buffer);
         while (_error == OK && len > 0) {
-            size_t chunk = std::min(len, BufferSize - _pos);
-            memcpy(&buffer[_pos], src, chunk);
+            // the file is sector aligned when the buffer is empty, pass whole sectors on without copying
+            if (_pos == 0 && _limit == _bufferSize && len >= SectorSize) {
+                size_t chunk = len - len % SectorSize;
+                _error = _file.writeAll(src, chunk);
+                src += chunk;
+                len -= chunk;
+                continue;
+            }
+            size_t chunk = std::min(len, _limit - _pos);
+            std::memcpy(&_fill[_pos], src, chunk);
             _pos += chunk;
             src += chunk;
             len -= chunk;
-            if (_pos == BufferSize) {
+            if (_pos == _limit) {
+                _error = _file.writeAll(_fill, _pos);
                 _pos = 0;
-                _error = _file.writeAll(buffer, BufferSize);
+                _limit = _bufferSize;
+                // fill the other half while this one is written
+                if (_doubleBuffered) {
+                    _fill = _fill == _buffer ? _buffer + _bufferSize : _buffer;
+                }
             }
         }
         return _error;
     }
 
 private:
-    static constexpr size_t BufferSize = 512;
-
     File _file;
     bool _finished = false;
     Error _error;
-    uint32_t _buffer[BufferSize / 4];
+    uint8_t *_buffer;
+    size_t _bufferSize;
+    bool _doubleBuffered;
+    uint8_t *_fill;
+    size_t _limit;
     size_t _pos = 0;
+    uint32_t _defaultBuffer[SectorSize / 4];
 };
 
 } // namespace fs
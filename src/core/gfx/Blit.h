@@ -4,20 +4,18 @@
 
 namespace blit {
     struct set {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            frameBuffer(x, y) = color;
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.set(x, y, color);
         }
     };
     struct add {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::min(0xff, int(frameBuffer(x, y)) + color);
-            frameBuffer(x, y) += color;
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.add(x, y, color);
         }
     };
     struct sub {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::max(0x00, int(frameBuffer(x, y)) - color);
-            frameBuffer(x, y) -= std::min(frameBuffer(x, y), color);
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.sub(x, y, color);
         }
     };
 };
@@ -43,7 +43,7 @@ enum class VerticalAlign {
 
 class Canvas {
 public:
-    Canvas(FrameBuffer8bit &frameBuffer, float &brightness) :
+    Canvas(FrameBuffer4bit &frameBuffer, float &brightness) :
         _frameBuffer(frameBuffer),
         _right(frameBuffer.width() - 1),
         _bottom(frameBuffer.height() - 1),
@@ -270,7 +270,7 @@ private:
         }
     }
 
-    FrameBuffer8bit &_frameBuffer;
+    FrameBuffer4bit &_frameBuffer;
     int _right;
     int _bottom;
     uint8_t _color = 0xf;
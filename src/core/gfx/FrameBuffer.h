@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include <cstdint>
+#include <cstring>
 
 template<typename T>
 class FrameBuffer {
@@ -46,3 +47,81 @@ private:
 };
 
 using FrameBuffer8bit = FrameBuffer<uint8_t>;
+
+// Frame buffer in the native format of the SSD1322 display controller, two 4 bit pixels per byte with the left
+// pixel in the high nibble. Pixel values saturate at 15. The range of rows written since the last call to
+// clearDirty() is tracked, so the display driver only has to look at rows that might have changed.
+class FrameBuffer4bit {
+public:
+    static constexpr uint8_t MaxValue = 0xf;
+
+    // buffer needs to hold width * height / 2 bytes, width has to be even
+    FrameBuffer4bit(int width, int height, uint8_t *buffer) :
+        _width(width),
+        _height(height),
+        _stride(width / 2),
+        _data(buffer)
+    {
+        std::memset(_data, 0, _stride * _height);
+        markDirty(0, _height - 1);
+    }
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    // number of bytes per row
+    int stride() const { return _stride; }
+
+    const uint8_t *data() const { return _data; }
+          uint8_t *data()       { return _data; }
+
+    const uint8_t *row(int y) const { return &_data[y * _stride]; }
+
+    void fill(uint8_t value) {
+        value = std::min(value, MaxValue);
+        std::memset(_data, value | (value << 4), _stride * _height);
+        markDirty(0, _height - 1);
+    }
+
+    uint8_t get(int x, int y) const {
+        uint8_t pixels = _data[y * _stride + (x >> 1)];
+        return (x & 1) ? (pixels & 0xf) : (pixels >> 4);
+    }
+
+    void set(int x, int y, uint8_t value) {
+        uint8_t &pixels = _data[y * _stride + (x >> 1)];
+        value = std::min(value, MaxValue);
+        pixels = (x & 1) ? ((pixels & 0xf0) | value) : ((pixels & 0x0f) | (value << 4));
+        markDirty(y, y);
+    }
+
+    void add(int x, int y, uint8_t value) {
+        set(x, y, std::min(int(MaxValue), get(x, y) + value));
+    }
+
+    void sub(int x, int y, uint8_t value) {
+        set(x, y, std::max(0, get(x, y) - value));
+    }
+
+    // dirty rows, the range is empty (y0 > y1) if nothing was written
+    int dirtyBegin() const { return _dirtyBegin; }
+    int dirtyEnd() const { return _dirtyEnd; }
+    bool dirty() const { return _dirtyBegin <= _dirtyEnd; }
+
+    void markDirty(int y0, int y1) {
+        _dirtyBegin = std::min(_dirtyBegin, y0);
+        _dirtyEnd = std::max(_dirtyEnd, y1);
+    }
+
+    void clearDirty() {
+        _dirtyBegin = _height;
+        _dirtyEnd = -1;
+    }
+
+private:
+    int _width;
+    int _height;
+    int _stride;
+    uint8_t *_data;
+    int _dirtyBegin = 0;
+    int _dirtyEnd = -1;
+};
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 
 class FnvHash {
 public:
@@ -12,11 +13,27 @@ public:
         _hash *= Prime;
     }
 
+    // FNV-1a is strictly byte serial, hashing a word at a time gives the same result as hashing bytewise.
+    // The gain comes from a single load per word and keeping the hash in a register across the loop.
     void operator()(const void *data, size_t len) {
         const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        uint32_t hash = _hash;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        while (len >= sizeof(uint32_t)) {
+            uint32_t word;
+            std::memcpy(&word, src, sizeof(word));
+            hash = (hash ^ (word & 0xff)) * Prime;
+            hash = (hash ^ ((word >> 8) & 0xff)) * Prime;
+            hash = (hash ^ ((word >> 16) & 0xff)) * Prime;
+            hash = (hash ^ (word >> 24)) * Prime;
+            src += sizeof(uint32_t);
+            len -= sizeof(uint32_t);
+        }
+#endif
         while (len-- > 0) {
-            (*this)(*src++);
+            hash = (hash ^ *src++) * Prime;
         }
+        _hash = hash;
     }
 
 private:
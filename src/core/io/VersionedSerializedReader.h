@@ -14,7 +14,18 @@ public:
         _reader(reader),
         _readerVersion(readerVersion)
     {
-        _reader(&_dataVersion, sizeof(_dataVersion));
+        readRaw(&_dataVersion, sizeof(_dataVersion));
+    }
+
+    // Reads straight from a source object providing read(void *, size_t), bypassing std::function.
+    // The source has to outlive the serialized reader.
+    template<typename Source>
+    VersionedSerializedReader(Source &source, uint32_t readerVersion) :
+        _source(&source),
+        _sourceRead([] (void *source, void *data, size_t len) { static_cast<Source *>(source)->read(data, len); }),
+        _readerVersion(readerVersion)
+    {
+        readRaw(&_dataVersion, sizeof(_dataVersion));
     }
 
     uint32_t readerVersion() const { return _readerVersion; }
@@ -53,7 +64,7 @@ public:
 
     void read(void *data, size_t len, uint32_t addedInVersion) {
         if (_dataVersion >= addedInVersion) {
-            _reader(data, len);
+            readRaw(data, len);
             _hash(data, len);
         }
     }
@@ -66,14 +77,14 @@ public:
     void skip(size_t len, uint32_t addedInVersion, uint32_t removedInVersion) {
         if (_dataVersion >= addedInVersion && _dataVersion < removedInVersion) {
             uint8_t dummy[len];
-            _reader(dummy, len);
+            readRaw(dummy, len);
             _hash(dummy, len);
         }
     }
 
     bool checkHash() {
         uint32_t hash;
-        _reader(&hash, sizeof(hash));
+        readRaw(&hash, sizeof(hash));
         return _hash.result() == hash;
     }
 
@@ -86,7 +97,17 @@ public:
     }
 
 private:
+    void readRaw(void *data, size_t len) {
+        if (_source) {
+            _sourceRead(_source, data, len);
+        } else {
+            _reader(data, len);
+        }
+    }
+
     Reader _reader;
+    void *_source = nullptr;
+    void (*_sourceRead)(void *, void *, size_t) = nullptr;
     uint32_t _readerVersion;
     uint32_t _dataVersion;
     FnvHash _hash;
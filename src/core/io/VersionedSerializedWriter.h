@@ -14,7 +14,19 @@ public:
         _writer(writer),
         _writerVersion(writerVersion)
     {
-        _writer(&_writerVersion, sizeof(_writerVersion));
+        writeRaw(&_writerVersion, sizeof(_writerVersion));
+    }
+
+    // Writes straight to a sink object providing write(const void *, size_t), bypassing std::function.
+    // The sink has to outlive the serialized writer. Sinks providing checkpoint() are notified of checkpoints.
+    template<typename Sink>
+    VersionedSerializedWriter(Sink &sink, uint32_t writerVersion) :
+        _sink(&sink),
+        _sinkWrite([] (void *sink, const void *data, size_t len) { static_cast<Sink *>(sink)->write(data, len); }),
+        _sinkCheckpoint([] (void *sink) { callCheckpoint(static_cast<Sink *>(sink), 0); }),
+        _writerVersion(writerVersion)
+    {
+        writeRaw(&_writerVersion, sizeof(_writerVersion));
     }
 
     uint32_t writerVersion() const { return _writerVersion; }
@@ -32,16 +44,42 @@ public:
 
     void write(const void *data, size_t len) {
         _hash(data, len);
-        _writer(data, len);
+        writeRaw(data, len);
     }
 
     void writeHash() {
         uint32_t hash = _hash.result();
-        _writer(&hash, sizeof(hash));
+        writeRaw(&hash, sizeof(hash));
+    }
+
+    // marks the end of a self-contained part of the data (i.e. an array element)
+    void checkpoint() {
+        if (_sinkCheckpoint) {
+            _sinkCheckpoint(_sink);
+        }
     }
 
 private:
+    template<typename Sink>
+    static auto callCheckpoint(Sink *sink, int) -> decltype(sink->checkpoint(), void()) {
+        sink->checkpoint();
+    }
+
+    template<typename Sink>
+    static void callCheckpoint(Sink *sink, long) {}
+
+    void writeRaw(const void *data, size_t len) {
+        if (_sink) {
+            _sinkWrite(_sink, data, len);
+        } else {
+            _writer(data, len);
+        }
+    }
+
     Writer _writer;
+    void *_sink = nullptr;
+    void (*_sinkWrite)(void *, const void *, size_t) = nullptr;
+    void (*_sinkCheckpoint)(void *) = nullptr;
     uint32_t _writerVersion;
     FnvHash _hash;
 };
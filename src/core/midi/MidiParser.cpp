@@ -6,6 +6,14 @@ static bool isStatusByte(uint8_t byte) {
     return byte & 0x80;
 }
 
+// any status byte other than real-time and end of exclusive interrupts a system exclusive message
+void MidiParser::abortSystemExclusive() {
+    if (_recvSystemExclusive && _sysExBuffer) {
+        _sysExBuffer->abort();
+    }
+    _recvSystemExclusive = false;
+}
+
 bool MidiParser::feed(uint8_t data) {
     // DBG("%02x", data);
     if (isStatusByte(data)) {
@@ -19,11 +27,14 @@ bool MidiParser::feed(uint8_t data) {
             case MidiMessage::SystemExclusive:
                 // start system exclusive receive
                 _recvSystemExclusive = true;
+                if (_sysExBuffer) {
+                    _sysExBuffer->begin();
+                }
                 break;
             case MidiMessage::TimeCode:
             case MidiMessage::SongPosition:
             case MidiMessage::SongSelect:
-                _recvSystemExclusive = false;
+                abortSystemExclusive();
                 // update running status
                 _status = data;
                 // receive data
@@ -31,18 +42,20 @@ bool MidiParser::feed(uint8_t data) {
                 _dataLength = MidiMessage::systemMessageLength(MidiMessage::systemMessage(data));
                 break;
             case MidiMessage::TuneRequest:
-                _recvSystemExclusive = false;
+                abortSystemExclusive();
                 // emit tune-request message
                 _message = MidiMessage(data);
                 return true;
             case MidiMessage::EndOfExclusive:
                 // end system exclusive receive
+                if (_recvSystemExclusive && _sysExBuffer) {
+                    _sysExBuffer->end();
+                }
                 _recvSystemExclusive = false;
-                // TODO emit message
                 break;
             }
         } else if (MidiMessage::isChannelMessage(data)) {
-            _recvSystemExclusive = false;
+            abortSystemExclusive();
             // update running status
             _status = data;
             // receive data
@@ -54,7 +67,9 @@ bool MidiParser::feed(uint8_t data) {
     } else {
         // DBG("data %d data length %d", _dataIndex, _dataLength);
         if (_recvSystemExclusive) {
-            // TODO add to buffer
+            if (_sysExBuffer) {
+                _sysExBuffer->write(data);
+            }
         } else if (_dataLength > 0) {
             _data[_dataIndex++] = data;
             if (_dataIndex == _dataLength) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MidiMessage.h"
+#include "SysExBuffer.h"
 
 #include <cstdint>
 
@@ -9,6 +10,11 @@ public:
     MidiParser() {
     }
 
+    // system exclusive messages are streamed into the given buffer (dropped if there is none)
+    void setSysExBuffer(SysExBuffer *sysExBuffer) {
+        _sysExBuffer = sysExBuffer;
+    }
+
     bool feed(uint8_t data);
 
     const MidiMessage &message() const {
@@ -16,11 +22,14 @@ public:
     }
 
 private:
+    void abortSystemExclusive();
+
     uint8_t _status = 0;
     uint8_t _data[2] = { 0, 0 };
     uint8_t _dataIndex = 0;
     uint8_t _dataLength = 0;
     bool _recvSystemExclusive = false;
+    SysExBuffer *_sysExBuffer = nullptr;
 
     MidiMessage _message;
 };
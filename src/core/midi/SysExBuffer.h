@@ -0,0 +1,152 @@
+#pragma once
+
+#include "core/Debug.h"
+
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+// Ring buffer for streaming system exclusive messages between a single producer and a single consumer.
+// Messages are stored in place including their 0xf0/0xf7 framing and only become visible to the consumer
+// once they are complete. Messages that are aborted or do not fit into the buffer are discarded as a whole.
+// The producer publishes a message with a release store of the committed position, the consumer frees it with a
+// release store of the read position (see RingBuffer).
+// The storage is provided by the owner and its size must be a power of two.
+class SysExBuffer {
+public:
+    SysExBuffer(uint8_t *data, size_t size) :
+        _data(data),
+        _size(size)
+    {
+        ASSERT(size > 0 && (size & (size - 1)) == 0, "buffer size must be a power of two");
+    }
+
+    size_t size() const { return _size; }
+
+    // number of discarded messages
+    uint32_t overflow() const { return _overflow.load(std::memory_order_relaxed); }
+
+    // Producer
+
+    bool receiving() const { return _receiving; }
+
+    // starts a new message, a message that was not ended is discarded
+    void begin() {
+        abort();
+        _receiving = true;
+        write(0xf0);
+    }
+
+    void write(uint8_t data) {
+        if (!_receiving) {
+            return;
+        }
+        if (_write - _read.load(std::memory_order_acquire) >= _size) {
+            _overflowed = true;
+            return;
+        }
+        _data[index(_write)] = data;
+        ++_write;
+    }
+
+    // ends and publishes the current message
+    void end() {
+        if (!_receiving) {
+            return;
+        }
+        write(0xf7);
+        if (_overflowed) {
+            _overflow.fetch_add(1, std::memory_order_relaxed);
+            abort();
+            return;
+        }
+        _receiving = false;
+        _committed.store(_write, std::memory_order_release);
+    }
+
+    // discards the current message
+    void abort() {
+        _write = _committed.load(std::memory_order_relaxed);
+        _receiving = false;
+        _overflowed = false;
+    }
+
+    // feeds a raw byte stream of system exclusive data including framing
+    void feed(const uint8_t *data, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            uint8_t byte = data[i];
+            if (byte == 0xf0) {
+                begin();
+            } else if (byte == 0xf7) {
+                end();
+            } else if (byte >= 0xf8) {
+                // real-time bytes may be interleaved with system exclusive data
+            } else if (byte & 0x80) {
+                abort();
+            } else {
+                write(byte);
+            }
+        }
+    }
+
+    // number of bytes that can be written without discarding the current message
+    size_t writable() const {
+        return _size - (_write - _read.load(std::memory_order_acquire));
+    }
+
+    // writes and publishes a complete message (without framing), fails if there is not enough room
+    bool writeMessage(const uint8_t *data, size_t length) {
+        if (_receiving || writable() < length + 2) {
+            return false;
+        }
+        begin();
+        for (size_t i = 0; i < length; ++i) {
+            write(data[i]);
+        }
+        end();
+        return true;
+    }
+
+    // Consumer
+
+    bool empty() const {
+        return _read.load(std::memory_order_relaxed) == _committed.load(std::memory_order_acquire);
+    }
+
+    // length of the next message including framing, 0 if there is no complete message
+    size_t messageLength() const {
+        size_t read = _read.load(std::memory_order_relaxed);
+        size_t committed = _committed.load(std::memory_order_acquire);
+        for (size_t pos = read; pos != committed; ++pos) {
+            if (_data[index(pos)] == 0xf7) {
+                return pos - read + 1;
+            }
+        }
+        return 0;
+    }
+
+    // byte of the next message, index 0 is the 0xf0 start byte, only valid within messageLength()
+    uint8_t operator[](size_t i) const {
+        return _data[index(_read.load(std::memory_order_relaxed) + i)];
+    }
+
+    // removes the next message (or a part of it) from the buffer
+    void consume(size_t length) {
+        _read.store(_read.load(std::memory_order_relaxed) + length, std::memory_order_release);
+    }
+
+private:
+    size_t index(size_t pos) const { return pos & (_size - 1); }
+
+    uint8_t *_data;
+    size_t _size;
+
+    // read/write positions are free running, size is a power of two
+    std::atomic<size_t> _read { 0 };
+    std::atomic<size_t> _committed { 0 };
+    size_t _write = 0;
+    bool _receiving = false;
+    bool _overflowed = false;
+    std::atomic<uint32_t> _overflow { 0 };
+};
@@ -2,6 +2,8 @@
 
 #include "core/Debug.h"
 
+#include "os/os.h"
+
 #if CONFIG_ENABLE_PROFILER
 int Profiler::_numIntervals;
 int Profiler::_numCounters;
@@ -9,16 +11,19 @@ Profiler::Interval *Profiler::_intervals[Profiler::MaxIntervals];
 Profiler::Counter *Profiler::_counters[Profiler::MaxCounters];
 
 void Profiler::init() {
+    CycleCounter::init();
 }
 
 void Profiler::dump() {
     DBG("Profiler:");
     DBG("---------------------------------------------");
     if (_numIntervals > 0) {
-        DBG("Intervals:");
+        DBG("Intervals (us):");
         for (int i = 0; i < _numIntervals; ++i) {
-            const auto &interval = *_intervals[i];
-            DBG("  %s: %lu us", interval.desc, interval.avg);
+            auto stats = _intervals[i]->stats();
+            DBG("  %s: min %lu avg %lu p99 %lu max %lu (%lu runs, %lu overruns)",
+                _intervals[i]->desc, stats.min, stats.avg, stats.p99, stats.max, stats.count, stats.overruns
+            );
         }
     }
     if (_numCounters > 0) {
@@ -31,6 +36,59 @@ void Profiler::dump() {
     DBG("---------------------------------------------");
 }
 
+void Profiler::reset() {
+    for (int i = 0; i < _numIntervals; ++i) {
+        _intervals[i]->reset();
+    }
+}
+
+Profiler::Interval::Stats Profiler::Interval::stats() const {
+    Stats stats = {};
+    if (resetRequested) {
+        return stats;
+    }
+
+    // copy the statistics in one go, end() runs in the engine task and interrupts
+    Data snapshot;
+    {
+        os::InterruptLock lock;
+        snapshot = data;
+    }
+
+    stats.count = snapshot.count;
+    stats.min = snapshot.count > 0 ? snapshot.min / CycleCounter::CyclesPerUs : 0;
+    stats.avg = snapshot.count > 0 ? uint32_t(snapshot.sum / snapshot.count) / CycleCounter::CyclesPerUs : 0;
+    stats.p99 = snapshot.percentile(99) / CycleCounter::CyclesPerUs;
+    stats.max = snapshot.max / CycleCounter::CyclesPerUs;
+    stats.overruns = snapshot.overruns;
+    return stats;
+}
+
+void Profiler::Interval::Data::clear() {
+    count = 0;
+    min = uint32_t(-1);
+    max = 0;
+    sum = 0;
+    overruns = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        histogram[i] = 0;
+    }
+}
+
+uint32_t Profiler::Interval::Data::percentile(uint32_t percent) const {
+    uint32_t target = (uint64_t(count) * percent + 99) / 100;
+    uint32_t accumulated = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        accumulated += histogram[i];
+        if (accumulated >= target && accumulated > 0) {
+            // upper bound of the bucket, bucket i >= 2 covers [2 + (i & 1), 3 + (i & 1)) << (i / 2 - 1)
+            uint64_t upper = i < 2 ? i + 1 : uint64_t(3 + (i & 1)) << (i / 2 - 1);
+            return upper - 1 < max ? uint32_t(upper - 1) : max;
+        }
+    }
+    return 0;
+}
+
 void Profiler::registerInterval(Interval *interval) {
     if (_numIntervals < MaxIntervals) {
         _intervals[_numIntervals++] = interval;
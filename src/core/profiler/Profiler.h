@@ -2,7 +2,7 @@
 
 #include "SystemConfig.h"
 
-#include "drivers/HighResolutionTimer.h"
+#include "drivers/CycleCounter.h"
 
 #include <cstdint>
 
@@ -13,23 +13,89 @@ public:
     static void init();
     static void dump();
 
+    // requests clearing the statistics of all intervals, applied by the measuring tasks
+    static void reset();
+
+    // Measures the duration of a code section using the cycle counter.
+    // Durations are collected in a histogram with two buckets per power of two, which is used to estimate percentiles.
+    // Intervals with a budget count the runs exceeding it.
     struct Interval {
-        Interval(const char *desc) : desc(desc) {
+        static constexpr int Buckets = 64;
+
+        // statistics in us
+        struct Stats {
+            uint32_t count;
+            uint32_t min;
+            uint32_t avg;
+            uint32_t p99;
+            uint32_t max;
+            uint32_t overruns;
+        };
+
+        Interval(const char *desc, uint32_t budgetUs = 0) :
+            desc(desc),
+            budget(budgetUs * CycleCounter::CyclesPerUs)
+        {
+            data.clear();
             registerInterval(this);
         }
 
         inline void begin() {
-            start = HighResolutionTimer::us();
+            start = CycleCounter::cycles();
         }
 
         inline void end() {
-            uint32_t end = HighResolutionTimer::us();
-            avg = end - start;
+            uint32_t cycles = CycleCounter::cycles() - start;
+            // resets requested from other tasks are applied by the measuring task
+            if (resetRequested) {
+                data.clear();
+                resetRequested = false;
+            }
+            ++data.count;
+            data.sum += cycles;
+            data.min = cycles < data.min ? cycles : data.min;
+            data.max = cycles > data.max ? cycles : data.max;
+            ++data.histogram[bucket(cycles)];
+            if (budget > 0 && cycles > budget) {
+                ++data.overruns;
+            }
         }
 
+        // requests clearing the statistics, applied on the next end()
+        void reset() { resetRequested = true; }
+
+        // consistent snapshot of the statistics, can be called from any task
+        Stats stats() const;
+
         const char *desc;
+        uint32_t budget;
         uint32_t start;
-        uint32_t avg;
+
+    private:
+        struct Data {
+            uint32_t count;
+            uint32_t min;
+            uint32_t max;
+            uint64_t sum;
+            uint32_t overruns;
+            uint32_t histogram[Buckets];
+
+            void clear();
+
+            // upper bound of the given percentile in cycles
+            uint32_t percentile(uint32_t percent) const;
+        };
+
+        Data data;
+        volatile bool resetRequested = false;
+
+        static inline int bucket(uint32_t cycles) {
+            if (cycles < 2) {
+                return cycles;
+            }
+            int msb = 31 - __builtin_clz(cycles);
+            return 2 * msb + ((cycles >> (msb - 1)) & 1);
+        }
     };
 
     struct Counter {
@@ -45,6 +111,12 @@ public:
         uint32_t count;
     };
 
+    static int intervalCount() { return _numIntervals; }
+    static const Interval &interval(int index) { return *_intervals[index]; }
+
+    static int counterCount() { return _numCounters; }
+    static const Counter &counter(int index) { return *_counters[index]; }
+
 private:
     static const int MaxIntervals = 16;
     static const int MaxCounters = 16;
@@ -60,6 +132,8 @@ private:
 
 # define PROFILER_INTERVAL(_name_, _desc_) \
     static Profiler::Interval _name_##_profiler_interval(_desc_);
+# define PROFILER_INTERVAL_BUDGET(_name_, _desc_, _budgetUs_) \
+    static Profiler::Interval _name_##_profiler_interval(_desc_, _budgetUs_);
 # define PROFILER_INTERVAL_BEGIN(_name_) \
     _name_##_profiler_interval.begin();
 # define PROFILER_INTERVAL_END(_name_) \
@@ -67,7 +141,7 @@ private:
 
 # define PROFILER_COUNTER(_name_, _desc_) \
     static Profiler::Counter _name_##_profiler_counter(_desc_);
-# define PROFILER_COUNTER_ADD(_num_) \
+# define PROFILER_COUNTER_ADD(_name_, _num_) \
     _name_##_profiler_counter.add(_num_);
 
 #else // CONFIG_ENABLE_PROFILER
@@ -76,13 +150,15 @@ class Profiler {
 public:
     static void init() {}
     static void dump() {}
+    static void reset() {}
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_)
+# define PROFILER_INTERVAL_BUDGET(_name_, _desc_, _budgetUs_)
 # define PROFILER_INTERVAL_BEGIN(_name_)
 # define PROFILER_INTERVAL_END(_name_)
 
 # define PROFILER_COUNTER(_name_, _desc_)
-# define PROFILER_COUNTER_ADD(_num_)
+# define PROFILER_COUNTER_ADD(_name_, _num_)
 
 #endif // CONFIG_ENABLE_PROFILER
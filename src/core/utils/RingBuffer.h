@@ -1,61 +1,81 @@
 #pragma once
 
+#include <atomic>
+
 #include <cstddef>
 
+// Lock-free single producer, single consumer queue.
+// One context (i.e. an interrupt handler or task) writes while another one reads, without disabling interrupts.
+// The producer publishes entries with a release store of the write position, the consumer frees them with a
+// release store of the read position. Both positions are free running, Size must be a power of two.
+// Multiple producers (or consumers) have to serialize access to their end of the queue.
 template<typename T, size_t Size>
 class RingBuffer {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "size must be a power of two");
+
 public:
     inline size_t size() const { return Size; }
 
-    inline bool empty() const { return _read == _write; }
+    inline bool empty() const { return readable() == 0; }
 
     inline bool full() const { return writable() == 0; }
 
-    inline size_t entries() const { return (_write - _read) % Size; }
+    inline size_t entries() const { return readable(); }
 
     inline size_t writable() const {
-        return (_read - _write - 1) % Size;
+        return Size - (_write.load(std::memory_order_acquire) - _read.load(std::memory_order_acquire));
     }
 
     inline size_t readable() const {
-        return (_write - _read) % Size;
+        return _write.load(std::memory_order_acquire) - _read.load(std::memory_order_acquire);
     }
 
-    inline void write(T value) {
-        size_t write = _write;
-        _buffer[write] = value;
-        _write = (write + 1) % Size;
+    // producer only, returns false if the queue is full
+    inline bool write(T value) {
+        size_t write = _write.load(std::memory_order_relaxed);
+        if (write - _read.load(std::memory_order_acquire) == Size) {
+            return false;
+        }
+        _buffer[write & (Size - 1)] = value;
+        _write.store(write + 1, std::memory_order_release);
+        return true;
     }
 
-    inline void write(const T *data, size_t length) {
-        while (length--) {
-            write(*data++);
+    // producer only, returns the number of entries written
+    inline size_t write(const T *data, size_t length) {
+        size_t written = 0;
+        while (written < length && write(data[written])) {
+            ++written;
         }
+        return written;
     }
 
+    // consumer only, the queue must not be empty
     inline T read() {
-        size_t read = _read;
-        T value = _buffer[read];
-        _read = (read + 1) % Size;
+        size_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & (Size - 1)];
+        _read.store(read + 1, std::memory_order_release);
         return value;
     }
 
+    // consumer only, the queue must not be empty
     inline T readAndReplace(const T &replacement = T()) {
-        size_t read = _read;
-        T value = _buffer[read];
-        _buffer[read] = replacement;
-        _read = (read + 1) % Size;
+        size_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & (Size - 1)];
+        _buffer[read & (Size - 1)] = replacement;
+        _read.store(read + 1, std::memory_order_release);
         return value;
     }
 
+    // consumer only, the queue must hold at least length entries
     inline void read(T *data, size_t length) {
         while (length--) {
-            read(*data++);
+            *data++ = read();
         }
     }
 
 private:
     T _buffer[Size];
-    volatile size_t _read = 0;
-    volatile size_t _write = 0;
+    std::atomic<size_t> _read { 0 };
+    std::atomic<size_t> _write { 0 };
 };
@@ -30,6 +30,7 @@ public:
 
     void disable() {
         _enabled = false;
+        _simulator.outputJitterMonitor().clockStop();
     }
 
     uint32_t period() const {
@@ -53,9 +54,13 @@ private:
         double ticks = _simulator.ticks();
         while (ticks - _lastTicks >= _periodTicks) {
             _lastTicks += _periodTicks;
+            // run the interrupt at its exact sub-millisecond time
+            _simulator.enterInterrupt(_lastTicks);
+            _simulator.outputJitterMonitor().clockTick(_lastTicks);
             if (_listener) {
                 _listener->onClockTimerTick();
             }
+            _simulator.leaveInterrupt();
         }
     }
 
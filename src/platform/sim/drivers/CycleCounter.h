@@ -0,0 +1,18 @@
+#pragma once
+
+#include <chrono>
+
+#include <cstdint>
+
+// Counts nanoseconds on the simulator.
+class CycleCounter {
+public:
+    static constexpr uint32_t CyclesPerUs = 1000;
+
+    static void init() {}
+
+    static inline uint32_t cycles() {
+        auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+        return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+};
@@ -2,12 +2,60 @@
 
 #include "SystemConfig.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <cstdint>
+#include <cstring>
 
+// Emulates the STM32F405 flash in RAM so flash backed storage can be used in the simulator.
 class Flash {
 public:
+    static constexpr uint32_t BaseAddress = 0x08000000;
+    static constexpr uint32_t Size = 1024 * 1024;
+
     static void unlock() {}
     static void lock() {}
-    static void eraseSector(uint32_t sector) {}
-    static void program(uint32_t address, uint32_t data) {}
+
+    static void eraseSector(uint32_t sector) {
+        uint32_t begin = sectorAddress(sector);
+        uint32_t end = sectorAddress(sector + 1);
+        std::memset(&memory()[begin - BaseAddress], 0xff, end - begin);
+    }
+
+    static void program(uint32_t address, uint32_t data) {
+        if (address < BaseAddress || address + sizeof(data) > BaseAddress + Size) {
+            return;
+        }
+        // programming can only clear bits
+        uint8_t *dst = &memory()[address - BaseAddress];
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(&data);
+        for (size_t i = 0; i < sizeof(data); ++i) {
+            dst[i] &= src[i];
+        }
+    }
+
+    static void read(uint32_t address, void *data, size_t len) {
+        if (address < BaseAddress || address + len > BaseAddress + Size) {
+            std::memset(data, 0xff, len);
+            return;
+        }
+        std::memcpy(data, &memory()[address - BaseAddress], len);
+    }
+
+private:
+    static uint32_t sectorAddress(uint32_t sector) {
+        if (sector < 4) {
+            return BaseAddress + sector * 0x4000;
+        } else if (sector == 4) {
+            return BaseAddress + 0x10000;
+        } else {
+            return std::min(BaseAddress + 0x20000 + (sector - 5) * 0x20000, BaseAddress + Size);
+        }
+    }
+
+    static uint8_t *memory() {
+        static std::vector<uint8_t> memory(Size, 0xff);
+        return memory.data();
+    }
 };
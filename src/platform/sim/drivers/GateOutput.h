@@ -18,6 +18,10 @@ public:
         }
     }
 
+    void commit() {
+        update();
+    }
+
     inline uint8_t gates() const { return _gates; }
 
     inline void setGates(uint8_t gates) {
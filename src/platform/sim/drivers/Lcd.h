@@ -5,8 +5,9 @@
 
 #include "SystemConfig.h"
 
+#include "core/gfx/FrameBuffer.h"
+
 #include <cstdint>
-#include <cstring>
 
 class Lcd {
 public:
@@ -19,9 +20,21 @@ public:
 
     void init() {}
 
-    void draw(uint8_t *frameBuffer) {
-        std::memcpy(_frameBuffer.data(), frameBuffer, _frameBuffer.size());
+    // frames are only rendered when the simulator is not running headless or a frame was requested
+    bool visible() const { return _simulator.renderFrame(); }
+
+    bool draw(FrameBuffer4bit &frameBuffer, bool wait = false) {
+        if (!frameBuffer.dirty()) {
+            return true;
+        }
+        for (int y = frameBuffer.dirtyBegin(); y <= frameBuffer.dirtyEnd(); ++y) {
+            for (int x = 0; x < Width; ++x) {
+                _frameBuffer[y * Width + x] = frameBuffer.get(x, y);
+            }
+        }
+        frameBuffer.clearDirty();
         _simulator.writeLcd(_frameBuffer);
+        return true;
     }
 
 private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/midi/SysExBuffer.h"
 
 #include "sim/Simulator.h"
 
@@ -26,6 +27,17 @@ public:
         return true;
     }
 
+    bool sendRealTime(uint8_t data) {
+        return send(MidiMessage(data));
+    }
+
+    bool sendSysEx(const uint8_t *data, size_t length) {
+        sim::MidiEvent::splitSysEx(0, data, length, [this] (const sim::MidiEvent &event) {
+            _simulator.writeMidiOutput(event);
+        });
+        return true;
+    }
+
     bool recv(MidiMessage *message) {
         if (!_recvQueue.empty()) {
             *message = _recvQueue.front();
@@ -35,11 +47,14 @@ public:
         return false;
     }
 
+    SysExBuffer &sysExBuffer() { return _sysExBuffer; }
+
     void setRecvFilter(RecvFilter filter) {
         _recvFilter = filter;
     }
 
     uint32_t rxOverflow() const { return 0; }
+    uint32_t txOverflow() const { return 0; }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
@@ -48,9 +63,15 @@ private:
                 _recvQueue.emplace_back(event.message);
             }
         }
+        if (event.port == 0 && event.kind == sim::MidiEvent::SysExData) {
+            _sysExBuffer.feed(event.sysEx.data, event.sysEx.length);
+        }
     }
 
     sim::Simulator &_simulator;
     std::deque<MidiMessage> _recvQueue;
     RecvFilter _recvFilter;
+
+    uint8_t _sysExData[512];
+    SysExBuffer _sysExBuffer { _sysExData, sizeof(_sysExData) };
 };
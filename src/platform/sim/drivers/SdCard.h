@@ -32,18 +32,45 @@ public:
     size_t sectorCount() const { return SectorCount; }
     size_t sectorSize() const { return SectorSize; }
 
-    bool read(uint8_t *buf, uint32_t sector, uint8_t count) {
+    bool read(uint8_t *buf, uint32_t sector, uint32_t count) {
         ASSERT(sector >= 0 && sector + count <= SectorCount, "invalid read range");
         memcpy(buf, &_data[sector * SectorSize], count * SectorSize);
         return true;
     }
 
-    bool write(const uint8_t *buf, uint32_t sector, uint8_t count) {
+    bool write(const uint8_t *buf, uint32_t sector, uint32_t count) {
         ASSERT(sector >= 0 && sector + count <= SectorCount, "invalid write range");
         memcpy(&_data[sector * SectorSize], buf, count * SectorSize);
         return true;
     }
 
+    // transfers are carried out when they are finished, so buffers touched too early show up as corrupted data
+    bool startRead(uint8_t *buf, uint32_t sector, uint32_t count) {
+        ASSERT(!_transfer.active, "transfer in progress");
+        _transfer = { true, false, buf, sector, count };
+        return true;
+    }
+
+    bool startWrite(const uint8_t *buf, uint32_t sector, uint32_t count) {
+        ASSERT(!_transfer.active, "transfer in progress");
+        _transfer = { true, true, const_cast<uint8_t *>(buf), sector, count };
+        return true;
+    }
+
+    bool transferBusy() const {
+        return _transfer.active;
+    }
+
+    bool finishTransfer() {
+        if (!_transfer.active) {
+            return false;
+        }
+        _transfer.active = false;
+        return _transfer.write ? write(_transfer.buf, _transfer.sector, _transfer.count) : read(_transfer.buf, _transfer.sector, _transfer.count);
+    }
+
+    static constexpr uint32_t MaxTransferBlocks = 0xffff;
+
     void sync() {
         std::ofstream ofs("sdcard.iso");
         ofs.write(reinterpret_cast<const char *>(_data.get()), SectorCount * SectorSize);
@@ -54,5 +81,14 @@ private:
     static constexpr size_t SectorCount = 1024;
     static constexpr size_t SectorSize = 512;
 
+    struct Transfer {
+        bool active;
+        bool write;
+        uint8_t *buf;
+        uint32_t sector;
+        uint32_t count;
+    };
+
     std::unique_ptr<uint8_t[]> _data;
+    Transfer _transfer = { false, false, nullptr, 0, 0 };
 };
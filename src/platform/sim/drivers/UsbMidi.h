@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/midi/SysExBuffer.h"
 
 #include "sim/Simulator.h"
 
@@ -29,6 +30,15 @@ public:
         return true;
     }
 
+    bool sendSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+        sim::MidiEvent::splitSysEx(1, data, length, [this] (const sim::MidiEvent &event) {
+            _simulator.writeMidiOutput(event);
+        });
+        return true;
+    }
+
+    SysExBuffer &sysExBuffer() { return _sysExBuffer; }
+
     bool recv(uint8_t *cable, MidiMessage *message) {
         if (!_recvQueue.empty()) {
             *cable = 0;
@@ -52,6 +62,7 @@ public:
     }
 
     uint32_t rxOverflow() const { return 0; }
+    uint32_t txOverflow() const { return 0; }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
@@ -72,6 +83,9 @@ private:
                     _recvQueue.emplace_back(event.message);
                 }
                 break;
+            case sim::MidiEvent::SysExData:
+                _sysExBuffer.feed(event.sysEx.data, event.sysEx.length);
+                break;
             }
         }
     }
@@ -82,4 +96,7 @@ private:
 
     sim::Simulator &_simulator;
     std::deque<MidiMessage> _recvQueue;
+
+    uint8_t _sysExData[1024];
+    SysExBuffer _sysExBuffer { _sysExData, sizeof(_sysExData) };
 };
@@ -14,6 +14,24 @@ namespace os {
 
     typedef int TaskHandle;
 
+    // tasks are not preemptive on the simulator, there is nothing to profile
+    class TaskProfiler {
+    public:
+        struct TaskInfo {
+            const char *name;
+            uint8_t priority;
+            uint16_t stackSize;
+            uint16_t stackFree;
+            uint8_t load;
+        };
+
+        static void update() {}
+        static void dump() {}
+
+        template<typename Func>
+        static void enumerate(Func func) {}
+    };
+
     template<size_t StackSize>
     class Task {
     public:
@@ -167,4 +185,10 @@ namespace os {
     inline void startScheduler() {
     }
 
+    inline void suspendScheduler() {
+    }
+
+    inline void resumeScheduler() {
+    }
+
 } // namespace os
@@ -2,6 +2,10 @@
 
 #include "core/midi/MidiMessage.h"
 
+#include <algorithm>
+
+#include <cstring>
+#include <cstddef>
 #include <cstdint>
 
 namespace sim {
@@ -11,6 +15,7 @@ struct MidiEvent {
         Connect,
         Disconnect,
         Message,
+        SysExData,
     };
 
     int kind;
@@ -20,6 +25,11 @@ struct MidiEvent {
         uint16_t vendorId;
         uint16_t productId;
     } connect;
+    // system exclusive messages are passed in chunks of up to 3 bytes (like usb midi packets)
+    struct {
+        uint8_t data[3];
+        uint8_t length;
+    } sysEx;
 
     MidiEvent() : message() {}
     MidiEvent(Kind kind, int port) : kind(kind), port(port) {}
@@ -43,6 +53,27 @@ struct MidiEvent {
         event.message = message;
         return event;
     }
+
+    static MidiEvent makeSysExData(int port, const uint8_t *data, size_t length) {
+        MidiEvent event(SysExData, port);
+        event.sysEx.length = std::min(length, sizeof(event.sysEx.data));
+        std::memcpy(event.sysEx.data, data, event.sysEx.length);
+        return event;
+    }
+
+    // splits a system exclusive message (data without 0xf0/0xf7 framing) into chunks
+    template<typename Handler>
+    static void splitSysEx(int port, const uint8_t *data, size_t length, Handler handler) {
+        uint8_t chunk[3];
+        size_t chunkLength = 0;
+        for (size_t i = 0; i < length + 2; ++i) {
+            chunk[chunkLength++] = i == 0 ? 0xf0 : (i == length + 1 ? 0xf7 : data[i - 1]);
+            if (chunkLength == sizeof(chunk) || i == length + 1) {
+                handler(makeSysExData(port, chunk, chunkLength));
+                chunkLength = 0;
+            }
+        }
+    }
 };
 
 } // namespace sim
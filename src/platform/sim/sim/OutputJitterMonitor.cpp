@@ -0,0 +1,72 @@
+#include "OutputJitterMonitor.h"
+
+#include "tinyformat.h"
+
+#include <algorithm>
+
+namespace sim {
+
+OutputJitterMonitor::OutputJitterMonitor(std::function<double()> timeCallback) :
+    _timeCallback(timeCallback)
+{
+    reset();
+}
+
+void OutputJitterMonitor::reset() {
+    _lastClockTick = -1.0;
+    _gates.fill(false);
+    _edges.clear();
+}
+
+void OutputJitterMonitor::clockTick(double time) {
+    _lastClockTick = time;
+}
+
+void OutputJitterMonitor::clockStop() {
+    _lastClockTick = -1.0;
+}
+
+OutputJitterMonitor::Summary OutputJitterMonitor::summary() const {
+    Summary summary;
+    if (_edges.empty()) {
+        return summary;
+    }
+
+    summary.count = _edges.size();
+    summary.min = _edges.front().jitter;
+    summary.max = _edges.front().jitter;
+    double sum = 0.0;
+    for (const auto &edge : _edges) {
+        summary.min = std::min(summary.min, edge.jitter);
+        summary.max = std::max(summary.max, edge.jitter);
+        sum += edge.jitter;
+    }
+    summary.avg = sum / _edges.size();
+
+    return summary;
+}
+
+void OutputJitterMonitor::dump(std::ostream &stream) const {
+    for (const auto &edge : _edges) {
+        stream << tfm::format("gate %d %s @ %10.3f ms jitter %.3f ms", edge.channel + 1, edge.value ? "on " : "off", edge.time, edge.jitter) << std::endl;
+    }
+    auto s = summary();
+    stream << tfm::format("%d edges, jitter min %.3f ms avg %.3f ms max %.3f ms", s.count, s.min, s.avg, s.max) << std::endl;
+}
+
+void OutputJitterMonitor::writeGateOutput(int channel, bool value) {
+    if (channel < 0 || channel >= GateCount || _gates[channel] == value) {
+        return;
+    }
+    _gates[channel] = value;
+
+    // only measure edges while the clock is running
+    if (_lastClockTick < 0.0) {
+        return;
+    }
+
+    double time = _timeCallback();
+    _edges.push_back({ channel, value, time, time - _lastClockTick });
+}
+
+} // namespace sim
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Target.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+#include <iostream>
+
+#include <cstdint>
+
+namespace sim {
+
+// Measures the timing of gate output edges relative to the clock timer ticks.
+// The jitter of an edge is the time between the most recent clock tick and the edge appearing on the output.
+class OutputJitterMonitor : public TargetOutputHandler {
+public:
+    static constexpr int GateCount = 8;
+
+    struct Edge {
+        int channel;
+        bool value;
+        double time;    // ms
+        double jitter;  // ms
+    };
+
+    struct Summary {
+        size_t count = 0;
+        double min = 0.0;
+        double avg = 0.0;
+        double max = 0.0;
+    };
+
+    OutputJitterMonitor(std::function<double()> timeCallback);
+
+    void reset();
+
+    // called from the simulated clock timer
+    void clockTick(double time);
+    void clockStop();
+
+    const std::vector<Edge> &edges() const { return _edges; }
+    Summary summary() const;
+
+    void dump(std::ostream &stream = std::cout) const;
+
+    // TargetOutputHandler
+    virtual void writeGateOutput(int channel, bool value) override;
+
+private:
+    std::function<double()> _timeCallback;
+    double _lastClockTick = -1.0;
+    std::array<bool, GateCount> _gates;
+    std::vector<Edge> _edges;
+};
+
+} // namespace sim
@@ -0,0 +1,115 @@
+#include "OutputTrace.h"
+
+#include "tinyformat.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <cmath>
+
+namespace sim {
+
+OutputTrace::OutputTrace(std::function<double()> timeCallback) :
+    _timeCallback(timeCallback)
+{
+    _gates.fill(false);
+    _dac.fill(0);
+}
+
+void OutputTrace::start() {
+    _recording = true;
+}
+
+void OutputTrace::stop() {
+    _recording = false;
+}
+
+void OutputTrace::clear() {
+    _events.clear();
+}
+
+std::string OutputTrace::text() const {
+    std::ostringstream stream;
+    for (const auto &event : _events) {
+        switch (event.kind) {
+        case Event::Gate:
+            stream << tfm::format("%d G%d %d\n", event.time, event.index + 1, event.value);
+            break;
+        case Event::Cv:
+            stream << tfm::format("%d C%d %d\n", event.time, event.index + 1, event.value);
+            break;
+        case Event::Midi:
+            stream << tfm::format("%d M%d", event.time, event.index);
+            for (int i = 0; i < event.length; ++i) {
+                stream << tfm::format(" %02x", int(event.data[i]));
+            }
+            stream << "\n";
+            break;
+        }
+    }
+    return stream.str();
+}
+
+void OutputTrace::saveToText(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    ofs << text();
+}
+
+uint64_t OutputTrace::hash() const {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : text()) {
+        hash ^= uint8_t(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void OutputTrace::writeGateOutput(int channel, bool value) {
+    if (channel < 0 || channel >= GateCount || _gates[channel] == value) {
+        return;
+    }
+    _gates[channel] = value;
+    if (_recording) {
+        _events.push_back({ time(), Event::Gate, uint8_t(channel), 0, { 0, 0, 0 }, uint16_t(value) });
+    }
+}
+
+void OutputTrace::writeDac(int channel, uint16_t value) {
+    if (channel < 0 || channel >= DacCount || _dac[channel] == value) {
+        return;
+    }
+    _dac[channel] = value;
+    if (_recording) {
+        _events.push_back({ time(), Event::Cv, uint8_t(channel), 0, { 0, 0, 0 }, value });
+    }
+}
+
+void OutputTrace::writeMidiOutput(MidiEvent event) {
+    if (!_recording) {
+        return;
+    }
+    Event traceEvent = { time(), Event::Midi, uint8_t(event.port), 0, { 0, 0, 0 }, 0 };
+    switch (event.kind) {
+    case MidiEvent::Message:
+        traceEvent.length = event.message.length();
+        for (int i = 0; i < traceEvent.length; ++i) {
+            traceEvent.data[i] = event.message.raw()[i];
+        }
+        break;
+    case MidiEvent::SysExData:
+        traceEvent.length = event.sysEx.length;
+        for (int i = 0; i < traceEvent.length; ++i) {
+            traceEvent.data[i] = event.sysEx.data[i];
+        }
+        break;
+    default:
+        return;
+    }
+    _events.push_back(traceEvent);
+}
+
+uint64_t OutputTrace::time() const {
+    return uint64_t(std::llround(_timeCallback() * 1000.0));
+}
+
+} // namespace sim
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Target.h"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace sim {
+
+// Compact trace of the gate, cv and midi outputs for regression testing long runs.
+// Only changes are recorded, times are in microseconds of simulated time. The text form has one event per line:
+//   <time> G<channel> <0|1>
+//   <time> C<channel> <dac value>
+//   <time> M<port> <hex bytes>
+class OutputTrace : public TargetOutputHandler {
+public:
+    static constexpr int GateCount = 8;
+    static constexpr int DacCount = 8;
+
+    struct Event {
+        enum Kind : uint8_t {
+            Gate,
+            Cv,
+            Midi,
+        };
+
+        uint64_t time;
+        Kind kind;
+        uint8_t index;
+        uint8_t length;
+        uint8_t data[3];
+        uint16_t value;
+    };
+
+    OutputTrace(std::function<double()> timeCallback);
+
+    // recording starts from the current output state, the initial state is not part of the trace
+    void start();
+    void stop();
+    void clear();
+
+    bool recording() const { return _recording; }
+
+    const std::vector<Event> &events() const { return _events; }
+
+    std::string text() const;
+    void saveToText(const std::string &filename) const;
+
+    // fnv-1a hash of the text form
+    uint64_t hash() const;
+
+    // TargetOutputHandler
+    virtual void writeGateOutput(int channel, bool value) override;
+    virtual void writeDac(int channel, uint16_t value) override;
+    virtual void writeMidiOutput(MidiEvent event) override;
+
+private:
+    uint64_t time() const;
+
+    std::function<double()> _timeCallback;
+    bool _recording = false;
+    std::array<bool, GateCount> _gates;
+    std::array<uint16_t, DacCount> _dac;
+    std::vector<Event> _events;
+};
+
+} // namespace sim
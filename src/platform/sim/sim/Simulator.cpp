@@ -20,12 +20,16 @@ static Simulator *g_instance;
 
 Simulator::Simulator(Target target) :
     _target(target),
-    _targetStateTracker(_targetState)
+    _targetStateTracker(_targetState),
+    _outputJitterMonitor([this] () { return time(); }),
+    _outputTrace([this] () { return time(); })
 {
     g_instance = this;
 
     registerTargetInputObserver(&_targetStateTracker);
     registerTargetOutputObserver(&_targetStateTracker);
+    registerTargetOutputObserver(&_outputJitterMonitor);
+    registerTargetOutputObserver(&_outputTrace);
 }
 
 Simulator::~Simulator() {
@@ -162,6 +166,7 @@ void Simulator::writeDigitalOutput(int pin, bool value) {
 }
 
 void Simulator::writeLcd(const FrameBuffer &frameBuffer) {
+    _frameRequested = false;
     for (auto observer : _targetOutputObservers) {
         observer->writeLcd(frameBuffer);
     }
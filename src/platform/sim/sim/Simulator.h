@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Target.h"
+#include "OutputJitterMonitor.h"
+#include "OutputTrace.h"
 #include "TargetStateTracker.h"
 #include "TargetTrace.h"
 
@@ -28,10 +30,27 @@ public:
 
     void screenshot(const std::string &filename);
 
+    // Headless mode skips rendering the display, only frames that are explicitly requested are rendered.
+    // Used to run long sessions faster than realtime.
+    void setHeadless(bool headless) { _headless = headless; }
+    bool headless() const { return _headless; }
+
+    // renders the next display frame in headless mode
+    void requestFrame() { _frameRequested = true; }
+    bool renderFrame() const { return !_headless || _frameRequested; }
+
     const TargetState &targetState() const { return _targetState; }
 
     double ticks();
 
+    // current time in ms including the sub-millisecond offset while servicing a simulated interrupt
+    double time() const { return _interruptTime >= 0.0 ? _interruptTime : double(_tick); }
+    void enterInterrupt(double time) { _interruptTime = time; }
+    void leaveInterrupt() { _interruptTime = -1.0; }
+
+    OutputJitterMonitor &outputJitterMonitor() { return _outputJitterMonitor; }
+    OutputTrace &outputTrace() { return _outputTrace; }
+
     typedef std::function<void()> UpdateCallback;
 
     void addUpdateCallback(UpdateCallback callback);
@@ -66,6 +85,9 @@ private:
     bool _targetCreated = false;
 
     uint32_t _tick = 0;
+    double _interruptTime = -1.0;
+    bool _headless = false;
+    bool _frameRequested = false;
 
     std::vector<TargetTickHandler *> _targetTickObservers;
     std::vector<TargetInputHandler *> _targetInputObservers;
@@ -75,6 +97,8 @@ private:
 
     TargetState _targetState;
     TargetStateTracker _targetStateTracker;
+    OutputJitterMonitor _outputJitterMonitor;
+    OutputTrace _outputTrace;
 };
 
 } // namespace sim
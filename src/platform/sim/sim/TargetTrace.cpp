@@ -119,6 +119,16 @@ static std::ostream &operator<<(std::ostream &os, const MidiEvent &event) {
                 os << " ";
             };
         }
+        break;
+    case MidiEvent::SysExData:
+        os << "sysex ";
+        for (int i = 0; i < event.sysEx.length; ++i) {
+            os << std::hex << int(event.sysEx.data[i]);
+            if (i < event.sysEx.length - 1) {
+                os << " ";
+            };
+        }
+        break;
     }
     return os;
 }
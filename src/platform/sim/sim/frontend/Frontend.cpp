@@ -375,7 +375,11 @@ void Frontend::setupMidi() {
         midiPortConfig.portIn,
         midiPortConfig.portOut,
         [this] (const std::vector<uint8_t> &message) {
-            if (message.size() >= 1 && message.size() <= 3) {
+            if (message.size() >= 2 && message.front() == 0xf0 && message.back() == 0xf7) {
+                MidiEvent::splitSysEx(0, message.data() + 1, message.size() - 2, [this] (const MidiEvent &event) {
+                    _simulator.writeMidiInput(event);
+                });
+            } else if (message.size() >= 1 && message.size() <= 3) {
                 _simulator.writeMidiInput(MidiEvent::makeMessage(0, MidiMessage(message.data(), message.size())));
             }
         }
@@ -387,7 +391,11 @@ void Frontend::setupMidi() {
         usbMidiPortConfig.portIn,
         usbMidiPortConfig.portOut,
         [this] (const std::vector<uint8_t> &message) {
-            if (message.size() >= 1 && message.size() <= 3) {
+            if (message.size() >= 2 && message.front() == 0xf0 && message.back() == 0xf7) {
+                MidiEvent::splitSysEx(1, message.data() + 1, message.size() - 2, [this] (const MidiEvent &event) {
+                    _simulator.writeMidiInput(event);
+                });
+            } else if (message.size() >= 1 && message.size() <= 3) {
                 _simulator.writeMidiInput(MidiEvent::makeMessage(1, MidiMessage(message.data(), message.size())));
             }
         },
@@ -490,6 +498,15 @@ void Frontend::writeMidiOutput(MidiEvent event) {
             }
             break;
         }
+    } else if (event.kind == MidiEvent::SysExData && event.port >= 0 && event.port < int(_sysExOutput.size())) {
+        auto &data = _sysExOutput[event.port];
+        const auto &sysEx = event.sysEx;
+        data.insert(data.end(), sysEx.data, sysEx.data + sysEx.length);
+        if (sysEx.length > 0 && sysEx.data[sysEx.length - 1] == 0xf7) {
+            auto &port = event.port == 0 ? _midiPort : _usbMidiPort;
+            port->send(data.data(), data.size());
+            data.clear();
+        }
     }
 }
 
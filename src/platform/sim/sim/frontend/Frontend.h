@@ -17,6 +17,7 @@
 
 #include "sim/Simulator.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,8 @@ private:
     Midi _midi;
     std::shared_ptr<Midi::Port> _midiPort;
     std::shared_ptr<Midi::Port> _usbMidiPort;
+    // system exclusive messages sent by the target are collected per port
+    std::array<std::vector<uint8_t>, 2> _sysExOutput;
 
     std::unique_ptr<ClockSource> _clockSource;
 
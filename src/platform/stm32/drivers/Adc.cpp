@@ -30,7 +30,8 @@ void Adc::init() {
     uint8_t channels[] = { 0, 1, 2, 3 };
     static_assert(sizeof(channels) == Channels, "invalid channel count");
     adc_set_regular_sequence(ADC1, Channels, channels);
-    adc_set_sample_time_on_all_channels(ADC1, ADC_SMPR_SMP_480CYC);
+    // 10.5 MHz ADC clock, (144 + 12) cycles per conversion, one scan takes ~60 us
+    adc_set_sample_time_on_all_channels(ADC1, ADC_SMPR_SMP_144CYC);
 
     adc_enable_scan_mode(ADC1);
     adc_set_continuous_conversion_mode(ADC1);
@@ -40,12 +41,12 @@ void Adc::init() {
 
     dma_stream_reset(DMA2, DMA_STREAM0);
     dma_set_peripheral_address(DMA2, DMA_STREAM0, reinterpret_cast<uint32_t>(&ADC_DR(ADC1)));
-    dma_set_memory_address(DMA2, DMA_STREAM0, reinterpret_cast<uint32_t>(_channels));
+    dma_set_memory_address(DMA2, DMA_STREAM0, reinterpret_cast<uint32_t>(_samples));
     dma_enable_memory_increment_mode(DMA2, DMA_STREAM0);
     dma_set_peripheral_size(DMA2, DMA_STREAM0, DMA_SxCR_PSIZE_16BIT);
     dma_set_memory_size(DMA2, DMA_STREAM0, DMA_SxCR_MSIZE_16BIT);
     dma_set_priority(DMA2, DMA_STREAM0, DMA_SxCR_PL_LOW);
-    dma_set_number_of_data(DMA2, DMA_STREAM0, Channels);
+    dma_set_number_of_data(DMA2, DMA_STREAM0, Oversample * Channels);
     dma_enable_circular_mode(DMA2, DMA_STREAM0);
     dma_set_transfer_mode(DMA2, DMA_STREAM0, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
     dma_channel_select(DMA2, DMA_STREAM0, DMA_SxCR_CHSEL_0);
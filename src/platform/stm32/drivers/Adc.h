@@ -5,16 +5,26 @@
 #include <cstdint>
 #include <cstdlib>
 
+// Continuously scans all channels into a circular DMA buffer holding the last Oversample scans.
+// Reading a channel decimates by averaging all of its samples (boxcar filter over roughly 1 ms).
+// Note: the sample buffer is written by DMA, so instances must not be placed in CCMRAM.
 class Adc {
 public:
     static constexpr int Channels = CONFIG_ADC_CHANNELS;
+    static constexpr int Oversample = CONFIG_ADC_OVERSAMPLE;
+    static_assert((Oversample & (Oversample - 1)) == 0, "oversample must be a power of two");
 
     void init();
 
     uint16_t channel(int index) const {
-        return _channels[index];
+        // 12 bit left aligned samples, averaging adds resolution below the 12 bits
+        uint32_t sum = 0;
+        for (int i = 0; i < Oversample; ++i) {
+            sum += _samples[i * Channels + index];
+        }
+        return sum / Oversample;
     }
 
 private:
-    uint16_t _channels[Channels];
+    volatile uint16_t _samples[Oversample * Channels];
 };
@@ -40,11 +40,16 @@ void ButtonLedMatrix::process() {
         uint8_t scanRow = (_row + 6) % Rows;
         for (int col = 0; col < ColsButton; ++col) {
             int buttonIndex = col * Rows + scanRow;
-            auto &state = _buttonState[buttonIndex].state;
+            auto &buttonState = _buttonState[buttonIndex];
+            if (buttonState.counter > 0) {
+                --buttonState.counter;
+                continue;
+            }
             bool newState = !(buttonData & (1 << col));
-            if (newState != state) {
-                state = newState;
-                _events.write(Event(state ? Event::KeyDown : Event::KeyUp, buttonIndex));
+            if (newState != buttonState.state) {
+                buttonState.state = newState;
+                buttonState.counter = DebounceSamples;
+                _events.write(Event(newState ? Event::KeyDown : Event::KeyUp, buttonIndex));
             }
         }
     }
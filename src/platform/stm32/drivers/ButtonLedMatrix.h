@@ -72,6 +72,7 @@ public:
         return buttonState(col * Rows + row);
     }
 
+    // scans one row, called after each shift register transfer (from interrupt context when scanning)
     void process();
 
     inline bool nextEvent(Event &event) {
@@ -83,6 +84,11 @@ public:
     }
 
 private:
+    // a button change is reported right away, further changes are ignored for the following samples
+    // (1 sample per row scan, 5ms at the default scan rate)
+    static constexpr uint8_t DebounceSamples = 5;
+
+    // leds are modulated in every row scan, the intensity sets the density of the on cycles
     struct Led {
         uint8_t intensity : 4;
         uint8_t counter : 4;
@@ -101,8 +107,8 @@ private:
     } __attribute__((packed));
 
     struct ButtonState {
-        uint8_t state;
-        // uint8_t counter : 7;
+        uint8_t state : 1;
+        uint8_t counter : 7;
     };
 
     ShiftRegister &_shiftRegister;
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "SystemConfig.h"
+
+#include <libopencm3/cm3/dwt.h>
+
+#include <cstdint>
+
+// Cycle counter of the data watchpoint and trace unit.
+// Counts core clock cycles and wraps around every 25 seconds, only differences of short intervals are meaningful.
+class CycleCounter {
+public:
+    static constexpr uint32_t CyclesPerUs = CONFIG_CPU_FREQUENCY / 1000000;
+
+    static void init() {
+        dwt_enable_cycle_counter();
+    }
+
+    static inline uint32_t cycles() {
+        return DWT_CYCCNT;
+    }
+};
@@ -4,10 +4,14 @@
 
 #include "core/Debug.h"
 
+#include "os/os.h"
+
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/spi.h>
 
+#include <algorithm>
+
 #define DAC_SPI SPI3
 
 #define DAC_PORT GPIOB
@@ -29,6 +33,8 @@ Dac::Dac(Type type)
     case Type::DAC8568C: _dataShift = 0; break;
     case Type::DAC8568A: _dataShift = 1; break;
     }
+
+    std::fill(_written, _written + Channels, -1);
 }
 
 void Dac::init() {
@@ -68,13 +74,25 @@ void Dac::init() {
     writeDac(POWER_DOWN_UP_DAC, 0, 0, 0xff);
 }
 
-void Dac::write(int channel) {
-    writeDac(WRITE_INPUT_REGISTER_UPDATE_N, channel, _values[channel], 15);
-}
-
+// Sends one command for each changed channel. The channels are written to the input registers, the last command
+// also updates all dac registers, so the outputs change at the same time.
+// channels are also written from interrupt context (output scheduler)
 void Dac::write() {
+    os::InterruptLock lock;
+
+    int last = -1;
     for (int channel = 0; channel < Channels; ++channel) {
-        writeDac(channel == 7 ? WRITE_INPUT_REGISTER_UPDATE_ALL : WRITE_INPUT_REGISTER, channel, _values[channel], 0);
+        if (_values[channel] != _written[channel]) {
+            last = channel;
+        }
+    }
+
+    for (int channel = 0; channel <= last; ++channel) {
+        Value value = _values[channel];
+        if (value != _written[channel]) {
+            _written[channel] = value;
+            writeDac(channel == last ? WRITE_INPUT_REGISTER_UPDATE_ALL : WRITE_INPUT_REGISTER, channel, value, 0);
+        }
     }
 }
 
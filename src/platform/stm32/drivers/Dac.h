@@ -24,7 +24,8 @@ public:
         _values[channel] = value;
     }
 
-    void write(int channel);
+    // Writes the channels that changed since they were last written and updates all outputs simultaneously.
+    // Can be called from interrupts.
     void write();
 
 private:
@@ -43,5 +44,7 @@ private:
     void setClearCode(ClearCode code);
 
     Value _values[Channels];
+    // last written values, -1 if not written yet
+    int32_t _written[Channels];
     uint32_t _dataShift = 0;
 };
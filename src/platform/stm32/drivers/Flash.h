@@ -5,6 +5,7 @@
 #include <libopencm3/stm32/flash.h>
 
 #include <cstdint>
+#include <cstring>
 
 class Flash {
 public:
@@ -25,4 +26,8 @@ public:
         flash_program_word(address, data);
         flash_wait_for_last_operation();
     }
+
+    static void read(uint32_t address, void *data, size_t len) {
+        std::memcpy(data, reinterpret_cast<const void *>(address), len);
+    }
 };
@@ -10,3 +10,7 @@ void GateOutput::init() {
 void GateOutput::update() {
     _shiftRegister.write(2, _gates);
 }
+
+void GateOutput::commit() {
+    _shiftRegister.writeImmediate(2, _gates);
+}
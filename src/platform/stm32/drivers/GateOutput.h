@@ -12,6 +12,9 @@ public:
 
     void update();
 
+    // write gates to the shift register immediately (interrupt safe)
+    void commit();
+
     inline uint8_t gates() const { return _gates; }
 
     inline void setGates(uint8_t gates) {
@@ -11,6 +11,7 @@
 #include <libopencm3/stm32/dma.h>
 
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 #define LCD_PORT GPIOB
@@ -123,37 +124,64 @@ void Lcd::init() {
     initialize();
 }
 
-void Lcd::draw(uint8_t *frameBuffer) {
+bool Lcd::draw(FrameBuffer4bit &frameBuffer, bool wait) {
 #ifdef LCD_USE_DMA
-    // wait until previous frame is sent
-    while (!txDone) {}
-    txDone = 0;
+    // never spin on the previous frame unless asked to
+    if (!txDone) {
+        if (!wait) {
+            return false;
+        }
+        while (!txDone) {}
+    }
 #endif // LCD_USE_DMA
 
-    // copy buffer
-    uint8_t *src = frameBuffer;
+    if (_fullRefresh) {
+        frameBuffer.markDirty(0, Height - 1);
+    }
+
+    // copy changed rows and find the range of rows to send
+    int y0 = Height;
+    int y1 = -1;
     uint8_t *dst = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int i = 0; i < Width * Height / 2; ++i) {
-        uint8_t a = *src++;
-        uint8_t b = *src++;
-        *dst++ = std::min(b, uint8_t(15)) | (std::min(a, uint8_t(15)) << 4);
-        // *dst++ = (b >> 4) | ((a >> 4) << 4);
+    for (int y = frameBuffer.dirtyBegin(); y <= frameBuffer.dirtyEnd(); ++y) {
+        const uint8_t *src = frameBuffer.row(y);
+        uint8_t *row = &dst[y * RowBytes];
+        if (_fullRefresh || std::memcmp(row, src, RowBytes) != 0) {
+            std::memcpy(row, src, RowBytes);
+            y0 = std::min(y0, y);
+            y1 = y;
+        }
     }
+    frameBuffer.clearDirty();
+    _fullRefresh = false;
 
+    if (y0 <= y1) {
+        startTransfer(y0, y1);
+    }
 
-#ifdef LCD_USE_DMA
+    return true;
+}
 
+void Lcd::startTransfer(int y0, int y1) {
+    // the column window always spans the full display width, the row window only the changed rows
     setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
+    setRowAddr(y0, y1);
     setWrite();
 
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(_frameBuffer) + y0 * RowBytes;
+    size_t len = (y1 - y0 + 1) * RowBytes;
+
+#ifdef LCD_USE_DMA
+
+    txDone = 0;
+
     waitTxDone();
     gpio_set(LCD_PORT, LCD_DC);
 
     dma_stream_reset(LCD_DMA, LCD_DMA_STREAM);
     dma_set_peripheral_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(&LCD_SPI_DR));
-    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(_frameBuffer));
-    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, sizeof(_frameBuffer));
+    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(src));
+    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, len);
     dma_channel_select(LCD_DMA, LCD_DMA_STREAM, LCD_DMA_CHANNEL);
     dma_set_priority(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PL_HIGH);
 
@@ -172,15 +200,8 @@ void Lcd::draw(uint8_t *frameBuffer) {
 
 #else // LCD_USE_DMA
 
-    setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
-    setWrite();
-
-    src = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int y = 0; y < Height; y++) {
-        for (int x = 0; x < Width/2; x++) {
-            sendData(*src++);
-        }
+    while (len-- > 0) {
+        sendData(*src++);
     }
 
 #endif // LCD_USE_DMA
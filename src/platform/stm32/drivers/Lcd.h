@@ -2,6 +2,8 @@
 
 #include "SystemConfig.h"
 
+#include "core/gfx/FrameBuffer.h"
+
 #include <cstdint>
 #include <cstdlib>
 
@@ -12,7 +14,12 @@ public:
 
     void init();
 
-    void draw(uint8_t *frameBuffer);
+    bool visible() const { return true; }
+
+    // Sends the rows of the frame buffer that changed since the last transfer, the dirty range of the frame
+    // buffer is cleared once it was consumed. If the previous transfer is still in progress the frame is
+    // skipped and false is returned, the changes are picked up by the next call. Set wait to block instead.
+    bool draw(FrameBuffer4bit &frameBuffer, bool wait = false);
 
 private:
     void sendCmd(uint8_t cmd);
@@ -24,5 +31,11 @@ private:
     void setRowAddr(uint8_t a, uint8_t b);
     void setWrite();
 
+    void startTransfer(int y0, int y1);
+
+    static constexpr int RowBytes = Width / 2;
+
+    // copy of the data on the display, source of the dma transfers
     uint32_t _frameBuffer[Width * Height / 8];
+    bool _fullRefresh = true;
 };
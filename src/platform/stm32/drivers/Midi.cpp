@@ -7,10 +7,15 @@
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/usart.h>
+#include <libopencm3/stm32/dma.h>
 #include <libopencm3/cm3/nvic.h>
 
 #define MIDI_USART USART6
 
+#define MIDI_TX_DMA DMA2
+#define MIDI_TX_DMA_STREAM DMA_STREAM6
+#define MIDI_TX_DMA_CHANNEL DMA_SxCR_CHSEL_5
+
 static Midi *g_midi = nullptr;
 
 void Midi::init() {
@@ -35,11 +40,98 @@ void Midi::init() {
 
     nvic_set_priority(NVIC_USART6_IRQ, CONFIG_MIDI_IRQ_PRIORITY);
     nvic_enable_irq(NVIC_USART6_IRQ);
+
+    // setup tx dma
+    rcc_periph_clock_enable(RCC_DMA2);
+    dma_stream_reset(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+    nvic_set_priority(NVIC_DMA2_STREAM6_IRQ, CONFIG_MIDI_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_DMA2_STREAM6_IRQ);
 }
 
 bool Midi::send(const MidiMessage &message) {
-    for (uint8_t i = 0; i < message.length(); ++i) {
-        send(message.raw()[i]);
+    if (message.isRealTimeMessage()) {
+        return sendRealTime(message.status());
+    }
+
+    os::InterruptLock lock;
+
+    // replace value of a pending message instead of sending stale data
+    if (isMergeable(message.status()) && mergeMessage(message)) {
+        return true;
+    }
+
+    // make room by dropping stale controller data, but never drop notes in favor of controllers
+    if (txQueueEntries() == TxQueueSize) {
+        if (isMergeable(message.status()) || !dropMergeableMessage()) {
+            ++_txOverflow;
+            return false;
+        }
+        ++_txOverflow;
+    }
+
+    auto &txMessage = _txQueue[txQueueIndex(_txWrite)];
+    txMessage.length = message.length();
+    for (uint8_t i = 0; i < txMessage.length; ++i) {
+        txMessage.data[i] = message.raw()[i];
+    }
+    _txWrite = _txWrite + 1;
+
+    if (!_txActive) {
+        startTransmit();
+    }
+
+    return true;
+}
+
+bool Midi::sendRealTime(uint8_t data) {
+    os::InterruptLock lock;
+
+    if (_txRealTime.full()) {
+        ++_txOverflow;
+        return false;
+    }
+
+    _txRealTime.write(data);
+
+    if (!_txActive) {
+        startTransmit();
+    }
+
+    return true;
+}
+
+bool Midi::sendSysEx(const uint8_t *data, size_t length) {
+    os::InterruptLock lock;
+
+    // the message is queued in chunks of up to 3 bytes, all chunks are queued at once so no other message can
+    // end up in the middle of the system exclusive message (real-time bytes are allowed in between)
+    // half of the queue is left to other messages, a long transfer must not push out notes
+    size_t chunks = (length + 2 + 2) / 3;
+    if (txQueueEntries() + chunks > TxQueueSize / 2) {
+        return false;
+    }
+
+    size_t messageLength = length + 2;
+    for (size_t messageIndex = 0; messageIndex < messageLength; ) {
+        auto &txMessage = _txQueue[txQueueIndex(_txWrite)];
+        txMessage.length = 0;
+        while (txMessage.length < 3 && messageIndex < messageLength) {
+            uint8_t byte;
+            if (messageIndex == 0) {
+                byte = 0xf0;
+            } else if (messageIndex == messageLength - 1) {
+                byte = 0xf7;
+            } else {
+                byte = data[messageIndex - 1];
+            }
+            txMessage.data[txMessage.length++] = byte;
+            ++messageIndex;
+        }
+        _txWrite = _txWrite + 1;
+    }
+
+    if (!_txActive) {
+        startTransmit();
     }
 
     return true;
@@ -59,48 +151,144 @@ void Midi::setRecvFilter(RecvFilter filter) {
     _recvFilter = filter;
 }
 
-void Midi::send(uint8_t data) {
-    os::InterruptLock lock;
+// must be called with interrupts disabled
+void Midi::startTransmit() {
+    size_t length = 0;
 
-    // block until there is space in the tx buffer
-    while (_txBuffer.full()) {
-        usart_wait_send_ready(MIDI_USART);
-        usart_send(MIDI_USART, _txBuffer.read());
+    if (!_txRealTime.empty()) {
+        // real-time bytes are injected between messages and don't affect running status
+        _txDmaBuffer[length++] = _txRealTime.read();
+    } else if (txQueueEntries() > 0) {
+        const auto &txMessage = _txQueue[txQueueIndex(_txRead)];
+        uint8_t status = txMessage.data[0];
+        // running status: omit status byte if it matches the last sent channel message
+        bool skipStatus = MidiMessage::isChannelMessage(status) && status == _txRunningStatus;
+        _txRunningStatus = MidiMessage::isChannelMessage(status) ? status : 0;
+        for (uint8_t i = skipStatus ? 1 : 0; i < txMessage.length; ++i) {
+            _txDmaBuffer[length++] = txMessage.data[i];
+        }
+        _txRead = _txRead + 1;
     }
 
-    _txBuffer.write(data);
-
-    // start transmission if necessary
-    if (!_txActive) {
-        _txActive = 1;
-        usart_wait_send_ready(MIDI_USART);
-        usart_send(MIDI_USART, _txBuffer.read());
-        usart_enable_tx_interrupt(MIDI_USART);
+    if (length == 0) {
+        // restart with a full status byte after the line went idle
+        _txRunningStatus = 0;
+        _txActive = 0;
+        return;
     }
+
+    _txActive = 1;
+
+    dma_stream_reset(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+    dma_set_peripheral_address(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, reinterpret_cast<uint32_t>(&USART_DR(MIDI_USART)));
+    dma_set_memory_address(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, reinterpret_cast<uint32_t>(_txDmaBuffer));
+    dma_set_number_of_data(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, length);
+    dma_channel_select(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, MIDI_TX_DMA_CHANNEL);
+    dma_set_priority(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_SxCR_PL_MEDIUM);
+
+    dma_set_transfer_mode(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    dma_set_memory_size(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_SxCR_MSIZE_8BIT);
+    dma_set_peripheral_size(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_SxCR_PSIZE_8BIT);
+
+    dma_enable_memory_increment_mode(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+    dma_disable_peripheral_increment_mode(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+
+    dma_enable_transfer_complete_interrupt(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+
+    dma_enable_stream(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+
+    usart_enable_tx_dma(MIDI_USART);
 }
 
-void Midi::handleIrq() {
-    os::InterruptLock lock;
-    if (usart_get_flag(MIDI_USART, USART_SR_TXE)) {
-        if (_txBuffer.empty()) {
-            usart_disable_tx_interrupt(MIDI_USART);
-            _txActive = 0;
+// Merges into a queued message of the same kind. Only the trailing run of mergeable messages of the channel is
+// searched, a value must not move across a note or program change it was sent after.
+// must be called with interrupts disabled
+bool Midi::mergeMessage(const MidiMessage &message) {
+    for (size_t pos = _txWrite; pos != _txRead; --pos) {
+        auto &txMessage = _txQueue[txQueueIndex(pos - 1)];
+        uint8_t status = txMessage.data[0];
+        if (!MidiMessage::isChannelMessage(status) || (status & 0x0f) != message.channel()) {
+            continue;
+        }
+        if (!isMergeable(status)) {
+            return false;
+        }
+        if (status != message.status()) {
+            continue;
+        }
+        if (message.isControlChange()) {
+            if (txMessage.data[1] == message.data0()) {
+                txMessage.data[2] = message.data1();
+                return true;
+            }
         } else {
-            usart_send(MIDI_USART, _txBuffer.read());
+            for (uint8_t i = 1; i < message.length(); ++i) {
+                txMessage.data[i] = message.raw()[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// must be called with interrupts disabled
+bool Midi::dropMergeableMessage() {
+    for (size_t pos = _txRead; pos != _txWrite; ++pos) {
+        if (isMergeable(_txQueue[txQueueIndex(pos)].data[0])) {
+            // close the gap by moving all older messages up by one
+            for (; pos != _txRead; --pos) {
+                _txQueue[txQueueIndex(pos)] = _txQueue[txQueueIndex(pos - 1)];
+            }
+            _txRead = _txRead + 1;
+            return true;
         }
     }
+    return false;
+}
+
+bool Midi::isMergeable(uint8_t status) {
+    if (!MidiMessage::isChannelMessage(status)) {
+        return false;
+    }
+    switch (MidiMessage::channelMessage(status)) {
+    case MidiMessage::ControlChange:
+    case MidiMessage::ChannelPressure:
+    case MidiMessage::PitchBend:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// the interrupt is the only producer of the receive buffer, no locking needed
+void Midi::handleIrq() {
     if (usart_get_flag(MIDI_USART, USART_SR_RXNE)) {
         uint8_t data = usart_recv(MIDI_USART);
         if (!_recvFilter || !_recvFilter(data)) {
-            if (_rxBuffer.full()) {
-                // overflow
+            if (!_rxBuffer.write(data)) {
+                // overflow, drop the byte
                 ++_rxOverflow;
             }
-            _rxBuffer.write(data);
         }
     }
 }
 
+// locked against the clock timer interrupt, which queues real-time bytes
+void Midi::handleTxDmaIrq() {
+    os::InterruptLock lock;
+    if (dma_get_interrupt_flag(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_TCIF)) {
+        dma_clear_interrupt_flags(MIDI_TX_DMA, MIDI_TX_DMA_STREAM, DMA_TCIF);
+        dma_disable_stream(MIDI_TX_DMA, MIDI_TX_DMA_STREAM);
+        usart_disable_tx_dma(MIDI_USART);
+
+        startTransmit();
+    }
+}
+
 void usart6_isr() {
     g_midi->handleIrq();
 }
+
+void dma2_stream6_isr() {
+    g_midi->handleTxDmaIrq();
+}
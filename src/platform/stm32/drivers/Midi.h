@@ -2,34 +2,85 @@
 
 #include "core/midi/MidiMessage.h"
 #include "core/midi/MidiParser.h"
+#include "core/midi/SysExBuffer.h"
 #include "core/utils/RingBuffer.h"
 
+#include <array>
 #include <functional>
 
 #include <cstdint>
 
+// MIDI DIN driver.
+// Note: the transmit path uses DMA, so instances must not be placed in CCMRAM.
 class Midi {
 public:
     typedef std::function<bool(uint8_t)> RecvFilter;
 
+    Midi() {
+        _midiParser.setSysExBuffer(&_sysExBuffer);
+    }
+
     void init();
 
+    // queue a message for transmission, never blocks
+    // pending continuous controller messages (CC, pitch bend, channel pressure) are merged with newer values
     bool send(const MidiMessage &message);
+
+    // send a real-time byte (clock, start, stop ...) ahead of all queued messages
+    bool sendRealTime(uint8_t data);
+
+    // queue a complete system exclusive message (data without 0xf0/0xf7 framing), never blocks
+    // fails if the message does not fit into the transmit queue as a whole, the caller is expected to retry
+    bool sendSysEx(const uint8_t *data, size_t length);
+
     bool recv(MidiMessage *message);
 
+    // received system exclusive messages, filled when calling recv()
+    SysExBuffer &sysExBuffer() { return _sysExBuffer; }
+
     void setRecvFilter(RecvFilter filter);
 
     uint32_t rxOverflow() const { return _rxOverflow; }
+    uint32_t txOverflow() const { return _txOverflow; }
 
     void handleIrq();
+    void handleTxDmaIrq();
+
 private:
-    void send(uint8_t data);
+    static constexpr size_t TxQueueSize = 64;
+    static_assert((TxQueueSize & (TxQueueSize - 1)) == 0, "tx queue size must be a power of two");
+
+    struct TxMessage {
+        uint8_t data[3];
+        uint8_t length;
+    };
+
+    void startTransmit();
+
+    bool mergeMessage(const MidiMessage &message);
+    bool dropMergeableMessage();
+
+    static bool isMergeable(uint8_t status);
+
+    // read/write positions are free running, TxQueueSize is a power of two
+    size_t txQueueEntries() const { return _txWrite - _txRead; }
+    static size_t txQueueIndex(size_t pos) { return pos % TxQueueSize; }
+
+    std::array<TxMessage, TxQueueSize> _txQueue;
+    volatile size_t _txRead = 0;
+    volatile size_t _txWrite = 0;
+    RingBuffer<uint8_t, 16> _txRealTime;
+    uint8_t _txDmaBuffer[3];
+    uint8_t _txRunningStatus = 0;
+    volatile uint32_t _txActive = 0;
+    volatile uint32_t _txOverflow = 0;
 
-    RingBuffer<uint8_t, 64> _txBuffer;
     RingBuffer<uint8_t, 64> _rxBuffer;
     volatile uint32_t _rxOverflow = 0;
-    volatile uint32_t _txActive = 0;
 
     RecvFilter _recvFilter;
     MidiParser _midiParser;
+
+    uint8_t _sysExData[512];
+    SysExBuffer _sysExBuffer { _sysExData, sizeof(_sysExData) };
 };
@@ -9,6 +9,8 @@
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/sdio.h>
 
+#include <algorithm>
+
 void SdCard::init() {
     rcc_periph_clock_enable(RCC_SDIO);
     rcc_periph_clock_enable(RCC_DMA2);
@@ -55,26 +57,30 @@ bool SdCard::writeProtected() {
     return false;
 }
 
-bool SdCard::read(uint8_t *buf, uint32_t sector, uint8_t count) {
+bool SdCard::read(uint8_t *buf, uint32_t sector, uint32_t count) {
     // DBG("read(sector=%d,count=%d)", sector, count);
-    uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!readBlock(sector + i, data)) {
+    while (count > 0) {
+        uint32_t blocks = std::min(count, uint32_t(MaxTransferBlocks));
+        if (!startRead(buf, sector, blocks) || !finishTransfer()) {
             return false;
         }
-        data += 512;
+        buf += blocks * 512;
+        sector += blocks;
+        count -= blocks;
     }
     return true;
 }
 
-bool SdCard::write(const uint8_t *buf, uint32_t sector, uint8_t count) {
+bool SdCard::write(const uint8_t *buf, uint32_t sector, uint32_t count) {
     // DBG("write(sector=%d,count=%d)", sector, count);
-    const uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!writeBlock(sector + i, data)) {
+    while (count > 0) {
+        uint32_t blocks = std::min(count, uint32_t(MaxTransferBlocks));
+        if (!startWrite(buf, sector, blocks) || !finishTransfer()) {
             return false;
         }
-        data += 512;
+        buf += blocks * 512;
+        sector += blocks;
+        count -= blocks;
     }
     return true;
 }
@@ -307,98 +313,45 @@ bool SdCard::waitDataReady() {
     return false;
 }
 
-bool SdCard::readBlock(uint32_t address, void *buffer) {
-    ASSERT(buffer >= (void *)0x20000000, "buffer not in SRAM");
-    // DBG("readBlock(address=%lu, buffer=%p)", address, buffer);
-    if (!waitDataReady()) {
-        return false;
-    }
-
-    if (!_cardInfo.ccs) {
-        address *= 512;
-        if (sendCommandRetry(16, 512) != Success) {
-            return false;
-        }
-    }
-
-    SDIO_DCTRL = 0;
+void SdCard::setupDma(const void *buffer, bool write) {
+    // unaligned buffers (handed in by FatFS when reading into or writing from user memory) are transferred bytewise,
+    // the dma fifo packs them into words for the sdio fifo
+    bool aligned = (reinterpret_cast<uint32_t>(buffer) & 3) == 0;
 
-#if 1
     dma_stream_reset(DMA2, DMA_STREAM3);
     dma_channel_select(DMA2, DMA_STREAM3, DMA_SxCR_CHSEL_4);
-    dma_set_memory_size(DMA2, DMA_STREAM3, DMA_SxCR_MSIZE_32BIT);
+    dma_set_memory_size(DMA2, DMA_STREAM3, aligned ? DMA_SxCR_MSIZE_32BIT : DMA_SxCR_MSIZE_8BIT);
     dma_set_peripheral_size(DMA2, DMA_STREAM3, DMA_SxCR_PSIZE_32BIT);
     dma_enable_memory_increment_mode(DMA2, DMA_STREAM3);
     dma_disable_peripheral_increment_mode(DMA2, DMA_STREAM3);
-    dma_set_transfer_mode(DMA2, DMA_STREAM3, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
+    dma_set_transfer_mode(DMA2, DMA_STREAM3, write ? DMA_SxCR_DIR_MEM_TO_PERIPHERAL : DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
     dma_set_peripheral_address(DMA2, DMA_STREAM3, (uint32_t)&SDIO_FIFO);
     dma_set_memory_address(DMA2, DMA_STREAM3, (uint32_t)buffer);
     dma_set_number_of_data(DMA2, DMA_STREAM3, 0);
     dma_set_priority(DMA2, DMA_STREAM3, DMA_SxCR_PL_VERY_HIGH);
-    // dma_set_peripheral_flow_control(DMA2, DMA_STREAM3);
 
-    dma_set_memory_burst(DMA2, DMA_STREAM3, DMA_SxCR_MBURST_INCR4);
+    dma_set_memory_burst(DMA2, DMA_STREAM3, aligned ? DMA_SxCR_MBURST_INCR4 : DMA_SxCR_MBURST_SINGLE);
     dma_set_peripheral_burst(DMA2, DMA_STREAM3, DMA_SxCR_PBURST_INCR4);
     dma_disable_double_buffer_mode(DMA2, DMA_STREAM3);
-    // dma_enable_circular_mode(DMA2, DMA_STREAM3);
 
     dma_enable_fifo_mode(DMA2, DMA_STREAM3);
     dma_set_fifo_threshold(DMA2, DMA_STREAM3, DMA_SxFCR_FTH_4_4_FULL);
+    // the sdio controls the number of transferred words, this allows transfers of any number of blocks
     dma_set_peripheral_flow_control(DMA2, DMA_STREAM3);
 
     dma_enable_stream(DMA2, DMA_STREAM3);
-#endif
-
-    // A 100ms timeout expressed as ticks in the 24Mhz bus clock.
-    SDIO_DTIMER = 2400000;
-
-    // These two registers must be set before SDIO_DCTRL.
-    SDIO_DLEN = 512;
-    SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN |
-                 SDIO_DCTRL_DTDIR | SDIO_DCTRL_DTEN;
-
-    if (sendCommandWait(17, address) != Success) {
-        return false;
-    }
-
-    const uint32_t DATA_RX_ERROR_FLAGS = (SDIO_STA_STBITERR |
-                                          SDIO_STA_RXOVERR |
-                                          SDIO_STA_DTIMEOUT |
-                                          SDIO_STA_DCRCFAIL);
-    const uint32_t DATA_RX_SUCCESS_FLAGS = (SDIO_STA_DBCKEND |
-                                            SDIO_STA_DATAEND);
-
-    while (!dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
-        // allow other tasks to run
-        os::this_task::yield();
-    }
-
-    while (true) {
-        volatile uint32_t result = SDIO_STA;
-        // DBG("STA = 0x%x", result);
-        // DBG("FIFOCNT = %d", SDIO_FIFOCNT);
-        if (result & (DATA_RX_SUCCESS_FLAGS | DATA_RX_ERROR_FLAGS)) {
-            if (result & DATA_RX_ERROR_FLAGS) {
-                return false;
-            } else if (result & DATA_RX_SUCCESS_FLAGS) {
-                break;
-            }
-        }
-
-        // allow other tasks to run
-        os::this_task::yield();
-    }
-
-    return true;
 }
 
-bool SdCard::writeBlock(uint32_t address, const void *buffer) {
+bool SdCard::startTransfer(const void *buffer, uint32_t block, uint32_t count, bool write) {
     ASSERT(buffer >= (void *)0x20000000, "buffer not in SRAM");
-    // DBG("writeBlock(address=%lu, buffer=%p)", address, buffer);
+    ASSERT(!_transfer.active, "transfer in progress");
+    ASSERT(count > 0 && count <= MaxTransferBlocks, "invalid block count");
+
     if (!waitDataReady()) {
         return false;
     }
 
+    uint32_t address = block;
     if (!_cardInfo.ccs) {
         address *= 512;
         if (sendCommandRetry(16, 512) != Success) {
@@ -406,71 +359,102 @@ bool SdCard::writeBlock(uint32_t address, const void *buffer) {
         }
     }
 
-    if (sendCommandWait(24, address) != Success) {
-        return false;
-    }
+    bool multiBlock = count > 1;
 
     SDIO_DCTRL = 0;
 
-#if 1
-    dma_stream_reset(DMA2, DMA_STREAM3);
-    dma_channel_select(DMA2, DMA_STREAM3, DMA_SxCR_CHSEL_4);
-    dma_set_memory_size(DMA2, DMA_STREAM3, DMA_SxCR_MSIZE_32BIT);
-    dma_set_peripheral_size(DMA2, DMA_STREAM3, DMA_SxCR_PSIZE_32BIT);
-    dma_enable_memory_increment_mode(DMA2, DMA_STREAM3);
-    dma_disable_peripheral_increment_mode(DMA2, DMA_STREAM3);
-    dma_set_transfer_mode(DMA2, DMA_STREAM3, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
-    dma_set_peripheral_address(DMA2, DMA_STREAM3, (uint32_t)&SDIO_FIFO);
-    dma_set_memory_address(DMA2, DMA_STREAM3, (uint32_t)buffer);
-    dma_set_number_of_data(DMA2, DMA_STREAM3, 0);
-    dma_set_priority(DMA2, DMA_STREAM3, DMA_SxCR_PL_VERY_HIGH);
-    // dma_set_peripheral_flow_control(DMA2, DMA_STREAM3);
+    if (write) {
+        // let the card pre-erase the blocks that are about to be written (ACMD23)
+        if (multiBlock && sendAppCommand(23, count) != Success) {
+            return false;
+        }
+        // WRITE_BLOCK (CMD24) or WRITE_MULTIPLE_BLOCK (CMD25)
+        if (sendCommandWait(multiBlock ? 25 : 24, address) != Success) {
+            return false;
+        }
+        setupDma(buffer, true);
+        // A 500ms timeout expressed as ticks in the 24Mhz bus clock.
+        SDIO_DTIMER = 12000000;
+        // These two registers must be set before SDIO_DCTRL.
+        SDIO_DLEN = count * 512;
+        SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN;
+    } else {
+        setupDma(buffer, false);
+        // A 100ms timeout expressed as ticks in the 24Mhz bus clock.
+        SDIO_DTIMER = 2400000;
+        // These two registers must be set before SDIO_DCTRL.
+        SDIO_DLEN = count * 512;
+        SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTDIR | SDIO_DCTRL_DTEN;
+        // READ_SINGLE_BLOCK (CMD17) or READ_MULTIPLE_BLOCK (CMD18)
+        if (sendCommandWait(multiBlock ? 18 : 17, address) != Success) {
+            SDIO_DCTRL = 0;
+            dma_disable_stream(DMA2, DMA_STREAM3);
+            return false;
+        }
+    }
 
-    dma_set_memory_burst(DMA2, DMA_STREAM3, DMA_SxCR_MBURST_INCR4);
-    dma_set_peripheral_burst(DMA2, DMA_STREAM3, DMA_SxCR_PBURST_INCR4);
-    dma_disable_double_buffer_mode(DMA2, DMA_STREAM3);
-    // dma_enable_circular_mode(DMA2, DMA_STREAM3);
+    _transfer.active = true;
+    _transfer.write = write;
+    _transfer.multiBlock = multiBlock;
 
-    dma_enable_fifo_mode(DMA2, DMA_STREAM3);
-    dma_set_fifo_threshold(DMA2, DMA_STREAM3, DMA_SxFCR_FTH_4_4_FULL);
-    dma_set_peripheral_flow_control(DMA2, DMA_STREAM3);
+    return true;
+}
 
-    dma_enable_stream(DMA2, DMA_STREAM3);
-#endif
+bool SdCard::startRead(uint8_t *buf, uint32_t sector, uint32_t count) {
+    return startTransfer(buf, sector, count, false);
+}
 
-    // A 500ms timeout expressed as ticks in the 24Mhz bus clock.
-    SDIO_DTIMER = 12000000;
-    // These two registers must be set before SDIO_DCTRL.
-    SDIO_DLEN = 512;
-    SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN;
+bool SdCard::startWrite(const uint8_t *buf, uint32_t sector, uint32_t count) {
+    return startTransfer(buf, sector, count, true);
+}
 
-    const uint32_t DATA_TX_ERROR_FLAGS = (SDIO_STA_STBITERR |
-                                          SDIO_STA_TXUNDERR |
-                                          SDIO_STA_DTIMEOUT |
-                                          SDIO_STA_DCRCFAIL);
-    const uint32_t DATA_TX_SUCCESS_FLAGS = (SDIO_STA_DBCKEND |
-                                            SDIO_STA_DATAEND);
+bool SdCard::transferBusy() const {
+    return _transfer.active && !(SDIO_STA & (SDIO_STA_DATAEND | SDIO_STA_STBITERR | SDIO_STA_TXUNDERR | SDIO_STA_RXOVERR |
+                                             SDIO_STA_DTIMEOUT | SDIO_STA_DCRCFAIL));
+}
 
-    while (!dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
-        // allow other tasks to run
-        os::this_task::yield();
+bool SdCard::finishTransfer() {
+    if (!_transfer.active) {
+        return false;
     }
 
+    const uint32_t DATA_ERROR_FLAGS = (SDIO_STA_STBITERR |
+                                       (_transfer.write ? SDIO_STA_TXUNDERR : SDIO_STA_RXOVERR) |
+                                       SDIO_STA_DTIMEOUT |
+                                       SDIO_STA_DCRCFAIL);
+    // DBCKEND is set after every block, only DATAEND marks the end of a multi block transfer
+    const uint32_t DATA_SUCCESS_FLAGS = SDIO_STA_DATAEND;
+
+    bool success = true;
+
     while (true) {
         volatile uint32_t result = SDIO_STA;
-        // DBG("STA = 0x%x", result);
-        // DBG("FIFOCNT = %d", SDIO_FIFOCNT);
-        if (result & (DATA_TX_SUCCESS_FLAGS | DATA_TX_ERROR_FLAGS)) {
-            if (result & DATA_TX_ERROR_FLAGS) {
-                return false;
-            } else if (result & DATA_TX_SUCCESS_FLAGS) {
-                break;
-            }
+        if (result & DATA_ERROR_FLAGS) {
+            success = false;
+            break;
+        }
+        if ((result & DATA_SUCCESS_FLAGS) && dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
+            break;
         }
 
         // allow other tasks to run
         os::this_task::yield();
     }
 
-    return true;
-}
+    if (!success) {
+        SDIO_DCTRL = 0;
+        dma_disable_stream(DMA2, DMA_STREAM3);
+    }
+
+    // STOP_TRANSMISSION (CMD12), the card might still be busy programming after a write,
+    // this is covered by waiting for the card to be ready before the next transfer
+    if (_transfer.multiBlock || !success) {
+        if (sendCommandWait(12, 0) != Success) {
+            success = false;
+        }
+    }
+
+    _transfer.active = false;
+
+    return success;
+}
\ No newline at end of file
@@ -16,8 +16,20 @@ public:
     size_t sectorCount() const { return _cardInfo.size; }
     size_t sectorSize() const { return 512; }
 
-    bool read(uint8_t *buf, uint32_t sector, uint8_t count);
-    bool write(const uint8_t *buf, uint32_t sector, uint8_t count);
+    // contiguous sectors are transferred with a single multi block command
+    bool read(uint8_t *buf, uint32_t sector, uint32_t count);
+    bool write(const uint8_t *buf, uint32_t sector, uint32_t count);
+
+    // Asynchronous transfers, the buffer has to stay untouched until finishTransfer() returns.
+    // Only one transfer can be active, count is limited to MaxTransferBlocks.
+    bool startRead(uint8_t *buf, uint32_t sector, uint32_t count);
+    bool startWrite(const uint8_t *buf, uint32_t sector, uint32_t count);
+    bool transferBusy() const;
+    // waits for the active transfer to complete (DATAEND), returns false on errors
+    bool finishTransfer();
+
+    // limited by the 25 bit data length register of the sdio
+    static constexpr uint32_t MaxTransferBlocks = 0xffff;
 
     void sync() {
     }
@@ -55,9 +67,16 @@ private:
     bool initCard();
     bool waitDataReady();
 
-    bool readBlock(uint32_t address, void *buffer);
-    bool writeBlock(uint32_t address, const void *buffer);
+    void setupDma(const void *buffer, bool write);
+    bool startTransfer(const void *buffer, uint32_t block, uint32_t count, bool write);
+
+    struct Transfer {
+        bool active = false;
+        bool write = false;
+        bool multiBlock = false;
+    };
 
     bool _initialized = false;
     CardInfo _cardInfo;
+    Transfer _transfer;
 };
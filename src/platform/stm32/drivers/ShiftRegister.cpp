@@ -5,9 +5,14 @@
 #include "core/profiler/Profiler.h"
 #include "core/Debug.h"
 
+#include "os/os.h"
+
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/spi.h>
+#include <libopencm3/stm32/dma.h>
+#include <libopencm3/stm32/timer.h>
+#include <libopencm3/cm3/nvic.h>
 
 #include <cstring>
 
@@ -27,9 +32,23 @@
 #define SPI_MOSI GPIO7
 #define SPI_GPIO (SPI_SCK | SPI_MISO | SPI_MOSI)
 
+#define SR_DMA DMA2
+#define SR_DMA_RX_STREAM DMA_STREAM2
+#define SR_DMA_TX_STREAM DMA_STREAM5
+#define SR_DMA_CHANNEL DMA_SxCR_CHSEL_3
+
+#define SR_SCAN_TIMER TIM7
+
+static ShiftRegister *g_shiftRegister = nullptr;
+
+// dma buffers, must not be placed in CCMRAM
+static uint8_t g_txData[CONFIG_NUM_SR];
+static uint8_t g_rxData[CONFIG_NUM_SR];
+
 ShiftRegister::ShiftRegister() {
     _outputs.fill(0u);
     _inputs.fill(0u);
+    _latched.fill(0u);
 }
 
 void ShiftRegister::init() {
@@ -72,6 +91,9 @@ void ShiftRegister::init() {
 }
 
 void ShiftRegister::process() {
+    // outputs can also be latched from interrupt context (see writeImmediate)
+    os::InterruptLock lock;
+
     // trigger load line
     gpio_clear(SR_PORT, SR_LOAD);
     gpio_set(SR_PORT, SR_LOAD);
@@ -80,8 +102,144 @@ void ShiftRegister::process() {
     for (int sr = 0; sr < NumRegisters; ++sr) {
         _inputs[sr] = spi_xfer(SR_SPI, _outputs[NumRegisters - sr - 1]);
     }
+    _latched = _outputs;
 
     // trigger latch line
     gpio_set(SR_PORT, SR_LATCH);
     gpio_clear(SR_PORT, SR_LATCH);
 }
+
+void ShiftRegister::startScan(uint32_t rate, ScanHandler handler) {
+    g_shiftRegister = this;
+    _scanHandler = handler;
+
+    // setup rx/tx dma, streams are enabled for every transfer
+    rcc_periph_clock_enable(RCC_DMA2);
+    for (auto stream : { SR_DMA_RX_STREAM, SR_DMA_TX_STREAM }) {
+        bool rx = stream == SR_DMA_RX_STREAM;
+        dma_stream_reset(SR_DMA, stream);
+        dma_channel_select(SR_DMA, stream, SR_DMA_CHANNEL);
+        dma_set_priority(SR_DMA, stream, DMA_SxCR_PL_HIGH);
+        dma_set_peripheral_address(SR_DMA, stream, reinterpret_cast<uint32_t>(&SPI_DR(SR_SPI)));
+        dma_set_memory_address(SR_DMA, stream, reinterpret_cast<uint32_t>(rx ? g_rxData : g_txData));
+        dma_set_transfer_mode(SR_DMA, stream, rx ? DMA_SxCR_DIR_PERIPHERAL_TO_MEM : DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+        dma_set_memory_size(SR_DMA, stream, DMA_SxCR_MSIZE_8BIT);
+        dma_set_peripheral_size(SR_DMA, stream, DMA_SxCR_PSIZE_8BIT);
+        dma_enable_memory_increment_mode(SR_DMA, stream);
+        dma_disable_peripheral_increment_mode(SR_DMA, stream);
+    }
+    // the rx stream completes last, when all bytes are shifted
+    dma_enable_transfer_complete_interrupt(SR_DMA, SR_DMA_RX_STREAM);
+    nvic_set_priority(NVIC_DMA2_STREAM2_IRQ, CONFIG_SR_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_DMA2_STREAM2_IRQ);
+
+    spi_enable_rx_dma(SR_SPI);
+    spi_enable_tx_dma(SR_SPI);
+
+    // setup scan timer, TIM7 is running on APB1 with 84MHz
+    rcc_periph_clock_enable(RCC_TIM7);
+    rcc_periph_reset_pulse(RST_TIM7);
+    timer_set_prescaler(SR_SCAN_TIMER, 84 - 1); // 1MHz
+    timer_set_period(SR_SCAN_TIMER, 1000000 / rate - 1);
+    timer_enable_irq(SR_SCAN_TIMER, TIM_DIER_UIE);
+    nvic_set_priority(NVIC_TIM7_IRQ, CONFIG_SR_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_TIM7_IRQ);
+    timer_enable_counter(SR_SCAN_TIMER);
+}
+
+void ShiftRegister::handleTimerIrq() {
+    timer_clear_flag(SR_SCAN_TIMER, TIM_SR_UIF);
+
+    os::InterruptLock lock;
+
+    if (_transferActive) {
+        // previous transfer was held up, skip a scan step
+        return;
+    }
+
+    _latched = _outputs;
+    for (int sr = 0; sr < NumRegisters; ++sr) {
+        g_txData[sr] = _latched[NumRegisters - sr - 1];
+    }
+
+    // trigger load line
+    gpio_clear(SR_PORT, SR_LOAD);
+    gpio_set(SR_PORT, SR_LOAD);
+
+    // start transfer
+    _transferActive = true;
+    dma_clear_interrupt_flags(SR_DMA, SR_DMA_RX_STREAM, DMA_TCIF | DMA_HTIF);
+    dma_clear_interrupt_flags(SR_DMA, SR_DMA_TX_STREAM, DMA_TCIF | DMA_HTIF);
+    dma_set_number_of_data(SR_DMA, SR_DMA_RX_STREAM, NumRegisters);
+    dma_set_number_of_data(SR_DMA, SR_DMA_TX_STREAM, NumRegisters);
+    dma_enable_stream(SR_DMA, SR_DMA_RX_STREAM);
+    dma_enable_stream(SR_DMA, SR_DMA_TX_STREAM);
+}
+
+void ShiftRegister::handleDmaIrq() {
+    {
+        os::InterruptLock lock;
+
+        if (!dma_get_interrupt_flag(SR_DMA, SR_DMA_RX_STREAM, DMA_TCIF)) {
+            return;
+        }
+        dma_clear_interrupt_flags(SR_DMA, SR_DMA_RX_STREAM, DMA_TCIF | DMA_HTIF);
+
+        // trigger latch line
+        gpio_set(SR_PORT, SR_LATCH);
+        gpio_clear(SR_PORT, SR_LATCH);
+
+        for (int sr = 0; sr < NumRegisters; ++sr) {
+            _inputs[sr] = g_rxData[sr];
+        }
+        _transferActive = false;
+
+        // outputs written during the transfer were not part of it, latch them now
+        if (_latchPending) {
+            _latchPending = false;
+            latchOutputs();
+        }
+    }
+
+    // prepare the outputs for the next transfer
+    if (_scanHandler) {
+        _scanHandler();
+    }
+}
+
+void ShiftRegister::writeImmediate(int index, uint8_t value) {
+    os::InterruptLock lock;
+
+    _outputs[index] = value;
+    _latched[index] = value;
+
+    // a running scan transfer shifts out the previously latched outputs
+    // defer the update to the transfer complete interrupt instead of waiting for the transfer
+    if (_transferActive) {
+        _latchPending = true;
+        return;
+    }
+
+    latchOutputs();
+}
+
+// shifts out the latched outputs, must be called with interrupts disabled
+// we don't trigger the load line, so the input registers are not affected
+// (button scanning relies on outputs and inputs being transferred in lock step)
+void ShiftRegister::latchOutputs() {
+    for (int sr = 0; sr < NumRegisters; ++sr) {
+        spi_xfer(SR_SPI, _latched[NumRegisters - sr - 1]);
+    }
+
+    // trigger latch line
+    gpio_set(SR_PORT, SR_LATCH);
+    gpio_clear(SR_PORT, SR_LATCH);
+}
+
+void tim7_isr() {
+    g_shiftRegister->handleTimerIrq();
+}
+
+void dma2_stream2_isr() {
+    g_shiftRegister->handleDmaIrq();
+}
@@ -3,6 +3,7 @@
 #include "SystemConfig.h"
 
 #include <array>
+#include <functional>
 
 #include <cstdint>
 
@@ -10,16 +11,39 @@ class ShiftRegister {
 public:
     static constexpr int NumRegisters = CONFIG_NUM_SR;
 
+    typedef std::function<void()> ScanHandler;
+
     ShiftRegister();
 
     void init();
 
+    // transfer inputs and outputs (blocking)
     void process();
 
+    // Starts scanning: transfers are triggered by a hardware timer at the given rate and run through SPI DMA.
+    // The handler is called from interrupt context after each transfer, once the inputs are updated and the
+    // outputs are latched. process() must not be used while scanning.
+    void startScan(uint32_t rate, ScanHandler handler);
+
     uint8_t read(int index) const { return _inputs[index]; }
     void write(int index, uint8_t value) { _outputs[index] = value; }
 
+    // update a single output register and latch it right away without sampling the inputs
+    // if a scan transfer is running, the register is latched once it completes
+    // used to commit outputs from interrupt context
+    void writeImmediate(int index, uint8_t value);
+
+    void handleTimerIrq();
+    void handleDmaIrq();
+
 private:
+    void latchOutputs();
+
+    ScanHandler _scanHandler;
+    volatile bool _transferActive = false;
+    volatile bool _latchPending = false;
+
     std::array<uint8_t, NumRegisters> _outputs;
     std::array<uint8_t, NumRegisters> _inputs;
+    std::array<uint8_t, NumRegisters> _latched;
 };
@@ -69,12 +69,20 @@ struct MidiDriverHandler {
         switch (code) {
         case 0x0: // (1, 2 or 3 bytes) Miscellaneous function codes. Reserved for future extensions.
         case 0x1: // (1, 2 or 3 bytes) Cable events. Reserved for future expansion.
-        case 0x4: // (3 bytes) SysEx starts or continues
-        case 0x6: // (2 bytes) SysEx ends with following two bytes.
-        case 0x7: // (3 bytes) SysEx ends with following three bytes.
             // ignore for now
             return;
+        case 0x4: // (3 bytes) SysEx starts or continues
+        case 0x7: // (3 bytes) SysEx ends with following three bytes.
+            g_usbh->midiEnqueueSysEx(device, cable, &data[1], 3);
+            break;
+        case 0x6: // (2 bytes) SysEx ends with following two bytes.
+            g_usbh->midiEnqueueSysEx(device, cable, &data[1], 2);
+            break;
         case 0x5: // (1 bytes) Single-byte System Common Message or SysEx ends with following single byte.
+            if (data[1] == MidiMessage::EndOfExclusive) {
+                g_usbh->midiEnqueueSysEx(device, cable, &data[1], 1);
+                break;
+            }
             message = MidiMessage(data[1]);
             g_usbh->midiEnqueueMessage(device, cable, message);
             break;
@@ -100,7 +108,7 @@ struct MidiDriverHandler {
     }
 
     static bool write(uint8_t device, uint8_t cable, const MidiMessage &message) {
-        bool flushed = true;
+        bool flushed = false;
 
         if (message.isSystemExclusive()) {
             const uint8_t *payloadData = message.payloadData();
@@ -170,6 +178,46 @@ struct MidiDriverHandler {
         return flushed;
     }
 
+    // Streams queued system exclusive messages until the write buffer is full. A message that was
+    // started is continued on the next call before any other message is written.
+    static bool writeSysEx(uint8_t device, SysExBuffer &buffer) {
+        while (!buffer.empty()) {
+            if (writeBufferPos + 4 >= writeBufferSize) {
+                flush(device);
+                return true;
+            }
+
+            if (!sysExActive) {
+                sysExCable = g_usbh->midiDequeueSysExCable();
+            }
+
+            // a packet either continues the message with 3 bytes or ends it with 1 to 3 bytes
+            size_t chunkSize = 3;
+            bool last = false;
+            for (size_t i = 0; i < 3; ++i) {
+                if (buffer[i] == MidiMessage::EndOfExclusive) {
+                    chunkSize = i + 1;
+                    last = true;
+                    break;
+                }
+            }
+
+            uint8_t *p = &writeBuffer[writeBufferIndex][writeBufferPos];
+            p[0] = (last ? 0x4 + chunkSize : 0x4) | (sysExCable << 4);
+            for (size_t i = 0; i < 3; ++i) {
+                p[1 + i] = i < chunkSize ? buffer[i] : 0;
+            }
+            writeBufferPos += 4;
+
+            sysExActive = !last;
+            buffer.consume(chunkSize);
+        }
+        return false;
+    }
+
+    static bool sysExActive;
+    static uint8_t sysExCable;
+
     static void flush(uint8_t device) {
         if (writeBufferPos > 0) {
             usbh_midi_write(device, writeBuffer[writeBufferIndex], writeBufferPos, &writeCallback);
@@ -182,6 +230,9 @@ struct MidiDriverHandler {
     }
 };
 
+bool MidiDriverHandler::sysExActive = false;
+uint8_t MidiDriverHandler::sysExCable = 0;
+
 static const midi_config_t midi_config = {
     .read_callback = &MidiDriverHandler::recvHandler,
     .notify_connected = &MidiDriverHandler::connectHandler,
@@ -226,18 +277,36 @@ void UsbH::process() {
     usbh_poll(time_us);
 
     // Start sending MIDI messages
-    uint8_t device;
+    uint8_t device = 0;
     uint8_t cable;
     MidiMessage message;
     bool flushed = false;
-    while (midiDequeueMessage(&device, &cable, &message)) {
+
+    if (!midiDeviceConnected(device)) {
+        // drop system exclusive messages, there is no one to receive them
+        auto &sysExBuffer = midiSysExTxBuffer();
+        while (size_t length = sysExBuffer.messageLength()) {
+            sysExBuffer.consume(length);
+            // the cable of a partially sent message was dequeued already
+            if (!MidiDriverHandler::sysExActive) {
+                midiDequeueSysExCable();
+            }
+            MidiDriverHandler::sysExActive = false;
+        }
+    }
+
+    // no other message must be sent in the middle of a system exclusive message
+    if (MidiDriverHandler::sysExActive) {
+        flushed = MidiDriverHandler::writeSysEx(device, midiSysExTxBuffer());
+    }
+    while (!flushed && midiDequeueMessage(&device, &cable, &message)) {
         if (midiDeviceConnected(device)) {
             flushed = MidiDriverHandler::write(device, cable, message);
-            if (flushed) {
-                break;
-            }
         }
     }
+    if (!flushed && midiDeviceConnected(device)) {
+        flushed = MidiDriverHandler::writeSysEx(device, midiSysExTxBuffer());
+    }
     if (!flushed) {
         MidiDriverHandler::flush(device);
     }
@@ -35,6 +35,11 @@ private:
         _usbMidi.enqueueMessage(cable, message);
     }
 
+    // system exclusive data is streamed straight from the usb packets into the receive buffer
+    void midiEnqueueSysEx(uint8_t device, uint8_t cable, const uint8_t *data, size_t length) {
+        _usbMidi.enqueueSysEx(cable, data, length);
+    }
+
     void midiEnqueueData(uint8_t device, uint8_t cable, uint8_t data) {
         _usbMidi.enqueueData(cable, data);
     }
@@ -44,6 +49,15 @@ private:
         return _usbMidi.dequeueMessage(cable, message);
     }
 
+    SysExBuffer &midiSysExTxBuffer() {
+        return _usbMidi._sysExTxBuffer;
+    }
+
+    // cable of the next system exclusive message in the transmit buffer
+    uint8_t midiDequeueSysExCable() {
+        return _usbMidi._sysExTxCables.read();
+    }
+
     UsbMidi &_usbMidi;
 
     uint8_t _midiDevices = 0;
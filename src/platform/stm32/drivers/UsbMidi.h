@@ -2,6 +2,9 @@
 
 #include "core/utils/RingBuffer.h"
 #include "core/midi/MidiMessage.h"
+#include "core/midi/SysExBuffer.h"
+
+#include "os/os.h"
 
 #include <functional>
 
@@ -16,13 +19,30 @@ public:
     void init() {}
 
     bool send(uint8_t cable, const MidiMessage &message) {
-        if (_txQueue.full()) {
+        // called from the engine and the ui task (and the clock timer interrupt), the usbh task is the only consumer
+        os::InterruptLock lock;
+        if (!_txQueue.write({ cable, message })) {
+            ++_txOverflow;
             return false;
         }
-        _txQueue.write({ cable, message });
         return true;
     }
 
+    // queue a complete system exclusive message (data without 0xf0/0xf7 framing), never blocks
+    // fails if the message does not fit into the transmit buffer as a whole
+    bool sendSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+        // called from the engine and the ui task
+        os::InterruptLock lock;
+        if (_sysExTxCables.full() || _sysExTxBuffer.writable() < length + 2) {
+            return false;
+        }
+        _sysExTxCables.write(cable);
+        return _sysExTxBuffer.writeMessage(data, length);
+    }
+
+    // received system exclusive messages (cable 0)
+    SysExBuffer &sysExBuffer() { return _sysExRxBuffer; }
+
     bool recv(uint8_t *cable, MidiMessage *message) {
         if (_rxQueue.empty()) {
             return false;
@@ -45,7 +65,8 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    uint32_t rxOverflow() const { return _rxOverflow; }
+    uint32_t txOverflow() const { return _txOverflow; }
 
 private:
     void connect(uint16_t vendorId, uint16_t productId) {
@@ -61,11 +82,16 @@ private:
     }
 
     void enqueueMessage(uint8_t cable, const MidiMessage &message) {
-        if (_rxQueue.full()) {
-            // overflow
+        if (!_rxQueue.write({ cable, message })) {
+            // overflow, drop the message
             ++_rxOverflow;
         }
-        _rxQueue.write({ cable, message });
+    }
+
+    void enqueueSysEx(uint8_t cable, const uint8_t *data, size_t length) {
+        if (cable == 0) {
+            _sysExRxBuffer.feed(data, length);
+        }
     }
 
     void enqueueData(uint8_t cable, uint8_t data) {
@@ -96,6 +122,14 @@ private:
     RingBuffer<CableAndMessage, 128> _txQueue;
     RingBuffer<CableAndMessage, 16> _rxQueue;
     volatile uint32_t _rxOverflow = 0;
+    volatile uint32_t _txOverflow = 0;
+
+    uint8_t _sysExTxData[512];
+    SysExBuffer _sysExTxBuffer { _sysExTxData, sizeof(_sysExTxData) };
+    // cable of each message in the transmit buffer
+    RingBuffer<uint8_t, 16> _sysExTxCables;
+    uint8_t _sysExRxData[1024];
+    SysExBuffer _sysExRxBuffer { _sysExRxData, sizeof(_sysExRxData) };
 
     friend class UsbH;
 };
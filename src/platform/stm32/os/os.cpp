@@ -8,45 +8,54 @@ uint32_t InterruptLock::_nestedCount = 0;
 TaskProfiler::TaskInfo *TaskProfiler::_taskInfos;
 TaskProfiler::TaskInfo TaskProfiler::_idleTaskInfo;
 
-void TaskProfiler::dump() {
-    uint32_t totalRunTime = 0;
+void TaskProfiler::update() {
     uint32_t totalRelativeRunTime = 0;
 
     enumerate([&] (TaskInfo &info) {
         TaskStatus_t taskStatus;
-        vTaskGetInfo(info.handle, &taskStatus, pdFALSE, eRunning);
+        vTaskGetInfo(info.handle, &taskStatus, pdTRUE, eRunning);
 
         uint32_t runTimeCounter = taskStatus.ulRunTimeCounter;
         uint32_t relativeRunTimeCounter = runTimeCounter - info.lastRunTimeCounter;
         info.lastRunTimeCounter = runTimeCounter;
 
+        info.name = taskStatus.pcTaskName;
+        info.priority = taskStatus.uxBasePriority;
+        info.stackFree = taskStatus.usStackHighWaterMark * sizeof(StackType_t);
         info.runTime = runTimeCounter;
         info.relativeRunTime = relativeRunTimeCounter;
 
-        totalRunTime += runTimeCounter;
         totalRelativeRunTime += relativeRunTimeCounter;
     });
 
-    totalRunTime = std::max(1ul, totalRunTime / 100);
     totalRelativeRunTime = std::max(1ul, totalRelativeRunTime / 100);
 
+    enumerate([&] (TaskInfo &info) {
+        info.load = std::min(100ul, info.relativeRunTime / totalRelativeRunTime);
+    });
+}
+
+void TaskProfiler::dump() {
+    uint32_t totalRunTime = 0;
+
+    enumerate([&] (const TaskInfo &info) {
+        totalRunTime += info.runTime;
+    });
+
+    totalRunTime = std::max(1ul, totalRunTime / 100);
+
     DBG("Task Profiler:");
     DBG("---------------------------------------------");
-    DBG("id name            bp cp stck free ttot trel");
+    DBG("name            bp stck free ttot trel");
 
     enumerate([&] (const TaskInfo &info) {
-        TaskStatus_t taskStatus;
-        vTaskGetInfo(info.handle, &taskStatus, pdTRUE, eRunning);
-
-        DBG("%2ld %-15s %2ld %2ld %4zd %4hd %3ld%% %3ld%%",
-            taskStatus.xTaskNumber,
-            taskStatus.pcTaskName,
-            taskStatus.uxBasePriority,
-            taskStatus.uxCurrentPriority,
+        DBG("%-15s %2d %4d %4d %3ld%% %3d%%",
+            info.name,
+            info.priority,
             info.stackSize,
-            taskStatus.usStackHighWaterMark,
+            info.stackFree,
             info.runTime / totalRunTime,
-            info.relativeRunTime / totalRelativeRunTime
+            info.load
         );
     });
 
@@ -25,10 +25,14 @@ namespace os {
         struct TaskInfo {
             struct TaskInfo *next = nullptr;
             TaskHandle handle;
+            const char *name;
+            uint8_t priority;
             uint16_t stackSize;
+            uint16_t stackFree;         // lowest amount of free stack in bytes
             uint32_t lastRunTimeCounter;
             uint32_t runTime;
             uint32_t relativeRunTime;
+            uint8_t load;               // cpu load in % since the previous update
         };
 
         static void registerTask(TaskInfo *taskInfo) {
@@ -39,9 +43,10 @@ namespace os {
             *tail = taskInfo;
         }
 
+        // updates run times, loads and stack high water marks of all tasks
+        static void update();
         static void dump();
 
-    private:
         template<typename Func>
         static void enumerate(Func func) {
             TaskInfo *info = _taskInfos;
@@ -53,6 +58,7 @@ namespace os {
             func(_idleTaskInfo);
         }
 
+    private:
         static TaskInfo *_taskInfos;
         static TaskInfo _idleTaskInfo;
     };
@@ -261,6 +267,16 @@ namespace os {
         vTaskStartScheduler();
     }
 
+    // suspends task switching, interrupts remain enabled
+    // must not be held while calling blocking functions
+    inline void suspendScheduler() {
+        vTaskSuspendAll();
+    }
+
+    inline void resumeScheduler() {
+        xTaskResumeAll();
+    }
+
 
     template<size_t StackSize>
     class PeriodicTask : public Task<StackSize> {
@@ -39,12 +39,12 @@ public:
         canvas.vline(frame % 256, 0, 64);
         canvas.hline(0, frame % 64, 256);
 
-        lcd.draw(frameBuffer.data());
+        lcd.draw(frameBuffer);
     }
 
 private:
-    uint8_t frameBufferData[256*64];
-    FrameBuffer8bit frameBuffer;
+    uint8_t frameBufferData[256*64/2];
+    FrameBuffer4bit frameBuffer;
     Canvas canvas;
     Lcd lcd;
     Timer timer;
@@ -0,0 +1,193 @@
+#include "UnitTest.h"
+
+#include "core/fs/Volume.h"
+#include "core/fs/File.h"
+#include "core/fs/FileWriter.h"
+#include "core/fs/FileReader.h"
+
+#include "drivers/SdCard.h"
+
+#include <vector>
+
+#include <cstdint>
+
+// file size and field size resemble a serialized project
+static const size_t FileSize = 96 * 1024;
+static const size_t FieldSize = 4;
+static const size_t BlockSize = 16 * 1024;
+static const int Iterations = 5;
+
+static float megabytesPerSecond(size_t bytes, uint32_t us) {
+    return us > 0 ? float(bytes) / us : 0.f;
+}
+
+static uint8_t pattern(size_t i) {
+    return uint8_t((i * 7) ^ (i >> 8));
+}
+
+UNIT_TEST("BenchmarkFileSystem") {
+
+    // the simulated sd card is a ram disk, only one volume can exist
+    static SdCard sdcard;
+    static fs::Volume volume(sdcard);
+    expectEqual(int(volume.format()), int(fs::OK));
+    expectEqual(int(volume.mount()), int(fs::OK));
+
+    std::vector<uint8_t> data(FileSize);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = pattern(i);
+    }
+
+    std::vector<uint8_t> readBack(FileSize);
+    // large buffer for multi block transfers
+    static uint32_t buffer[4096 / 4];
+
+    auto writeFields = [&] (fs::FileWriter &writer) {
+        for (size_t i = 0; i < FileSize; i += FieldSize) {
+            writer.write(&data[i], FieldSize);
+        }
+        return writer.finish();
+    };
+
+    auto writeBlocks = [&] (fs::FileWriter &writer) {
+        for (size_t i = 0; i < FileSize; i += BlockSize) {
+            writer.write(&data[i], BlockSize);
+        }
+        return writer.finish();
+    };
+
+    auto readFields = [&] (fs::FileReader &reader) {
+        for (size_t i = 0; i < FileSize; i += FieldSize) {
+            reader.read(&readBack[i], FieldSize);
+        }
+        return reader.finish();
+    };
+
+    auto readBlocks = [&] (fs::FileReader &reader) {
+        for (size_t i = 0; i < FileSize; i += BlockSize) {
+            reader.read(&readBack[i], BlockSize);
+        }
+        return reader.finish();
+    };
+
+    CASE("write") {
+        Timer timer;
+
+        // fields written through the FatFS sector window
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::File file("UNBUF.DAT", fs::File::Write);
+            for (size_t j = 0; j < FileSize; j += FieldSize) {
+                file.writeAll(&data[j], FieldSize);
+            }
+            expectEqual(int(file.close()), int(fs::OK));
+        }
+        uint32_t unbufferedTime = timer.elapsed();
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileWriter writer("FIELDS.DAT");
+            expectEqual(int(writeFields(writer)), int(fs::OK));
+        }
+        uint32_t fieldsTime = timer.elapsed();
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileWriter writer("BUFFER.DAT", fs::File::Write, buffer, sizeof(buffer));
+            expectEqual(int(writeFields(writer)), int(fs::OK));
+        }
+        uint32_t bufferedTime = timer.elapsed();
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileWriter writer("BLOCKS.DAT");
+            expectEqual(int(writeBlocks(writer)), int(fs::OK));
+        }
+        uint32_t blocksTime = timer.elapsed();
+
+        for (auto name : { "UNBUF.DAT", "FIELDS.DAT", "BUFFER.DAT", "BLOCKS.DAT" }) {
+            fs::FileReader reader(name);
+            expectEqual(int(readBlocks(reader)), int(fs::OK));
+            expectTrue(readBack == data, "file content differs");
+        }
+
+        print("write fields (unbuffered): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, unbufferedTime));
+        print("write fields (sector buffer): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, fieldsTime));
+        print("write fields (4 KB buffer): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, bufferedTime));
+        print("write blocks (zero-copy): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, blocksTime));
+    }
+
+    CASE("append") {
+        // appending starts in the middle of a sector, the writer has to realign
+        {
+            fs::FileWriter writer("APPEND.DAT");
+            writer.write(&data[0], 100);
+            expectEqual(int(writer.finish()), int(fs::OK));
+        }
+        {
+            fs::FileWriter writer("APPEND.DAT", fs::File::Append, buffer, sizeof(buffer));
+            writer.write(&data[100], FileSize - 100);
+            expectEqual(int(writer.finish()), int(fs::OK));
+        }
+        fs::FileReader reader("APPEND.DAT");
+        expectEqual(int(readFields(reader)), int(fs::OK));
+        expectTrue(readBack == data, "file content differs");
+    }
+
+    CASE("read") {
+        {
+            fs::FileWriter writer("READ.DAT");
+            expectEqual(int(writeBlocks(writer)), int(fs::OK));
+        }
+
+        Timer timer;
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::File file("READ.DAT", fs::File::Read);
+            for (size_t j = 0; j < FileSize; j += FieldSize) {
+                file.read(&readBack[j], FieldSize);
+            }
+            expectEqual(int(file.close()), int(fs::OK));
+        }
+        uint32_t unbufferedTime = timer.elapsed();
+        expectTrue(readBack == data, "file content differs");
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileReader reader("READ.DAT");
+            expectEqual(int(readFields(reader)), int(fs::OK));
+        }
+        uint32_t fieldsTime = timer.elapsed();
+        expectTrue(readBack == data, "file content differs");
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileReader reader("READ.DAT", buffer, sizeof(buffer));
+            expectEqual(int(readFields(reader)), int(fs::OK));
+        }
+        uint32_t bufferedTime = timer.elapsed();
+        expectTrue(readBack == data, "file content differs");
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            fs::FileReader reader("READ.DAT");
+            expectEqual(int(readBlocks(reader)), int(fs::OK));
+        }
+        uint32_t blocksTime = timer.elapsed();
+        expectTrue(readBack == data, "file content differs");
+
+        // reading past the end of the file
+        {
+            fs::FileReader reader("READ.DAT");
+            std::vector<uint8_t> tooLarge(FileSize + 1);
+            expectEqual(int(reader.read(tooLarge.data(), tooLarge.size())), int(fs::END_OF_FILE));
+        }
+
+        print("read fields (unbuffered): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, unbufferedTime));
+        print("read fields (sector buffer): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, fieldsTime));
+        print("read fields (4 KB buffer): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, bufferedTime));
+        print("read blocks (zero-copy): %.2f MB/s\n", megabytesPerSecond(FileSize * Iterations, blocksTime));
+    }
+
+}
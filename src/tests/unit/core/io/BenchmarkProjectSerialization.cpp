@@ -0,0 +1,155 @@
+#include "model/Project.h"
+#include "model/ProjectVersion.h"
+
+#include "model/Arpeggiator.cpp"
+#include "model/ClockSetup.cpp"
+#include "model/Curve.cpp"
+#include "model/CurveSequence.cpp"
+#include "model/CurveTrack.cpp"
+#include "model/MidiCvTrack.cpp"
+#include "model/MidiOutput.cpp"
+#include "model/ModelUtils.cpp"
+#include "model/NoteSequence.cpp"
+#include "model/NoteTrack.cpp"
+#include "model/PlayState.cpp"
+#include "model/Project.cpp"
+#include "model/Routing.cpp"
+#include "model/Scale.cpp"
+#include "model/Song.cpp"
+#include "model/TimeSignature.cpp"
+#include "model/Track.cpp"
+#include "model/Types.cpp"
+#include "model/UserScale.cpp"
+
+// included after the model sources, which use a CASE macro of their own
+#include "UnitTest.h"
+
+#include "MemoryReaderWriter.h"
+
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/io/VersionedSerializedReader.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+static const int Iterations = 20;
+
+// fill all patterns with random steps so the benchmark is not dominated by default values
+static void randomizeProject(Project &project) {
+    std::mt19937 rng(1234);
+
+    project.setTrackMode(6, Track::TrackMode::Curve);
+    project.setTrackMode(7, Track::TrackMode::Curve);
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        auto &track = project.track(trackIndex);
+        if (track.trackMode() == Track::TrackMode::Note) {
+            for (auto &sequence : track.noteTrack().sequences()) {
+                for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                    auto &step = sequence.step(stepIndex);
+                    step.setGate(rng() % 2);
+                    step.setNote(int(rng() % 48) - 24);
+                    step.setLength(rng() % NoteSequence::Length::Range);
+                    step.setRetrigger(rng() % NoteSequence::Retrigger::Range);
+                }
+            }
+        } else if (track.trackMode() == Track::TrackMode::Curve) {
+            for (auto &sequence : track.curveTrack().sequences()) {
+                for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                    auto &step = sequence.step(stepIndex);
+                    step.setShape(rng() % int(Curve::Last));
+                    step.setMin(rng() % CurveSequence::Min::Range);
+                    step.setMax(rng() % CurveSequence::Max::Range);
+                }
+            }
+        }
+    }
+}
+
+static float megabytesPerSecond(size_t bytes, uint32_t us) {
+    return us > 0 ? float(bytes) / us : 0.f;
+}
+
+UNIT_TEST("BenchmarkProjectSerialization") {
+
+    // projects are too large for the stack
+    std::unique_ptr<Project> source(new Project());
+    std::unique_ptr<Project> target(new Project());
+    randomizeProject(*source);
+
+    size_t size = 0;
+    {
+        VersionedSerializedWriter writer([&size] (const void *data, size_t len) { size += len; }, ProjectVersion::Latest);
+        source->write(writer);
+    }
+    // memory reader/writer need one byte of slack
+    std::vector<uint8_t> buffer(size + 1);
+    std::vector<uint8_t> reference(size + 1);
+
+    CASE("save") {
+        Timer timer;
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            MemoryWriter memoryWriter(reference.data(), reference.size());
+            VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, ProjectVersion::Latest);
+            source->write(writer);
+        }
+        uint32_t functionTime = timer.elapsed();
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            MemoryWriter memoryWriter(buffer.data(), buffer.size());
+            VersionedSerializedWriter writer(memoryWriter, ProjectVersion::Latest);
+            source->write(writer);
+            expectEqual(int(memoryWriter.bytesWritten()), int(size));
+        }
+        uint32_t sinkTime = timer.elapsed();
+
+        expectTrue(buffer == reference, "sink and std::function writers differ");
+
+        print("project size: %d bytes\n", int(size));
+        print("save (std::function): %.2f MB/s\n", megabytesPerSecond(size * Iterations, functionTime));
+        print("save (sink): %.2f MB/s\n", megabytesPerSecond(size * Iterations, sinkTime));
+    }
+
+    CASE("load") {
+        {
+            MemoryWriter memoryWriter(buffer.data(), buffer.size());
+            VersionedSerializedWriter writer(memoryWriter, ProjectVersion::Latest);
+            source->write(writer);
+        }
+
+        Timer timer;
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            MemoryReader memoryReader(buffer.data(), buffer.size());
+            VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, ProjectVersion::Latest);
+            expectTrue(target->read(reader));
+        }
+        uint32_t functionTime = timer.elapsed();
+
+        timer.reset();
+        for (int i = 0; i < Iterations; ++i) {
+            MemoryReader memoryReader(buffer.data(), buffer.size());
+            VersionedSerializedReader reader(memoryReader, ProjectVersion::Latest);
+            expectTrue(target->read(reader));
+            expectEqual(int(memoryReader.bytesRead()), int(size));
+        }
+        uint32_t sourceTime = timer.elapsed();
+
+        // saving the loaded project has to reproduce the original data
+        MemoryWriter memoryWriter(reference.data(), reference.size());
+        VersionedSerializedWriter writer(memoryWriter, ProjectVersion::Latest);
+        target->write(writer);
+        expectTrue(buffer == reference, "project changed after save/load round trip");
+
+        print("load (std::function): %.2f MB/s\n", megabytesPerSecond(size * Iterations, functionTime));
+        print("load (source): %.2f MB/s\n", megabytesPerSecond(size * Iterations, sourceTime));
+    }
+
+}
@@ -0,0 +1,84 @@
+#include "UnitTest.h"
+
+#include "core/utils/RingBuffer.h"
+
+UNIT_TEST("RingBuffer") {
+
+    CASE("empty") {
+        RingBuffer<int, 4> buffer;
+
+        expectEqual(buffer.size(), size_t(4));
+        expect(buffer.empty());
+        expect(!buffer.full());
+        expectEqual(buffer.readable(), size_t(0));
+        expectEqual(buffer.writable(), size_t(4));
+    }
+
+    CASE("write/read all") {
+        RingBuffer<int, 4> buffer;
+
+        for (int i = 0; i < 4; ++i) {
+            expect(buffer.write(i));
+            expectEqual(buffer.readable(), size_t(i + 1));
+            expectEqual(buffer.writable(), size_t(3 - i));
+        }
+        expect(buffer.full());
+
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(buffer.read(), i);
+        }
+        expect(buffer.empty());
+    }
+
+    CASE("write to full buffer fails") {
+        RingBuffer<int, 4> buffer;
+
+        for (int i = 0; i < 4; ++i) {
+            buffer.write(i);
+        }
+        expect(!buffer.write(4));
+        expectEqual(buffer.readable(), size_t(4));
+        expectEqual(buffer.read(), 0);
+        expect(buffer.write(4));
+        for (int i = 1; i < 5; ++i) {
+            expectEqual(buffer.read(), i);
+        }
+    }
+
+    CASE("wrap around") {
+        RingBuffer<int, 4> buffer;
+
+        for (int i = 0; i < 100; ++i) {
+            expect(buffer.write(i));
+            expect(buffer.write(i + 1000));
+            expectEqual(buffer.read(), i);
+            expectEqual(buffer.read(), i + 1000);
+            expect(buffer.empty());
+        }
+    }
+
+    CASE("block write/read") {
+        RingBuffer<int, 8> buffer;
+
+        int data[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        expectEqual(buffer.write(data, 6), size_t(6));
+        expectEqual(buffer.write(data + 6, 4), size_t(2));
+        expect(buffer.full());
+
+        int result[8];
+        buffer.read(result, 8);
+        for (int i = 0; i < 8; ++i) {
+            expectEqual(result[i], i);
+        }
+        expect(buffer.empty());
+    }
+
+    CASE("read and replace") {
+        RingBuffer<int, 4> buffer;
+
+        buffer.write(1);
+        expectEqual(buffer.readAndReplace(), 1);
+        expect(buffer.empty());
+    }
+
+}
@@ -0,0 +1,280 @@
+#include "Config.h"
+
+#include "engine/Engine.h"
+#include "model/Model.h"
+
+#include "sim/Simulator.h"
+
+// included after the sequencer headers, which use a CASE macro of their own
+#include "UnitTest.h"
+
+#include <memory>
+#include <new>
+#include <random>
+
+#include <cstdint>
+#include <cstdlib>
+
+// Time budgets in ns per clock tick (per call for the routing and midi output engines).
+// Timings depend on the host load, so budgets are only reported and never fail the test.
+// Set BENCHMARK_BUDGET_SCALE to scale them on slow hosts.
+static const uint32_t EngineUpdateBudget = 250000;
+static const uint32_t NoteTracksBudget = 10000;
+static const uint32_t CurveTracksBudget = 8000;
+static const uint32_t ModulatorsBudget = 2500;
+static const uint32_t RoutingBudget = 40000;
+static const uint32_t MidiOutputBudget = 2000;
+
+static const int Duration = 20000; // ms
+static const int Ticks = 10000;
+
+static const int NoteTrackCount = 12;
+
+// the engine must not allocate while running, all heap allocations are counted
+static uint32_t g_allocations;
+
+void *operator new(size_t size) {
+    ++g_allocations;
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+// all tracks, patterns, modulators, routes and midi outputs in use
+static void loadProject(Project &project) {
+    std::mt19937 rng(1234);
+
+    for (int trackIndex = NoteTrackCount; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Curve);
+    }
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        auto &track = project.track(trackIndex);
+        if (track.trackMode() == Track::TrackMode::Note) {
+            for (auto &sequence : track.noteTrack().sequences()) {
+                sequence.setLastStep(CONFIG_STEP_COUNT - 1);
+                for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                    auto &step = sequence.step(stepIndex);
+                    step.setGate(rng() % 4 != 0);
+                    step.setGateProbability(rng() % NoteSequence::GateProbability::Range);
+                    step.setSlide(rng() % 8 == 0);
+                    step.setRetrigger(rng() % NoteSequence::Retrigger::Range);
+                    step.setRetriggerProbability(rng() % NoteSequence::RetriggerProbability::Range);
+                    step.setLength(rng() % NoteSequence::Length::Range);
+                    step.setLengthVariationRange(int(rng() % 8) - 4);
+                    step.setLengthVariationProbability(rng() % NoteSequence::LengthVariationProbability::Range);
+                    step.setNote(int(rng() % 48) - 24);
+                    step.setNoteVariationRange(int(rng() % 24) - 12);
+                    step.setNoteVariationProbability(rng() % NoteSequence::NoteVariationProbability::Range);
+                }
+            }
+        } else if (track.trackMode() == Track::TrackMode::Curve) {
+            for (auto &sequence : track.curveTrack().sequences()) {
+                sequence.setLastStep(CONFIG_STEP_COUNT - 1);
+                for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                    auto &step = sequence.step(stepIndex);
+                    step.setShape(rng() % int(Curve::Last));
+                    step.setMin(rng() % CurveSequence::Min::Range);
+                    step.setMax(rng() % CurveSequence::Max::Range);
+                    step.setGate(rng() % CurveSequence::Gate::Range);
+                }
+            }
+        }
+    }
+
+    for (int modulatorIndex = 0; modulatorIndex < CONFIG_MODULATOR_COUNT; ++modulatorIndex) {
+        auto &modulator = project.modulator(modulatorIndex);
+        modulator.setShape(Modulator::Shape(modulatorIndex % int(Modulator::Shape::Last)));
+        modulator.setGateTrack(modulatorIndex);
+    }
+
+    const Routing::Target targets[] = {
+        Routing::Target::Transpose,
+        Routing::Target::Octave,
+        Routing::Target::GateProbabilityBias,
+        Routing::Target::LengthBias,
+    };
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        auto &route = project.routing().route(routeIndex);
+        route.setTarget(targets[routeIndex % 4]);
+        route.setTracks(0xff);
+        route.setSource(Routing::Source(int(Routing::Source::CvIn1) + routeIndex % 4));
+    }
+
+    for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
+        auto &output = project.midiOutput().output(outputIndex);
+        output.setEvent(MidiOutput::Output::Event::Note);
+        output.setGateSource(MidiOutput::Output::GateSource(outputIndex));
+        output.setNoteSource(MidiOutput::Output::NoteSource(outputIndex));
+    }
+}
+
+// engine running against the simulator drivers
+struct Fixture {
+    ClockTimer clockTimer;
+    Adc adc;
+    Dac dac;
+    Dio dio;
+    GateOutput gateOutput;
+    Midi midi;
+    UsbMidi usbMidi;
+
+    uint8_t midiMessagePayloadPool[32];
+
+    Model model;
+    Engine engine;
+
+    Fixture() :
+        engine(model, clockTimer, adc, dac, dio, gateOutput, midi, usbMidi)
+    {
+        MidiMessage::setPayloadPool(midiMessagePayloadPool, sizeof(midiMessagePayloadPool));
+
+        model.init();
+        loadProject(model.project());
+        engine.init();
+    }
+};
+
+struct Result {
+    uint32_t ns;
+    uint32_t allocations;
+};
+
+// runs func count times, returns the time per run and the allocations of all runs
+template<typename Func>
+static Result measure(int count, Func func) {
+    uint32_t allocations = g_allocations;
+    Timer timer;
+    timer.reset();
+    for (int i = 0; i < count; ++i) {
+        func(i);
+    }
+    uint32_t us = timer.elapsed();
+    return { uint32_t(uint64_t(us) * 1000 / count), g_allocations - allocations };
+}
+
+static uint32_t budget(uint32_t ns) {
+    const char *scale = std::getenv("BENCHMARK_BUDGET_SCALE");
+    return scale ? uint32_t(ns * std::atof(scale)) : ns;
+}
+
+static void report(const char *name, const char *unit, const Result &result, uint32_t ns) {
+    print("%s: %d ns/%s, %d allocations (budget %d ns/%s)%s\n",
+        name, result.ns, unit, result.allocations, budget(ns), unit,
+        result.ns > budget(ns) ? " OVER BUDGET" : ""
+    );
+}
+
+UNIT_TEST("BenchmarkEngine") {
+
+    // only one simulator can exist, the engine is updated on every simulator step
+    static std::unique_ptr<Fixture> fixture;
+    static sim::Simulator simulator({
+        .create = [] () {},
+        .destroy = [] () {},
+        .update = [] () {
+            if (fixture) {
+                fixture->engine.update();
+            }
+        }
+    });
+
+    if (!fixture) {
+        fixture.reset(new Fixture());
+        fixture->engine.clockStart();
+    }
+
+    auto &engine = fixture->engine;
+    auto &project = fixture->model.project();
+
+    CASE("engine update") {
+        // warm up for the same duration, the simulator records gate edges without reallocating afterwards
+        simulator.wait(Duration);
+        simulator.outputJitterMonitor().reset();
+
+        uint32_t startTick = engine.tick();
+        uint32_t allocations = g_allocations;
+        Timer timer;
+        timer.reset();
+        simulator.wait(Duration);
+        uint32_t us = timer.elapsed();
+        uint32_t ticks = engine.tick() - startTick;
+        expectTrue(ticks > 0, "clock is not running");
+
+        Result result = { uint32_t(uint64_t(us) * 1000 / ticks), g_allocations - allocations };
+        report("engine update", "tick", result, EngineUpdateBudget);
+        expectEqual(int(result.allocations), 0, "engine update allocates");
+    }
+
+    CASE("track engines tick") {
+        uint32_t tick = engine.tick();
+
+        Result noteResult = measure(Ticks, [&] (int i) {
+            for (int trackIndex = 0; trackIndex < NoteTrackCount; ++trackIndex) {
+                engine.trackEngine(trackIndex).tick(tick + i);
+            }
+        });
+        Result curveResult = measure(Ticks, [&] (int i) {
+            for (int trackIndex = NoteTrackCount; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+                engine.trackEngine(trackIndex).tick(tick + i);
+            }
+        });
+
+        report("note tracks tick", "tick", noteResult, NoteTracksBudget);
+        report("curve tracks tick", "tick", curveResult, CurveTracksBudget);
+        expectEqual(int(noteResult.allocations), 0, "note tracks allocate");
+        expectEqual(int(curveResult.allocations), 0, "curve tracks allocate");
+    }
+
+    CASE("modulators tick") {
+        auto &modulatorEngine = engine.modulatorEngine();
+        uint32_t tick = engine.tick();
+
+        Result result = measure(Ticks, [&] (int i) {
+            for (int modulatorIndex = 0; modulatorIndex < CONFIG_MODULATOR_COUNT; ++modulatorIndex) {
+                const auto &modulator = project.modulator(modulatorIndex);
+                bool gate = engine.trackEngine(modulator.gateTrack()).gateOutput(0);
+                modulatorEngine.tick(tick + i, modulator, modulatorIndex, gate);
+            }
+        });
+
+        report("modulators tick", "tick", result, ModulatorsBudget);
+        expectEqual(int(result.allocations), 0, "modulators allocate");
+    }
+
+    CASE("routing update") {
+        auto &routingEngine = engine.routingEngine();
+
+        Result result = measure(Ticks, [&] (int i) {
+            routingEngine.update();
+        });
+
+        report("routing update", "call", result, RoutingBudget);
+        expectEqual(int(result.allocations), 0, "routing allocates");
+    }
+
+    CASE("midi output update") {
+        auto &midiOutputEngine = engine.midiOutputEngine();
+
+        Result result = measure(Ticks, [&] (int i) {
+            midiOutputEngine.update();
+        });
+
+        report("midi output update", "call", result, MidiOutputBudget);
+        expectEqual(int(result.allocations), 0, "midi output allocates");
+    }
+
+}
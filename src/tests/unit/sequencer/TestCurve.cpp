@@ -9,6 +9,7 @@
 #include "libs/stb/stb_image_write.h"
 #endif
 
+#include <cmath>
 #include <cstdint>
 
 const int Width = 32;
@@ -18,13 +19,23 @@ float brightness = 1.0;
 
 UNIT_TEST("Curve") {
 
+    CASE("fixed point matches float") {
+        for (int index = 0; index < Curve::Last; ++index) {
+            for (uint32_t x = 0; x <= Curve::FixedOne; x += 7) {
+                float y = Curve::eval(Curve::Type(index), float(x) / Curve::FixedOne);
+                float yFixed = float(Curve::evalFixed(Curve::Type(index), x)) / Curve::FixedMax;
+                expect(std::abs(y - yFixed) < 0.002f);
+            }
+        }
+    }
+
 #ifdef PLATFORM_SIM
 
     CASE("markdown") {
 
         auto drawCurve = [] (int index, const char *filename) {
-            uint8_t data[Width * Height];
-            FrameBuffer8bit framebuffer(Width, Height, data);
+            uint8_t data[Width * Height / 2];
+            FrameBuffer4bit framebuffer(Width, Height, data);
             Canvas canvas(framebuffer, brightness);
 
             canvas.setBlendMode(BlendMode::Set);
@@ -55,11 +66,14 @@ UNIT_TEST("Curve") {
                 );
             }
 
-            for (int i = 0; i < Width * Height; ++i) {
-                data[i] = std::min(255, int(data[i]) * 0xf);
+            uint8_t image[Width * Height];
+            for (int y = 0; y < Height; ++y) {
+                for (int x = 0; x < Width; ++x) {
+                    image[y * Width + x] = framebuffer.get(x, y) * 0x11;
+                }
             }
 
-            stbi_write_png(filename, Width, Height, 1, data, Width * 1);
+            stbi_write_png(filename, Width, Height, 1, image, Width * 1);
         };
 
         FixedStringBuilder<4096> indices("| Index |");
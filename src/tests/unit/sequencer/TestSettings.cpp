@@ -0,0 +1,173 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/model/Settings.h"
+#include "apps/sequencer/model/FlashWriter.h"
+
+#include "drivers/Flash.h"
+
+#include <vector>
+
+#include <cstring>
+
+static constexpr uint32_t SectorAddress = CONFIG_SETTINGS_FLASH_ADDR;
+static constexpr uint32_t SectorSize = CONFIG_SETTINGS_FLASH_SECTOR_SIZE;
+static constexpr uint32_t SectorMagic = 0x474e5453;
+
+struct RecordHeader {
+    uint32_t state;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t size;
+};
+
+static void eraseSector() {
+    Flash::unlock();
+    Flash::eraseSector(CONFIG_SETTINGS_FLASH_SECTOR);
+    Flash::lock();
+}
+
+static uint32_t readWord(uint32_t offset) {
+    uint32_t word;
+    Flash::read(SectorAddress + offset, &word, sizeof(word));
+    return word;
+}
+
+// offset of the first free byte in the log, the number of records is returned in count
+static uint32_t logEnd(int &count) {
+    count = 0;
+    uint32_t offset = sizeof(uint32_t);
+    while (offset + sizeof(RecordHeader) <= SectorSize) {
+        RecordHeader header;
+        Flash::read(SectorAddress + offset, &header, sizeof(header));
+        if (header.type == 0xff && header.reserved == 0xff && header.size == 0xffff) {
+            break;
+        }
+        offset += sizeof(RecordHeader) + ((header.size + 3) & ~3);
+        ++count;
+    }
+    return offset;
+}
+
+typedef UserSettingTraits<UserSetting::Screensaver> ScreensaverTraits;
+
+// user settings only keep values listed in the menu
+static void setScreensaver(Settings &settings, int item) {
+    settings.userSettings().get<UserSetting::Screensaver>() = ScreensaverTraits::ItemValues[item % ScreensaverTraits::ItemCount];
+}
+
+static void setValues(Settings &settings, int calibration, int screensaverItem) {
+    auto &cvOutput = settings.calibration().cvOutput(0);
+    cvOutput.setUserDefined(0, true);
+    cvOutput.setItem(0, calibration);
+    setScreensaver(settings, screensaverItem);
+}
+
+static bool hasValues(const Settings &settings, int calibration, int screensaverItem) {
+    return settings.calibration().cvOutput(0).item(0) == calibration &&
+        settings.userSettings().get<UserSetting::Screensaver>() == ScreensaverTraits::ItemValues[screensaverItem % ScreensaverTraits::ItemCount];
+}
+
+UNIT_TEST("Settings") {
+
+    CASE("writes append only the changed records") {
+        eraseSector();
+        Settings settings;
+        setValues(settings, 1000, 1);
+        settings.writeToFlash();
+
+        int count;
+        uint32_t end = logEnd(count);
+        expectEqual(readWord(0), SectorMagic);
+        expectEqual(count, 2);
+
+        std::vector<uint8_t> before(end);
+        Flash::read(SectorAddress, before.data(), end);
+
+        // unchanged settings are not written again
+        settings.writeToFlash();
+        expectEqual(logEnd(count), end);
+
+        setScreensaver(settings, 2);
+        settings.writeToFlash();
+        logEnd(count);
+        expectEqual(count, 3);
+
+        std::vector<uint8_t> after(end);
+        Flash::read(SectorAddress, after.data(), end);
+        expectTrue(before == after);
+
+        Settings loaded;
+        expectTrue(loaded.readFromFlash());
+        expectTrue(hasValues(loaded, 1000, 2));
+    }
+
+    CASE("uncommitted records are ignored") {
+        eraseSector();
+        Settings settings;
+        setValues(settings, 1100, 3);
+        settings.writeToFlash();
+
+        // user settings record (type 1, 16 bytes) interrupted before its state word was programmed
+        int count;
+        uint32_t end = logEnd(count);
+        Flash::unlock();
+        Flash::program(SectorAddress + end + 4, 0x0010ff01);
+        Flash::program(SectorAddress + end + 8, 0x12345678);
+        Flash::lock();
+
+        Settings loaded;
+        expectTrue(loaded.readFromFlash());
+        expectTrue(hasValues(loaded, 1100, 3));
+
+        // the next write appends behind the torn record
+        setScreensaver(settings, 4);
+        settings.writeToFlash();
+        expectTrue(logEnd(count) > end + 24);
+        expectTrue(loaded.readFromFlash());
+        expectTrue(hasValues(loaded, 1100, 4));
+    }
+
+    CASE("full sector is erased and rewritten") {
+        eraseSector();
+        Settings settings;
+        bool erased = false;
+        uint32_t lastEnd = 0;
+        for (int i = 0; i < 1000; ++i) {
+            setValues(settings, 1000 + i % 500, i);
+            settings.writeToFlash();
+            int count;
+            uint32_t end = logEnd(count);
+            erased |= end < lastEnd;
+            lastEnd = end;
+        }
+        expectTrue(erased);
+        expectEqual(readWord(0), SectorMagic);
+
+        Settings loaded;
+        expectTrue(loaded.readFromFlash());
+        expectTrue(hasValues(loaded, 1000 + 999 % 500, 999));
+    }
+
+    CASE("single image of earlier firmware is read and converted") {
+        Settings settings;
+        setValues(settings, 1200, 5);
+        {
+            FlashWriter flashWriter(SectorAddress, CONFIG_SETTINGS_FLASH_SECTOR);
+            VersionedSerializedWriter writer(flashWriter, Settings::Version);
+            settings.write(writer);
+        }
+        expectTrue(readWord(0) != SectorMagic);
+
+        Settings loaded;
+        expectTrue(loaded.readFromFlash());
+        expectTrue(hasValues(loaded, 1200, 5));
+
+        loaded.writeToFlash();
+        expectEqual(readWord(0), SectorMagic);
+
+        Settings converted;
+        expectTrue(converted.readFromFlash());
+        expectTrue(hasValues(converted, 1200, 5));
+    }
+
+}
@@ -0,0 +1,70 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/Slide.h"
+
+#include <cmath>
+
+static float run(Types::SlideMode mode, float from, float to, int slideTime, float duration, float dt) {
+    Slide slide;
+    float value = from;
+    for (float time = 0.f; time < duration - 0.5f * dt; time += dt) {
+        value = slide.apply(value, to, slideTime, mode, dt);
+    }
+    return value;
+}
+
+UNIT_TEST("Slide") {
+
+    CASE("exponential matches time constant") {
+        // slide time 50 -> tau = 0.5s
+        float value = run(Types::SlideMode::Exponential, 0.f, 1.f, 50, 0.5f, 0.001f);
+        expect(std::abs(value - (1.f - std::exp(-1.f))) < 0.001f);
+    }
+
+    CASE("glide does not depend on update timing") {
+        for (auto mode : { Types::SlideMode::Exponential, Types::SlideMode::Linear, Types::SlideMode::ConstantTime }) {
+            float a = run(mode, 0.f, 2.f, 40, 0.2f, 0.001f);
+            float b = run(mode, 0.f, 2.f, 40, 0.2f, 0.002f);
+            float c = run(mode, 0.f, 2.f, 40, 0.2f, 0.004f);
+            expect(std::abs(a - b) < 0.0001f);
+            expect(std::abs(a - c) < 0.0001f);
+        }
+    }
+
+    CASE("linear rate does not depend on interval") {
+        // slide time 50 -> settles in 2s
+        expect(std::abs(run(Types::SlideMode::Linear, 0.f, 1.f, 50, 1.f, 0.001f) - 0.5f) < 0.001f);
+        expect(std::abs(run(Types::SlideMode::Linear, 0.f, 4.f, 50, 1.f, 0.001f) - 0.5f) < 0.001f);
+        expect(run(Types::SlideMode::Linear, 0.f, 1.f, 50, 2.1f, 0.001f) == 1.f);
+    }
+
+    CASE("constant time does not depend on interval") {
+        expect(std::abs(run(Types::SlideMode::ConstantTime, 0.f, 1.f, 50, 1.f, 0.001f) - 0.5f) < 0.001f);
+        expect(std::abs(run(Types::SlideMode::ConstantTime, 0.f, 4.f, 50, 1.f, 0.001f) - 2.f) < 0.004f);
+        expect(run(Types::SlideMode::ConstantTime, 0.f, 4.f, 50, 2.1f, 0.001f) == 4.f);
+    }
+
+    CASE("constant time latches the step until retriggered") {
+        auto slideTo = [] (Slide &slide, float value, float target, float duration) {
+            for (int i = 0; i < int(duration * 1000.f + 0.5f); ++i) {
+                value = slide.apply(value, target, 50, Types::SlideMode::ConstantTime, 0.001f);
+            }
+            return value;
+        };
+
+        // slide time 50 -> settles in 2s
+        Slide slide;
+        float value = slideTo(slide, 0.f, 1.f, 0.5f);
+        expect(std::abs(value - 0.25f) < 0.001f);
+
+        // moving the target keeps the rate
+        value = slideTo(slide, value, 2.f, 0.5f);
+        expect(std::abs(value - 0.5f) < 0.001f);
+
+        // a new note covers the remaining distance in the slide time
+        slide.retrigger();
+        value = slideTo(slide, value, 3.f, 1.f);
+        expect(std::abs(value - 1.75f) < 0.002f);
+    }
+
+}